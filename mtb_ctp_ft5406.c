@@ -1,6 +1,6 @@
 /*******************************************************************************
 * \file mtb_ctp_ft5406.c
-* \version 1.0.0
+* \version 1.1.0
 *
 * \brief
 * Provides implementation of the FT5406 touch panel driver library.
@@ -27,20 +27,38 @@
 /*******************************************************************************
 * Header Files
 *******************************************************************************/
+#include <string.h>
 #include "mtb_ctp_ft5406.h"
+#include "mtb_ctp_ft5406_internal.h"
+#include "mtb_ctp_ft5406_frame_ring.h"
+#include "mtb_ctp_ft5406_capture.h"
+#include "mtb_ctp_ft5406_trace.h"
 
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
+/* Default retry policy: attempts of each transfer and completion timeout */
 #define RETRY_COUNT                        (5U)
 
-#define I2C_TIMEOUT_COUNT                  (5U)
+#define I2C_TIMEOUT_US                     (10000U)
 
-#define I2C_DELAY_MS                       (1U)
+/* Transfer completion polling interval */
+#define I2C_POLL_DELAY_US                  (10U)
+
+/* Longest completion timeout, a whole number of poll intervals */
+#define I2C_TIMEOUT_MAX_US                 ((UINT32_MAX / I2C_POLL_DELAY_US) * I2C_POLL_DELAY_US)
 
 #define RESET_VAL                          (0U)
 
+/* Number of fractional bits of the coordinate transform coefficients */
+#define TRANSFORM_SHIFT                    (16U)
+
+/* Jitter filter: Q8 positions, weights in 1/256 */
+#define FILTER_SHIFT                       (8U)
+#define FILTER_ROUND                       ((int32_t)1 << (FILTER_SHIFT - 1U))
+#define FILTER_ALPHA_ONE                   ((int32_t)1 << FILTER_SHIFT)
+
 /* Combine I2C controller error statuses in single mask  */
 #define I2C_CONTROLLER_ERROR_MASK          (CY_SCB_I2C_MASTER_DATA_NAK | \
                                             CY_SCB_I2C_MASTER_ADDR_NAK | \
@@ -50,385 +68,4263 @@
 
 
 #define TOUCH_POINT_GET_EVENT(T) ((mtb_ctp_touch_event_t)(uint8_t)((T).XH >> 6U))
-#define TOUCH_POINT_GET_ID(T)    ((T).YH >> 4)
-#define TOUCH_POINT_GET_X(T)     (int)((((uint16_t)(T).XH & 0x0fU) << 8) | \
-                                      (uint16_t)(T).XL)
-#define TOUCH_POINT_GET_Y(T)     (int)((((uint16_t)(T).YH & 0x0fU) << 8) | \
-                                      (uint16_t)(T).YL)
+
+/* Touch buffer holding the latest complete frame, and the one receiving the next read */
+#define TOUCH_BUFF_FRONT(CONFIG)   ((CONFIG)->touch_buff[(CONFIG)->touch_front])
+#define TOUCH_BUFF_BACK(CONFIG)    ((CONFIG)->touch_buff[(CONFIG)->touch_back])
+#define TOUCH_BUFF_NONE            (MTB_CTP_FT5406_TOUCH_BUFF_COUNT)
+
+/* Register shadow: registers changed by the host only, and constant
+ * identification registers. Both are served from the shadow once known. */
+#define REG_BIT(ADDR)                      ((uint64_t)1U << ((ADDR) - MTB_CTP_FT5406_REG_SHADOW_FIRST))
+#define REG_HOST_MASK                      ((REG_BIT(MTB_CTP_FT5406_G_PERIOD_MONITOR + 1U) - \
+                                             REG_BIT(MTB_CTP_FT5406_G_THGROUP)) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_AUTO_CLB_MODE) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_MODE))
+#define REG_CONST_MASK                     (REG_BIT(MTB_CTP_FT5406_G_LIB_VERSION_H) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_LIB_VERSION_L) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_CIPHER) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_FIRMID) | \
+                                            REG_BIT(MTB_CTP_FT5406_G_VENDOR_ID))
+#define REG_SHADOW(CONFIG, ADDR)           ((CONFIG)->reg_shadow[(ADDR) - MTB_CTP_FT5406_REG_SHADOW_FIRST])
+#define REG_IN_SHADOW(ADDR)                (((ADDR) >= MTB_CTP_FT5406_REG_SHADOW_FIRST) && \
+                                            ((ADDR) < (MTB_CTP_FT5406_REG_SHADOW_FIRST + \
+                                                       MTB_CTP_FT5406_REG_SHADOW_COUNT)))
+
+/* Last bytes of a DMA read received by the PDL, which NAKs the last byte and
+ * generates the Stop */
+#define DMA_READ_TAIL_LEN                  (2U)
+
+/* The latency trace needs both the trace and the timestamp source */
+#define TRACE_ENABLED(CONFIG)              ((NULL != (CONFIG)->trace) && \
+                                            (NULL != (CONFIG)->get_timestamp_us))
+
+/* Statistics counters compile to nothing when disabled. They are updated from
+ * both thread and interrupt context. */
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+#define STATS_ADD(CONFIG, FIELD, VAL)      mtb_ctp_ft5406_stats_add(&(CONFIG)->stats.FIELD, \
+                                                                    (uint32_t)(VAL))
+#else
+#define STATS_ADD(CONFIG, FIELD, VAL)      ((void)0)
+#endif
+
 
 
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
+/* Default instance used by the functions without instance parameter */
 static mtb_ctp_ft5406_config_t* ft5406_config = NULL;
 
+/* Registered instances, indexed by I2C event callback slot */
+static mtb_ctp_ft5406_config_t* ft5406_instances[MTB_CTP_FT5406_MAX_INSTANCES] = { NULL };
+
+/* I2C event callbacks registered before the instances, indexed by callback slot */
+static cy_cb_scb_i2c_handle_events_t ft5406_chained_callbacks[MTB_CTP_FT5406_MAX_INSTANCES] =
+{ NULL };
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_start_touch_read(mtb_ctp_ft5406_config_t* config,
+                                                              mtb_ctp_ft5406_read_cb_t read_cb,
+                                                              void* user_data,
+                                                              uint32_t lock_timeout_us);
+
 
 /*******************************************************************************
-* Function Name: mtb_ctp_i2c_controller_read
+* Function Name: mtb_ctp_i2c_get_error_status
 ********************************************************************************
 *
-* This function configures the I2C controller to read an entire buffer of data
-* from touch panel controller acting as I2C target.
-*
-* \param read_buff
-* Pointer to the I2C buffer for data to be read from the target.
+* Converts I2C controller error status bits into the corresponding I2C status.
 *
-* \param buff_size
-* Size of the I2C read buffer.
+* \param i2c_controller_stat
+* I2C controller status reported by Cy_SCB_I2C_MasterGetStatus().
 *
 * \return cy_en_scb_i2c_status_t
-* I2C controller read status
+* I2C status matching the highest-priority error bit.
 *
 *******************************************************************************/
-static cy_en_scb_i2c_status_t mtb_ctp_i2c_controller_read(uint8_t* read_buff,
-                                                          uint32_t buff_size)
+static cy_en_scb_i2c_status_t mtb_ctp_i2c_get_error_status(uint32_t i2c_controller_stat)
 {
-    cy_stc_scb_i2c_master_xfer_config_t transfer_config;
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
-    uint8_t retry_count               = RETRY_COUNT;
-    uint32_t i2c_controller_stat      = RESET_VAL;
-    uint32_t timeout_count;
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_MASTER_MANUAL_BUS_ERR;
 
-    CY_ASSERT(NULL != ft5406_config);
-    CY_ASSERT(NULL != read_buff);
+    if (0U != (CY_SCB_I2C_MASTER_ADDR_NAK & i2c_controller_stat))
+    {
+        i2c_status = CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK;
+    }
+    else if (0U != (CY_SCB_I2C_MASTER_DATA_NAK & i2c_controller_stat))
+    {
+        i2c_status = CY_SCB_I2C_MASTER_MANUAL_NAK;
+    }
+    else if (0U != (CY_SCB_I2C_MASTER_ARB_LOST & i2c_controller_stat))
+    {
+        i2c_status = CY_SCB_I2C_MASTER_MANUAL_ARB_LOST;
+    }
+    else if (0U != (CY_SCB_I2C_MASTER_ABORT_START & i2c_controller_stat))
+    {
+        i2c_status = CY_SCB_I2C_MASTER_MANUAL_ABORT_START;
+    }
+    else
+    {
+        /* Bus error or unknown error */
+    }
 
-    /* I2C controller transfer configuration */
-    transfer_config.slaveAddress      = MTB_CTP_FT5406_I2C_ADDRESS;
-    transfer_config.buffer            = read_buff;
-    transfer_config.bufferSize        = buff_size;
-    transfer_config.xferPending       = false;
+    return i2c_status;
+}
 
-    do
-    {
-        /* Initiate read transaction. */
-        i2c_status = Cy_SCB_I2C_MasterRead(ft5406_config->i2c_base,
-                                           &transfer_config,
-                                           ft5406_config->i2c_context);
 
-        if (CY_SCB_I2C_SUCCESS == i2c_status)
-        {
-            /* Total timeout 5 ms */
-            timeout_count = I2C_TIMEOUT_COUNT;
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_stats_add
+********************************************************************************
+*
+* Adds to a statistics counter. The read-modify-write is done with interrupts
+* disabled, so updates from thread and interrupt context are not lost.
+*
+* \param counter
+* Pointer to the statistics counter.
+*
+* \param value
+* Value to add.
+*
+*******************************************************************************/
+static inline void mtb_ctp_ft5406_stats_add(uint32_t* counter, uint32_t value)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
 
-            /* Wait until controller complete read transfer or time out has occurred */
-            do
-            {
-                i2c_controller_stat = Cy_SCB_I2C_MasterGetStatus(ft5406_config->i2c_base,
-                                                                 ft5406_config->i2c_context);
-                Cy_SysLib_Delay(I2C_DELAY_MS);
-                timeout_count--;
-            } while ((CY_SCB_I2C_MASTER_BUSY & i2c_controller_stat) &&
-                     timeout_count);
-
-            if (!(I2C_CONTROLLER_ERROR_MASK & i2c_controller_stat))
-            {
-                i2c_status  = CY_SCB_I2C_SUCCESS;
-                retry_count = RESET_VAL;
-            }
-            else
-            {
-                /* Timeout/error recovery */
-                Cy_SCB_I2C_Disable(ft5406_config->i2c_base, ft5406_config->i2c_context);
-                Cy_SCB_I2C_Enable(ft5406_config->i2c_base);
-                retry_count--;
-            }
-        }
-        else
-        {
-            retry_count--;
-        }
-    } while (retry_count);
+    *counter += value;
 
-    return i2c_status;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
 }
 
 
 /*******************************************************************************
-* Function Name: mtb_ctp_i2c_controller_write
+* Function Name: mtb_ctp_ft5406_stats_time
 ********************************************************************************
 *
-* This function configures the I2C controller to automatically write an entire
-* buffer of data to touch panel controller acting as I2C target.
-*
-* \param write_buff
-* Pointer to the I2C buffer for data to write to the I2C target.
+* Returns the current time for the latency statistics.
 *
-* \param buff_size
-* Size of the I2C write buffer.
+* \param config
+* Pointer to the FT5406 instance.
 *
-* \return cy_en_scb_i2c_status_t
-* I2C controller write status
+* \return uint32_t
+* Time in microseconds, 0 if no time source is set.
 *
 *******************************************************************************/
-static cy_en_scb_i2c_status_t mtb_ctp_i2c_controller_write(uint8_t* write_buff,
-                                                           uint32_t buff_size)
+static inline uint32_t mtb_ctp_ft5406_stats_time(const mtb_ctp_ft5406_config_t* config)
 {
-    cy_stc_scb_i2c_master_xfer_config_t transfer_config;
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
-    uint8_t retry_count               = RETRY_COUNT;
-    uint32_t i2c_controller_stat      = RESET_VAL;
-    uint32_t timeout_count;
+    return (NULL != config->get_timestamp_us) ? config->get_timestamp_us() : RESET_VAL;
+}
 
-    CY_ASSERT(NULL != ft5406_config);
-    CY_ASSERT(NULL != write_buff);
 
-    /* I2C controller transfer configuration */
-    transfer_config.slaveAddress      = MTB_CTP_FT5406_I2C_ADDRESS;
-    transfer_config.buffer            = write_buff;
-    transfer_config.bufferSize        = buff_size;
-    /* Generate Stop condition at the end of transaction */
-    transfer_config.xferPending       = false;
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_stats_add_latency
+********************************************************************************
+*
+* Counts a transfer in the log2 bucket of its duration.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param histogram
+* Latency histogram to update.
+*
+* \param start
+* Transfer start time in microseconds.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_stats_add_latency(const mtb_ctp_ft5406_config_t* config,
+                                             uint32_t histogram[MTB_CTP_FT5406_STATS_LATENCY_BUCKETS],
+                                             uint32_t start)
+{
+    uint32_t latency = mtb_ctp_ft5406_stats_time(config) - start;
+    uint32_t bucket  = RESET_VAL;
 
-    do
+    if (NULL != config->get_timestamp_us)
     {
-        /* Initiate write transaction */
-        /* The Start condition is generated to begin this transaction */
-        i2c_status = Cy_SCB_I2C_MasterWrite(ft5406_config->i2c_base,
-                                            &transfer_config,
-                                            ft5406_config->i2c_context);
-
-        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        while ((latency > 1U) && (bucket < (MTB_CTP_FT5406_STATS_LATENCY_BUCKETS - 1U)))
         {
-            /* Total timeout 5 ms */
-            timeout_count = I2C_TIMEOUT_COUNT;
+            latency >>= 1U;
+            bucket++;
+        }
+        mtb_ctp_ft5406_stats_add(&histogram[bucket], 1U);
+    }
+}
 
-            /* Wait until controller complete read transfer or time out has occurred */
-            do
-            {
-                i2c_controller_stat = Cy_SCB_I2C_MasterGetStatus(ft5406_config->i2c_base,
-                                                                 ft5406_config->i2c_context);
-                Cy_SysLib_Delay(I2C_DELAY_MS);
-                timeout_count--;
-            } while ((CY_SCB_I2C_MASTER_BUSY & i2c_controller_stat) &&
-                     timeout_count);
 
-            if ((!(I2C_CONTROLLER_ERROR_MASK & i2c_controller_stat)) &&
-                (transfer_config.bufferSize ==
-                 Cy_SCB_I2C_MasterGetTransferCount(ft5406_config->i2c_base,
-                                                   ft5406_config->i2c_context)))
-            {
-                i2c_status  = CY_SCB_I2C_SUCCESS;
-                retry_count = RESET_VAL;
-            }
-            else
-            {
-                /* Timeout/error recovery */
-                Cy_SCB_I2C_Disable(ft5406_config->i2c_base,
-                                   ft5406_config->i2c_context);
-                Cy_SCB_I2C_Enable(ft5406_config->i2c_base);
-                retry_count--;
-            }
-        }
-        else
-        {
-            retry_count--;
-        }
-    } while (retry_count);
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_stats_add_errors
+********************************************************************************
+*
+* Counts the failed transaction by I2C controller error bit.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param i2c_controller_stat
+* I2C controller status reported by Cy_SCB_I2C_MasterGetStatus().
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_stats_add_errors(mtb_ctp_ft5406_config_t* config,
+                                            uint32_t i2c_controller_stat)
+{
+    mtb_ctp_ft5406_stats_t* stats = &config->stats;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
 
-    return i2c_status;
+    stats->addr_nak    += (0U != (CY_SCB_I2C_MASTER_ADDR_NAK & i2c_controller_stat)) ? 1U : 0U;
+    stats->data_nak    += (0U != (CY_SCB_I2C_MASTER_DATA_NAK & i2c_controller_stat)) ? 1U : 0U;
+    stats->arb_lost    += (0U != (CY_SCB_I2C_MASTER_ARB_LOST & i2c_controller_stat)) ? 1U : 0U;
+    stats->abort_start += (0U != (CY_SCB_I2C_MASTER_ABORT_START & i2c_controller_stat)) ? 1U : 0U;
+    stats->bus_err     += (0U != (CY_SCB_I2C_MASTER_BUS_ERR & i2c_controller_stat)) ? 1U : 0U;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
 }
 
 
+#endif /* MTB_CTP_FT5406_ENABLE_STATS */
 /*******************************************************************************
-* Function Name: mtb_ctp_ft5406_read_raw_touch_data
+* Function Name: mtb_ctp_ft5406_transform_coordinate
 ********************************************************************************
 *
-* This function reads the raw x, y coordinate data from the touch panel
-* controller.
+* Applies one row of the affine coordinate transform and limits the result to
+* the output range.
 *
-* \param touch_data
-* Pointer to the buffer to store touch data.
+* \param k_x
+* Q16.16 coefficient of the X coordinate.
 *
-* \param size
-* Size of the buffer to store touch data.
+* \param k_y
+* Q16.16 coefficient of the Y coordinate.
 *
-* \return cy_en_scb_i2c_status_t
-* Read operation status based on I2C communication.
+* \param k_0
+* Q16.16 offset.
+*
+* \param touch_x
+* Panel X coordinate.
+*
+* \param touch_y
+* Panel Y coordinate.
+*
+* \param max_val
+* Largest output coordinate.
+*
+* \return uint16_t
+* Transformed coordinate.
 *
 *******************************************************************************/
-static cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_raw_touch_data(uint8_t* touch_data,
-                                                                 int size)
+static inline uint16_t mtb_ctp_ft5406_transform_coordinate(int32_t k_x, int32_t k_y, int32_t k_0,
+                                                           uint16_t touch_x, uint16_t touch_y,
+                                                           uint16_t max_val)
 {
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
-    uint8_t get_touch_cmd = MTB_CTP_REG_READ_TOUCH_DATA;
+    int64_t value = ((int64_t)k_x * touch_x) + ((int64_t)k_y * touch_y) + k_0 +
+                    ((int64_t)1 << (TRANSFORM_SHIFT - 1U));
 
-    CY_ASSERT(NULL != touch_data);
-
-    i2c_status = mtb_ctp_i2c_controller_write(&get_touch_cmd,
-                                              sizeof(get_touch_cmd));
-
-    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    if (value < 0)
     {
-        i2c_status = mtb_ctp_i2c_controller_read(touch_data, size);
+        value = 0;
     }
+    value >>= TRANSFORM_SHIFT;
 
-    return i2c_status;
+    return (value > (int64_t)max_val) ? max_val : (uint16_t)value;
 }
 
 
 /*******************************************************************************
-* Function Name: mtb_ctp_ft5406_init
+* Function Name: mtb_ctp_ft5406_transform_point
 ********************************************************************************
 *
-* Performs FT5406 Touch panel controller initialization using I2C interface.
+* Transforms the touch point from panel to display coordinates if a transform
+* is set for the instance.
 *
-* \param mtb_ft5406_config
-* Pointer to the FT5406 configuration structure.
+* \param config
+* Pointer to the FT5406 instance.
 *
-* \return cy_en_scb_i2c_status_t
-* Touch panel initialization status based on I2C communication.
+* \param touch_x
+* Pointer to the X coordinate.
 *
-* \func usage
-* \snippet snippet/main.c snippet_mtb_ctp_ft5406_init
+* \param touch_y
+* Pointer to the Y coordinate.
 *
 *******************************************************************************/
-cy_en_scb_i2c_status_t mtb_ctp_ft5406_init(mtb_ctp_ft5406_config_t* mtb_ft5406_config)
+static inline void mtb_ctp_ft5406_transform_point(const mtb_ctp_ft5406_config_t* config,
+                                                  uint16_t* touch_x,
+                                                  uint16_t* touch_y)
 {
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
-    uint8_t device_mode[] = { MTB_CTP_FT5406_DEVICE_MODE, MTB_CTP_FT5406_NORMAL_MODE };
+    const mtb_ctp_ft5406_affine_t* matrix = &config->transform_matrix;
+    uint16_t panel_x = *touch_x;
+    uint16_t panel_y = *touch_y;
 
-    CY_ASSERT(NULL != mtb_ft5406_config);
+    if (config->transform_enabled)
+    {
+        *touch_x = mtb_ctp_ft5406_transform_coordinate(matrix->a, matrix->b, matrix->c,
+                                                       panel_x, panel_y, config->transform_max_x);
+        *touch_y = mtb_ctp_ft5406_transform_coordinate(matrix->d, matrix->e, matrix->f,
+                                                       panel_x, panel_y, config->transform_max_y);
+    }
+}
 
-    ft5406_config = mtb_ft5406_config;
 
-    i2c_status = mtb_ctp_i2c_controller_write(device_mode, sizeof(device_mode));
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_get_touch_count
+********************************************************************************
+*
+* Returns the number of touch points to decode from the raw touch data.
+*
+* \param touch_data
+* Pointer to the raw touch data.
+*
+* \return uint8_t
+* Number of valid touch points, 0 if TD_STATUS is out of range. Limited to
+* MTB_CTP_FT5406_DECODE_MAX_TOUCHES.
+*
+*******************************************************************************/
+static inline uint8_t mtb_ctp_ft5406_get_touch_count(const mtb_ctp_ft5406_touch_data_t* touch_data)
+{
+    uint8_t detection_count = touch_data->touch_detection_count;
+
+    /* Check for valid number of touches - otherwise ignore touch information */
+    if (MTB_CTP_FT5406_MAX_TOUCHES < detection_count)
+    {
+        detection_count = RESET_VAL;
+    }
+    else if (MTB_CTP_FT5406_DECODE_MAX_TOUCHES < detection_count)
+    {
+        detection_count = MTB_CTP_FT5406_DECODE_MAX_TOUCHES;
+    }
+    else
+    {
+        /* Valid touch count */
+    }
 
-    return i2c_status;
+    return detection_count;
 }
 
 
 /*******************************************************************************
-* Function name: mtb_ctp_ft5406_get_single_touch
+* Function Name: mtb_ctp_ft5406_decode_multi_touch
 ********************************************************************************
 *
-* Reads single touch event coordinates from the FT5406 touch panel controller
-* using I2C interface.
+* Decodes the raw touch data into the multi touch point array. Each element is
+* written once: valid touch points are decoded from a single load of their
+* high bytes, and only the elements past the valid count are cleared.
 *
-* \param touch_event
-* Pointer to the variable for capturing generated touch event.
+* \param config
+* Pointer to the FT5406 instance.
 *
-* \param touch_x
-* Pointer to the variable for capturing X touch co-ordinate of the generated
-* touch event.
+* \param touch_buff
+* Pointer to the raw touch data.
 *
-* \param touch_y
-* Pointer to the variable for capturing Y touch co-ordinate of the generated
-* touch event.
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
 *
-* \return cy_en_scb_i2c_status_t
-* Single touch read operation status based on I2C communication.
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
 *
 *******************************************************************************/
-cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_single_touch(mtb_ctp_touch_event_t* touch_event,
-                                                       int* touch_x,
-                                                       int* touch_y)
+static void mtb_ctp_ft5406_decode_multi_touch(const mtb_ctp_ft5406_config_t* config,
+                                              const uint8_t* touch_buff,
+                                              int* touch_count,
+                                              mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
 {
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t i;
+    const mtb_ctp_ft5406_touch_data_t* touch_data =
+        (const mtb_ctp_ft5406_touch_data_t*)(const void*)touch_buff;
+    uint8_t detection_count = mtb_ctp_ft5406_get_touch_count(touch_data);
 
-    CY_ASSERT(NULL != touch_event);
-    CY_ASSERT(NULL != touch_x);
-    CY_ASSERT(NULL != touch_y);
+    /* Decode number of touches */
+    if (touch_count)
+    {
+        *touch_count = detection_count;
+    }
 
-    /* Reset touch event */
-    *touch_event = MTB_CTP_TOUCH_RESERVED;
+    /* Decode valid touch points */
+    for (i = 0U; i < detection_count; i++)
+    {
+        uint8_t xh = touch_data->touch_points[i].XH;
+        uint8_t yh = touch_data->touch_points[i].YH;
 
-    i2c_status = mtb_ctp_ft5406_read_raw_touch_data(ft5406_config->touch_buff,
-                                                    MTB_CTP_FT5406_TOUCH_DATA_LEN);
+        touch_array[i].touch_event = (mtb_ctp_touch_event_t)(xh >> 6U);
+        touch_array[i].touch_id    = (uint8_t)(yh >> 4U);
+        touch_array[i].touch_x     = (uint16_t)(((uint16_t)(xh & 0x0fU) << 8U) |
+                                                touch_data->touch_points[i].XL);
+        touch_array[i].touch_y     = (uint16_t)(((uint16_t)(yh & 0x0fU) << 8U) |
+                                                touch_data->touch_points[i].YL);
+        mtb_ctp_ft5406_transform_point(config, &touch_array[i].touch_x,
+                                       &touch_array[i].touch_y);
+    }
 
-    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    /* Clear vacant elements of touch_array */
+    for (i = detection_count; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
     {
-        mtb_ctp_ft5406_touch_data_t* touch_data =
-            (mtb_ctp_ft5406_touch_data_t*)(void*)(ft5406_config->touch_buff);
+        touch_array[i].touch_event = MTB_CTP_TOUCH_RESERVED;
+        touch_array[i].touch_id    = RESET_VAL;
+        touch_array[i].touch_x     = RESET_VAL;
+        touch_array[i].touch_y     = RESET_VAL;
+    }
+}
 
-        /* Get touch event for 1st touch point */
-        *touch_event = TOUCH_POINT_GET_EVENT(touch_data->touch_points[0]);
 
-        /* Update coordinates only if there is touch detected */
-        if ((MTB_CTP_TOUCH_DOWN == *touch_event) \
-            || (MTB_CTP_TOUCH_CONTACT == *touch_event))
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_filter_points
+********************************************************************************
+*
+* Applies the jitter filter to the decoded touch points of one frame. The
+* filtered position of each touch ID is kept between frames and restarts from
+* the reported position when the touch ID is put down.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param filter_states
+* Pointer to the filter state updated by the frame.
+*
+* \param touch_count
+* Number of valid touch points.
+*
+* \param touch_array
+* Decoded touch points, filtered in place.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_filter_points(const mtb_ctp_ft5406_config_t* config,
+                                         mtb_ctp_ft5406_filter_states_t* filter_states,
+                                         int touch_count,
+                                         mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    const mtb_ctp_ft5406_filter_t* filter = config->filter;
+    uint16_t filtered = RESET_VAL;
+    int i;
+
+    if (NULL != filter)
+    {
+        int32_t deadband  = (int32_t)filter->deadband << FILTER_SHIFT;
+        int32_t alpha_min = (int32_t)config->filter_alpha_min;
+        int32_t alpha_max = (int32_t)config->filter_alpha_max;
+
+        for (i = 0; i < touch_count; i++)
         {
-            if (touch_x)
+            mtb_ctp_multi_touch_point_t* point = &touch_array[i];
+            uint8_t id = point->touch_id & (MTB_CTP_FT5406_TOUCH_ID_COUNT - 1U);
+            uint16_t id_bit = (uint16_t)(1U << id);
+            mtb_ctp_ft5406_filter_state_t* state = &filter_states->points[id];
+            int32_t delta_x = ((int32_t)point->touch_x << FILTER_SHIFT) - state->x;
+            int32_t delta_y = ((int32_t)point->touch_y << FILTER_SHIFT) - state->y;
+            int32_t distance_x = (delta_x < 0) ? -delta_x : delta_x;
+            int32_t distance_y = (delta_y < 0) ? -delta_y : delta_y;
+            int32_t alpha;
+            uint32_t speed;
+
+            if ((MTB_CTP_TOUCH_DOWN != point->touch_event) &&
+                (MTB_CTP_TOUCH_CONTACT != point->touch_event))
             {
-                *touch_x = TOUCH_POINT_GET_X(touch_data->touch_points[0]);
+                /* Lifted touch point: report its last filtered position */
+                if (0U != (filter_states->active & id_bit))
+                {
+                    point->touch_x = (uint16_t)((state->x + FILTER_ROUND) >> FILTER_SHIFT);
+                    point->touch_y = (uint16_t)((state->y + FILTER_ROUND) >> FILTER_SHIFT);
+                }
+                continue;
             }
-            if (touch_y)
+
+            if ((0U == (filter_states->active & id_bit)) ||
+                (MTB_CTP_TOUCH_DOWN == point->touch_event))
+            {
+                /* New contact starts at the reported position */
+                state->x = (int32_t)point->touch_x << FILTER_SHIFT;
+                state->y = (int32_t)point->touch_y << FILTER_SHIFT;
+            }
+            else if ((distance_x > deadband) || (distance_y > deadband))
+            {
+                /* Smoothing follows faster movements more closely */
+                alpha = alpha_min;
+                if (0U != filter->speed_threshold)
+                {
+                    speed = (uint32_t)((distance_x > distance_y) ? distance_x : distance_y) >>
+                            FILTER_SHIFT;
+                    if (speed > filter->speed_threshold)
+                    {
+                        speed = filter->speed_threshold;
+                    }
+                    alpha += ((alpha_max - alpha_min) * (int32_t)speed) /
+                             (int32_t)filter->speed_threshold;
+                }
+
+                state->x += (int32_t)(((int64_t)delta_x * alpha) / FILTER_ALPHA_ONE);
+                state->y += (int32_t)(((int64_t)delta_y * alpha) / FILTER_ALPHA_ONE);
+            }
+            else
             {
-                *touch_y = TOUCH_POINT_GET_Y(touch_data->touch_points[0]);
+                /* Resting contact keeps its position */
             }
+
+            filtered |= id_bit;
+            point->touch_x = (uint16_t)((state->x + FILTER_ROUND) >> FILTER_SHIFT);
+            point->touch_y = (uint16_t)((state->y + FILTER_ROUND) >> FILTER_SHIFT);
         }
     }
 
-    return i2c_status;
+    /* Touch IDs missing from the frame are lifted */
+    filter_states->active = filtered;
 }
 
 
 /*******************************************************************************
-* Function name: mtb_ctp_ft5406_get_multi_touch
+* Function Name: mtb_ctp_ft5406_init_filter
 ********************************************************************************
 *
-* Reads multi touch event coordinates from the FT5406 touch panel controller
-* using I2C interface.
-*
-* \param touch_count
-* Pointer to the variable holding multi touch counts.
-*
-* \param touch_array
-* Pointer to the array for storing touch data for each detected touch point(s).
+* Resets the jitter filter state and resolves the filter weights of the
+* instance. Zero weights select no smoothing, and weights above 1 (256) are
+* limited to it, which keeps the filtered positions from overshooting.
 *
-* \return cy_en_scb_i2c_status_t
-* Multi touch read operation status based on I2C communication.
+* \param config
+* Pointer to the FT5406 instance.
 *
 *******************************************************************************/
-cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch(int* touch_count,
-                                                      mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+static void mtb_ctp_ft5406_init_filter(mtb_ctp_ft5406_config_t* config)
 {
-    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
-    uint8_t i = RESET_VAL;
-
-    CY_ASSERT(NULL != touch_count);
-    CY_ASSERT(NULL != touch_array);
-
-    i2c_status = mtb_ctp_ft5406_read_raw_touch_data(ft5406_config->touch_buff,
-                                                    MTB_CTP_FT5406_TOUCH_DATA_LEN);
+    const mtb_ctp_ft5406_filter_t* filter = config->filter;
+    uint16_t alpha_min = (uint16_t)FILTER_ALPHA_ONE;
+    uint16_t alpha_max = (uint16_t)FILTER_ALPHA_ONE;
 
-    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    if (NULL != filter)
     {
-        mtb_ctp_ft5406_touch_data_t* touch_data =
-            (mtb_ctp_ft5406_touch_data_t*)(void*)(ft5406_config->touch_buff);
-
-        /* Check for valid number of touches - otherwise ignore touch information */
-        if (MTB_CTP_FT5406_MAX_TOUCHES < touch_data->touch_detection_count)
+        if ((0U != filter->alpha_min) && (filter->alpha_min < alpha_min))
         {
-            touch_data->touch_detection_count = RESET_VAL;
+            alpha_min = filter->alpha_min;
         }
-
-        /* Decode number of touches */
-        if (touch_count)
+        if ((0U != filter->alpha_max) && (filter->alpha_max < alpha_max))
         {
-            *touch_count = touch_data->touch_detection_count;
+            alpha_max = filter->alpha_max;
         }
+    }
 
-        /* Decode valid touch points */
-        for (i = 0; i < touch_data->touch_detection_count; i++)
-        {
-            touch_array[i].touch_event = TOUCH_POINT_GET_EVENT(touch_data->touch_points[i]);
-            touch_array[i].touch_id    = TOUCH_POINT_GET_ID(touch_data->touch_points[i]);
-            touch_array[i].touch_x     = TOUCH_POINT_GET_X(touch_data->touch_points[i]);
-            touch_array[i].touch_y     = TOUCH_POINT_GET_Y(touch_data->touch_points[i]);
-        }
+    config->filter_alpha_min = alpha_min;
+    config->filter_alpha_max = alpha_max;
+    (void)memset(&config->filter_states, 0, sizeof(config->filter_states));
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_is_frame_changed
+********************************************************************************
+*
+* Compares a processed touch frame with the frame served to the consumers.
+* Only the valid touch points are compared, vacant elements are always clear.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_event
+* Event of the 1st touch point of the new frame.
+*
+* \param touch_count
+* Number of valid touch points of the new frame.
+*
+* \param touch_array
+* Touch points of the new frame.
+*
+* \return bool
+* True if the new frame differs from the served frame.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_is_frame_changed(const mtb_ctp_ft5406_config_t* config,
+                                            mtb_ctp_touch_event_t touch_event,
+                                            int touch_count,
+                                            const mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    bool changed = (touch_event != config->touch_single_event) ||
+                   (touch_count != (int)config->touch_count);
+    int i;
+
+    for (i = 0; (i < touch_count) && !changed; i++)
+    {
+        changed = (touch_array[i].touch_event != config->touch_array[i].touch_event) ||
+                  (touch_array[i].touch_id != config->touch_array[i].touch_id) ||
+                  (touch_array[i].touch_x != config->touch_array[i].touch_x) ||
+                  (touch_array[i].touch_y != config->touch_array[i].touch_y);
+    }
+
+    return changed;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_process_frame
+********************************************************************************
+*
+* Runs the touch buffer through the decode pipeline of the instance: decode,
+* coordinate transform, and jitter filter. The result is the touch frame
+* served to all consumers, in both array-of-structures and structure-of-arrays
+* layout, so the stateful stages run once per frame. The
+* frame change counter is advanced when the result differs from the previous
+* frame.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_process_frame(mtb_ctp_ft5406_config_t* config)
+{
+    const mtb_ctp_ft5406_touch_data_t* touch_data =
+        (const mtb_ctp_ft5406_touch_data_t*)(const void*)TOUCH_BUFF_FRONT(config);
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_touch_event_t touch_event;
+    int touch_count = RESET_VAL;
+    uint32_t i;
+
+    /* Single touch reports the event of the 1st touch point, also when lifted */
+    touch_event = TOUCH_POINT_GET_EVENT(touch_data->touch_points[0]);
+
+    mtb_ctp_ft5406_decode_multi_touch(config, TOUCH_BUFF_FRONT(config), &touch_count,
+                                      touch_array);
+    mtb_ctp_ft5406_filter_points(config, &config->filter_states, touch_count, touch_array);
+
+    /* The gesture register is only meaningful in the frame reporting it */
+    config->touch_gesture_id = touch_data->gesture_id;
+
+    if (mtb_ctp_ft5406_is_frame_changed(config, touch_event, touch_count, touch_array))
+    {
+        config->touch_single_event = touch_event;
+        config->touch_count        = (uint8_t)touch_count;
+        (void)memcpy(config->touch_array, touch_array, sizeof(config->touch_array));
+        config->touch_changes++;
+
+        /* Structure-of-arrays copy of the frame, vacant elements are clear */
+        config->touch_soa.touch_count = (uint8_t)touch_count;
+        for (i = 0U; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
+        {
+            config->touch_soa.touch_event[i] = (uint8_t)touch_array[i].touch_event;
+            config->touch_soa.touch_id[i]    = touch_array[i].touch_id;
+            config->touch_soa.touch_x[i]     = touch_array[i].touch_x;
+            config->touch_soa.touch_y[i]     = touch_array[i].touch_y;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_lock_bus
+********************************************************************************
+*
+* Takes the lock of the shared I2C bus. Always succeeds if the bus is not
+* shared.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param priority
+* True for touch reads, which take precedence over other bus traffic.
+*
+* \param timeout_us
+* Time to wait for the lock in microseconds, 0 in interrupt context.
+*
+* \return bool
+* True if the lock is taken.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_lock_bus(mtb_ctp_ft5406_config_t* config,
+                                    bool priority,
+                                    uint32_t timeout_us)
+{
+    const mtb_ctp_ft5406_bus_lock_t* bus_lock = config->bus_lock;
+
+    return (NULL == bus_lock) || bus_lock->lock(bus_lock->context, priority, timeout_us);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_unlock_bus
+********************************************************************************
+*
+* Releases the lock of the shared I2C bus taken by mtb_ctp_ft5406_lock_bus().
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_unlock_bus(mtb_ctp_ft5406_config_t* config)
+{
+    const mtb_ctp_ft5406_bus_lock_t* bus_lock = config->bus_lock;
 
-        /* Clear vacant elements of touch_array */
-        for (i = 0; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
+    if (NULL != bus_lock)
+    {
+        bus_lock->unlock(bus_lock->context);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_issue_reg_read
+********************************************************************************
+*
+* Issues the register address write phase of a combined register read. The
+* register address is written without Stop condition, and the data phase is
+* started from the I2C event callback with a repeated Start.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* FT5406 register address to start reading from.
+*
+* \param read_buff
+* Pointer to the buffer for data to be read from the target.
+*
+* \param read_size
+* Number of bytes to read.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the transfer start.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_issue_reg_read(mtb_ctp_ft5406_config_t* config,
+                                                            uint8_t reg_addr,
+                                                            uint8_t* read_buff,
+                                                            uint32_t read_size)
+{
+    cy_en_scb_i2c_status_t i2c_status;
+
+    config->xfer_cmd       = reg_addr;
+    config->xfer_read_buff = read_buff;
+    config->xfer_read_size = read_size;
+
+    /* I2C controller transfer configuration */
+    config->xfer_config.slaveAddress = MTB_CTP_FT5406_I2C_ADDRESS;
+    config->xfer_config.buffer       = &config->xfer_cmd;
+    config->xfer_config.bufferSize   = sizeof(config->xfer_cmd);
+    /* Do not generate Stop condition, the read follows with repeated Start */
+    config->xfer_config.xferPending  = true;
+
+    /* State must be set before the transfer starts as completion is reported from ISR */
+    config->xfer_state = MTB_CTP_FT5406_XFER_WRITE_ADDR;
+
+    i2c_status = Cy_SCB_I2C_MasterWrite(config->i2c_base,
+                                        &config->xfer_config,
+                                        config->i2c_context);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        STATS_ADD(config, transactions, 1U);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_stop_dma
+********************************************************************************
+*
+* Disables the DataWire channel of a DMA read which did not complete, so a late
+* channel interrupt is ignored.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+static inline void mtb_ctp_ft5406_stop_dma(mtb_ctp_ft5406_config_t* config)
+{
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    if (config->xfer_dma_wait)
+    {
+        Cy_DMA_Channel_Disable(config->dma->base, config->dma->channel);
+        config->xfer_dma_wait = false;
+    }
+#else
+    CY_UNUSED_PARAMETER(config);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_read_data
+********************************************************************************
+*
+* Starts the data phase of the combined read once the register address is
+* written. With a DataWire channel configured, the channel receives all but
+* the last DMA_READ_TAIL_LEN bytes: the PDL reads only the tail, and its RX
+* interrupt is masked until the channel completes. Until then the controller
+* ACKs the bytes as the channel drains the RX FIFO, triggered on every byte by
+* the FIFO level the PDL sets for a two byte read. The PDL then receives the
+* tail, NAKs the last byte, generates the Stop, and reports the read
+* completion. Called from the SCB interrupt, so the RX interrupt is masked
+* before the first byte is received.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the read start.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_data(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status;
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    const mtb_ctp_ft5406_dma_t* dma = config->dma;
+    uint32_t dma_size;
+
+    if ((NULL != dma) && (DMA_READ_TAIL_LEN < config->xfer_read_size))
+    {
+        dma_size = config->xfer_read_size - DMA_READ_TAIL_LEN;
+
+        Cy_DMA_Descriptor_SetSrcAddress(dma->descriptor,
+                                        (void const*)&SCB_RX_FIFO_RD(config->i2c_base));
+        Cy_DMA_Descriptor_SetDstAddress(dma->descriptor, config->xfer_read_buff);
+        Cy_DMA_Descriptor_SetXloopDataCount(dma->descriptor, dma_size);
+        Cy_DMA_Channel_SetDescriptor(dma->base, dma->channel, dma->descriptor);
+        Cy_DMA_Channel_ClearInterrupt(dma->base, dma->channel);
+        config->xfer_dma_wait = true;
+        Cy_DMA_Channel_Enable(dma->base, dma->channel);
+
+        config->xfer_config.buffer     = &config->xfer_read_buff[dma_size];
+        config->xfer_config.bufferSize = DMA_READ_TAIL_LEN;
+    }
+#endif
+
+    i2c_status = Cy_SCB_I2C_MasterRead(config->i2c_base,
+                                       &config->xfer_config,
+                                       config->i2c_context);
+
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    if (config->xfer_dma_wait)
+    {
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            Cy_SCB_SetRxInterruptMask(config->i2c_base, RESET_VAL);
+        }
+        else
         {
-            touch_array[i].touch_event = MTB_CTP_TOUCH_RESERVED;
-            touch_array[i].touch_id    = RESET_VAL;
-            touch_array[i].touch_x     = RESET_VAL;
-            touch_array[i].touch_y     = RESET_VAL;
+            mtb_ctp_ft5406_stop_dma(config);
         }
     }
+#endif
 
     return i2c_status;
 }
 
 
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_push_frame
+********************************************************************************
+*
+* Stores the processed touch frame with its timestamp in the frame ring.
+* Called from the touch read completion, which is the only producer.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param timestamp
+* Read completion time in microseconds.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_push_frame(mtb_ctp_ft5406_config_t* config, uint32_t timestamp)
+{
+    mtb_ctp_ft5406_frame_t frame;
+
+    frame.timestamp   = timestamp;
+    frame.touch_count = config->touch_count;
+    frame.gesture_id  = config->touch_gesture_id;
+    frame.trace_frame = config->trace_frame;
+    (void)memcpy(frame.touch_points, config->touch_array, sizeof(frame.touch_points));
+
+    (void)mtb_ctp_ft5406_frame_ring_push(config->frame_ring, &frame);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_complete_read
+********************************************************************************
+*
+* Finishes the touch read transfer: records the transfer status, returns the
+* state machine to idle, and notifies the registered read callback.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param i2c_status
+* Final status of the touch read transfer.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_complete_read(mtb_ctp_ft5406_config_t* config,
+                                         cy_en_scb_i2c_status_t i2c_status)
+{
+    mtb_ctp_ft5406_read_cb_t read_cb = config->read_cb;
+    void* user_data = config->read_cb_user_data;
+    int touch_count = RESET_VAL;
+    uint32_t timestamp = RESET_VAL;
+
+    config->read_cb           = NULL;
+    config->read_cb_user_data = NULL;
+
+    /* A failed DMA read leaves the DataWire channel running */
+    mtb_ctp_ft5406_stop_dma(config);
+
+    if (config->xfer_touch_read && (NULL != config->get_timestamp_us))
+    {
+        timestamp = config->get_timestamp_us();
+    }
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+    if (config->xfer_touch_read)
+    {
+        mtb_ctp_ft5406_stats_add_latency(config, config->stats.read_latency,
+                                         config->stats_read_start);
+    }
+#endif
+
+    if (config->xfer_touch_read && (NULL != config->capture))
+    {
+        mtb_ctp_ft5406_capture_frame(config->capture, timestamp, i2c_status,
+                                     TOUCH_BUFF_BACK(config));
+    }
+
+    if (config->xfer_touch_read && (CY_SCB_I2C_SUCCESS == i2c_status))
+    {
+        uint8_t raw_count;
+
+        /* The received frame becomes the front buffer. A failed read leaves
+         * the last complete frame intact. */
+        config->touch_front = config->touch_back;
+
+        /* Size the next adaptive read from the touch count of this frame */
+        raw_count = TOUCH_BUFF_FRONT(config)[TOUCH_DATA_COUNT_OFFSET];
+        config->touch_last_count = (MTB_CTP_FT5406_MAX_TOUCHES < raw_count) ?
+                                   (uint8_t)RESET_VAL : raw_count;
+
+        /* Decode once, all consumers are served from the processed frame */
+        mtb_ctp_ft5406_process_frame(config);
+        touch_count = config->touch_count;
+
+        if (TRACE_ENABLED(config))
+        {
+            config->trace_frame = mtb_ctp_ft5406_trace_frame(config->trace,
+                                                             config->trace_request,
+                                                             config->trace_start, timestamp,
+                                                             config->get_timestamp_us());
+        }
+
+        if (NULL != config->frame_ring)
+        {
+            mtb_ctp_ft5406_push_frame(config, timestamp);
+        }
+    }
+    if (config->xfer_touch_read && (NULL != config->int_port))
+    {
+        config->int_status = i2c_status;
+    }
+    config->xfer_touch_read = false;
+
+    config->xfer_status = i2c_status;
+
+    /* Return to idle before the callback so that it can start the next read */
+    config->xfer_state  = MTB_CTP_FT5406_XFER_IDLE;
+    mtb_ctp_ft5406_unlock_bus(config);
+
+    if (NULL != read_cb)
+    {
+        if ((CY_SCB_I2C_SUCCESS == i2c_status) && TRACE_ENABLED(config))
+        {
+            mtb_ctp_ft5406_trace_pickup(config->trace, config->trace_frame,
+                                        config->get_timestamp_us());
+        }
+
+        read_cb(i2c_status, touch_count, config->touch_array, user_data);
+    }
+
+    /* Serve the INT assertion which arrived while the bus was busy */
+    mtb_ctp_ft5406_bus_released_ex(config);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_start_touch_topup
+********************************************************************************
+*
+* Checks whether the touch read fetched all the touch points reported by
+* TD_STATUS and re-reads the whole frame from TD_STATUS on if needed. A frame
+* is never assembled from separate transactions, which could tear it between
+* two touch reports. Only applicable to adaptive reads, which are sized from
+* the previous frame.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return bool
+* True if the re-read is started, false if the touch data is complete.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_start_touch_topup(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t touch_count = TOUCH_BUFF_BACK(config)[TOUCH_DATA_COUNT_OFFSET];
+
+    if ((!config->xfer_touch_read) || (MTB_CTP_FT5406_MAX_TOUCHES < touch_count) ||
+        (touch_count <= config->touch_read_points))
+    {
+        return false;
+    }
+
+    /* The next check ends the re-reads unless the touch count grows again */
+    config->touch_read_points = touch_count;
+
+    i2c_status = mtb_ctp_ft5406_issue_reg_read(config,
+                                               MTB_CTP_REG_READ_TOUCH_DATA,
+                                               TOUCH_BUFF_BACK(config),
+                                               TOUCH_DATA_HEADER_LEN +
+                                               ((uint32_t)touch_count * TOUCH_POINT_LEN));
+
+    if (CY_SCB_I2C_SUCCESS != i2c_status)
+    {
+        mtb_ctp_ft5406_complete_read(config, i2c_status);
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_finish_read
+********************************************************************************
+*
+* Finishes the read once its data is received: re-reads a touch frame which
+* has more touch points than the adaptive read fetched, else completes the
+* read.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_finish_read(mtb_ctp_ft5406_config_t* config)
+{
+    /* Register address and register data */
+    STATS_ADD(config, bytes, sizeof(config->xfer_cmd) + config->xfer_read_size);
+
+    if (!mtb_ctp_ft5406_start_touch_topup(config))
+    {
+        mtb_ctp_ft5406_complete_read(config, CY_SCB_I2C_SUCCESS);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_handle_i2c_event
+********************************************************************************
+*
+* Advances the touch read state machine of an instance on I2C controller events.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param event
+* I2C controller events reported by the PDL.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_handle_i2c_event(mtb_ctp_ft5406_config_t* config, uint32_t event)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    if (0U != (CY_SCB_I2C_MASTER_ERR_EVENT & event))
+    {
+        uint32_t i2c_controller_stat = Cy_SCB_I2C_MasterGetStatus(config->i2c_base,
+                                                                  config->i2c_context);
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+        mtb_ctp_ft5406_stats_add_errors(config, i2c_controller_stat);
+#endif
+        mtb_ctp_ft5406_complete_read(config, mtb_ctp_i2c_get_error_status(i2c_controller_stat));
+    }
+    else if ((MTB_CTP_FT5406_XFER_WRITE_ADDR == config->xfer_state) &&
+             (0U != (CY_SCB_I2C_MASTER_WR_CMPLT_EVENT & event)))
+    {
+        /* Register address is written, read the data after repeated Start */
+        config->xfer_config.buffer      = config->xfer_read_buff;
+        config->xfer_config.bufferSize  = config->xfer_read_size;
+        config->xfer_config.xferPending = false;
+        config->xfer_state              = MTB_CTP_FT5406_XFER_READ_DATA;
+
+        i2c_status = mtb_ctp_ft5406_read_data(config);
+
+        if (CY_SCB_I2C_SUCCESS != i2c_status)
+        {
+            mtb_ctp_ft5406_complete_read(config, i2c_status);
+        }
+    }
+    else if ((MTB_CTP_FT5406_XFER_READ_DATA == config->xfer_state) &&
+             (0U != (CY_SCB_I2C_MASTER_RD_CMPLT_EVENT & event)))
+    {
+        mtb_ctp_ft5406_finish_read(config);
+    }
+    else
+    {
+        /* Intermediate event, wait for the transfer to complete */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_route_i2c_event
+********************************************************************************
+*
+* Routes I2C controller events of a callback slot. Events of touch read
+* transfers advance the state machine of the instance, events of blocking
+* transfers of the instance are ignored, and events of transfers started by
+* other drivers on the same I2C context are passed to the callback registered
+* before the instance.
+*
+* \param slot
+* Index of the callback slot.
+*
+* \param event
+* I2C controller events reported by the PDL.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_route_i2c_event(uint32_t slot, uint32_t event)
+{
+    mtb_ctp_ft5406_config_t* config = ft5406_instances[slot];
+
+    if ((NULL != config) && ((MTB_CTP_FT5406_XFER_WRITE_ADDR == config->xfer_state) ||
+                             (MTB_CTP_FT5406_XFER_READ_DATA == config->xfer_state)))
+    {
+        mtb_ctp_ft5406_handle_i2c_event(config, event);
+    }
+    else if (((NULL == config) || (!config->xfer_polled)) &&
+             (NULL != ft5406_chained_callbacks[slot]))
+    {
+        ft5406_chained_callbacks[slot](event);
+    }
+    else
+    {
+        /* Blocking transfer of the instance, completion is polled */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_i2c_event_callback_<n>
+********************************************************************************
+*
+* I2C controller event callbacks registered with Cy_SCB_I2C_RegisterEventCallback()
+* for each instance slot. The PDL callback carries no context, so each slot has
+* its own callback routing the events to the instance registered in that slot.
+*
+* \param event
+* I2C controller events reported by the PDL.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_i2c_event_callback_0(uint32_t event)
+{
+    mtb_ctp_ft5406_route_i2c_event(0U, event);
+}
+
+
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 1U)
+static void mtb_ctp_ft5406_i2c_event_callback_1(uint32_t event)
+{
+    mtb_ctp_ft5406_route_i2c_event(1U, event);
+}
+
+
+#endif
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 2U)
+static void mtb_ctp_ft5406_i2c_event_callback_2(uint32_t event)
+{
+    mtb_ctp_ft5406_route_i2c_event(2U, event);
+}
+
+
+#endif
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 3U)
+static void mtb_ctp_ft5406_i2c_event_callback_3(uint32_t event)
+{
+    mtb_ctp_ft5406_route_i2c_event(3U, event);
+}
+
+
+#endif
+static const cy_cb_scb_i2c_handle_events_t ft5406_event_callbacks[MTB_CTP_FT5406_MAX_INSTANCES] =
+{
+    mtb_ctp_ft5406_i2c_event_callback_0,
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 1U)
+    mtb_ctp_ft5406_i2c_event_callback_1,
+#endif
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 2U)
+    mtb_ctp_ft5406_i2c_event_callback_2,
+#endif
+#if (MTB_CTP_FT5406_MAX_INSTANCES > 3U)
+    mtb_ctp_ft5406_i2c_event_callback_3,
+#endif
+};
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_reserve_xfer
+********************************************************************************
+*
+* Reserves the idle transfer state machine for a read. The fields of the
+* transfer may only be written once the reservation succeeded, as the state
+* machine may be owned by a transfer started from another context.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* CY_SCB_I2C_MASTER_NOT_READY if a transfer is in progress.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_reserve_xfer(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (MTB_CTP_FT5406_XFER_IDLE == config->xfer_state)
+    {
+        config->xfer_state = MTB_CTP_FT5406_XFER_LOCK_WAIT;
+    }
+    else
+    {
+        i2c_status = CY_SCB_I2C_MASTER_NOT_READY;
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_start_reg_read
+********************************************************************************
+*
+* Starts a combined register read transfer and returns without waiting for its
+* completion. The transfer is completed from the SCB I2C interrupt context.
+* The state machine must be reserved by mtb_ctp_ft5406_reserve_xfer(); it is
+* returned to idle if the transfer cannot be started.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* FT5406 register address to start reading from.
+*
+* \param read_buff
+* Pointer to the buffer for data to be read from the target.
+*
+* \param read_size
+* Number of bytes to read.
+*
+* \param read_cb
+* Callback to be invoked on transfer completion, can be NULL.
+*
+* \param user_data
+* User data to be passed to the callback.
+*
+* \param lock_timeout_us
+* Time to wait for the shared bus lock in microseconds, 0 in interrupt context.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the transfer start. CY_SCB_I2C_MASTER_NOT_READY is returned if the
+* shared bus lock is not obtained.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_start_reg_read(mtb_ctp_ft5406_config_t* config,
+                                                            uint8_t reg_addr,
+                                                            uint8_t* read_buff,
+                                                            uint32_t read_size,
+                                                            mtb_ctp_ft5406_read_cb_t read_cb,
+                                                            void* user_data,
+                                                            uint32_t lock_timeout_us)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != read_buff);
+    CY_ASSERT(MTB_CTP_FT5406_XFER_LOCK_WAIT == config->xfer_state);
+
+    /* The lock is held for the combined read only, it is released on completion */
+    if (!mtb_ctp_ft5406_lock_bus(config, config->xfer_touch_read, lock_timeout_us))
+    {
+        config->xfer_touch_read = false;
+        config->xfer_state      = MTB_CTP_FT5406_XFER_IDLE;
+        return CY_SCB_I2C_MASTER_NOT_READY;
+    }
+
+    /* The wait for the shared bus belongs to the start stage of the trace */
+    if (config->xfer_touch_read && TRACE_ENABLED(config))
+    {
+        config->trace_start = config->get_timestamp_us();
+    }
+
+    config->read_cb           = read_cb;
+    config->read_cb_user_data = user_data;
+    config->xfer_status       = CY_SCB_I2C_MASTER_NOT_READY;
+
+    i2c_status = mtb_ctp_ft5406_issue_reg_read(config, reg_addr, read_buff, read_size);
+
+    if (CY_SCB_I2C_SUCCESS != i2c_status)
+    {
+        config->read_cb         = NULL;
+        config->xfer_touch_read = false;
+        config->xfer_state      = MTB_CTP_FT5406_XFER_IDLE;
+        mtb_ctp_ft5406_unlock_bus(config);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_start_touch_read
+********************************************************************************
+*
+* Starts the touch data read. In adaptive read mode, the read is sized from the
+* touch count of the previous frame and topped up when the count grows.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param read_cb
+* Callback to be invoked on transfer completion, can be NULL.
+*
+* \param user_data
+* User data to be passed to the callback.
+*
+* \param lock_timeout_us
+* Time to wait for the shared bus lock in microseconds, 0 in interrupt context.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the transfer start.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_start_touch_read(mtb_ctp_ft5406_config_t* config,
+                                                              mtb_ctp_ft5406_read_cb_t read_cb,
+                                                              void* user_data,
+                                                              uint32_t lock_timeout_us)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t read_points = MTB_CTP_FT5406_MAX_TOUCHES;
+    uint8_t back;
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+
+    /* Reserve the state machine before writing any field of the transfer. The
+     * read lands in a buffer holding neither the latest frame nor the frame of
+     * the view, so neither moves while the read is in progress. */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    i2c_status = mtb_ctp_ft5406_reserve_xfer(config);
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        back = RESET_VAL;
+        while ((back == config->touch_front) || (back == config->touch_held))
+        {
+            back++;
+        }
+        config->touch_back = back;
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (CY_SCB_I2C_SUCCESS != i2c_status)
+    {
+        return i2c_status;
+    }
+
+    if (MTB_CTP_FT5406_READ_ADAPTIVE == config->read_mode)
+    {
+        /* Always read the first touch point, it reports the lift-off event */
+        read_points = (RESET_VAL == config->touch_last_count) ?
+                      1U : config->touch_last_count;
+    }
+
+    config->touch_read_points = read_points;
+    config->xfer_touch_read   = true;
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+    config->stats_read_start  = mtb_ctp_ft5406_stats_time(config);
+#endif
+
+    if (TRACE_ENABLED(config))
+    {
+        /* Trace from the INT assertion the read serves, else from the request */
+        config->trace_request = config->trace_int_valid ? config->trace_int :
+                                config->get_timestamp_us();
+    }
+
+    i2c_status = mtb_ctp_ft5406_start_reg_read(config,
+                                               MTB_CTP_REG_READ_TOUCH_DATA,
+                                               TOUCH_BUFF_BACK(config),
+                                               TOUCH_DATA_HEADER_LEN +
+                                               ((uint32_t)read_points * TOUCH_POINT_LEN),
+                                               read_cb, user_data, lock_timeout_us);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        config->trace_int_valid = false;
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_abort_read
+********************************************************************************
+*
+* Aborts the touch read transfer in progress and returns the state machine to
+* idle without invoking the read callback. A read which completed meanwhile is
+* left as completed.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return bool
+* True if the read was aborted, false if it had already completed.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_abort_read(mtb_ctp_ft5406_config_t* config)
+{
+    bool aborted = true;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (MTB_CTP_FT5406_XFER_WRITE_ADDR == config->xfer_state)
+    {
+        Cy_SCB_I2C_MasterAbortWrite(config->i2c_base, config->i2c_context);
+    }
+    else if (MTB_CTP_FT5406_XFER_READ_DATA == config->xfer_state)
+    {
+        Cy_SCB_I2C_MasterAbortRead(config->i2c_base, config->i2c_context);
+    }
+    else
+    {
+        /* Transfer already completed */
+        aborted = false;
+    }
+
+    if (aborted)
+    {
+        mtb_ctp_ft5406_stop_dma(config);
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+        if (config->xfer_touch_read)
+        {
+            mtb_ctp_ft5406_stats_add_latency(config, config->stats.read_latency,
+                                             config->stats_read_start);
+        }
+#endif
+
+        config->read_cb           = NULL;
+        config->read_cb_user_data = NULL;
+        config->xfer_touch_read   = false;
+        config->xfer_state        = MTB_CTP_FT5406_XFER_IDLE;
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    /* Released with interrupts enabled, waking a waiter may switch context */
+    if (aborted)
+    {
+        mtb_ctp_ft5406_unlock_bus(config);
+    }
+
+    return aborted;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_delay_us
+********************************************************************************
+*
+* Waits for the given time, which can exceed the range of Cy_SysLib_DelayUs().
+*
+* \param delay_us
+* Time to wait in microseconds.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_delay_us(uint32_t delay_us)
+{
+    Cy_SysLib_Delay(delay_us / 1000U);
+    Cy_SysLib_DelayUs((uint16_t)(delay_us % 1000U));
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_retry_backoff
+********************************************************************************
+*
+* Waits before a retry and computes the wait before the next one.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param backoff_us
+* Time to wait before this retry in microseconds.
+*
+* \return uint32_t
+* Time to wait before the next retry in microseconds.
+*
+*******************************************************************************/
+static uint32_t mtb_ctp_ft5406_retry_backoff(mtb_ctp_ft5406_config_t* config, uint32_t backoff_us)
+{
+    uint32_t backoff_max_us = config->retry_policy.backoff_max_us;
+
+    STATS_ADD(config, retries, 1U);
+
+    if (0U != backoff_us)
+    {
+        mtb_ctp_ft5406_delay_us(backoff_us);
+    }
+
+    if (backoff_us < backoff_max_us)
+    {
+        backoff_us = ((backoff_max_us / 2U) < backoff_us) ? backoff_max_us : (2U * backoff_us);
+    }
+
+    return backoff_us;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_recover_bus
+********************************************************************************
+*
+* Recovers the I2C controller after a failed attempt. With light recovery,
+* the first failure of a transfer is handled by ending the transfer only,
+* which is already done. Otherwise the I2C controller is re-enabled, holding
+* the shared bus lock so that transfers of other devices are not cut off.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param attempt
+* Number of the failed attempt, starting from 1.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_recover_bus(mtb_ctp_ft5406_config_t* config, uint32_t attempt)
+{
+    if (((!config->retry_policy.light_recovery) || (1U < attempt)) &&
+        mtb_ctp_ft5406_lock_bus(config, false, config->retry_policy.timeout_us))
+    {
+        Cy_SCB_I2C_Disable(config->i2c_base, config->i2c_context);
+        Cy_SCB_I2C_Enable(config->i2c_base);
+        mtb_ctp_ft5406_unlock_bus(config);
+        STATS_ADD(config, recoveries, 1U);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_i2c_controller_write
+********************************************************************************
+*
+* This function configures the I2C controller to automatically write an entire
+* buffer of data to touch panel controller acting as I2C target. Failed
+* attempts are retried according to the retry policy of the instance.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param write_buff
+* Pointer to the I2C buffer for data to write to the I2C target.
+*
+* \param buff_size
+* Size of the I2C write buffer.
+*
+* \return cy_en_scb_i2c_status_t
+* I2C controller write status
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_i2c_controller_write(mtb_ctp_ft5406_config_t* config,
+                                                           uint8_t* write_buff,
+                                                           uint32_t buff_size)
+{
+    cy_stc_scb_i2c_master_xfer_config_t transfer_config;
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t attempt                  = RESET_VAL;
+    uint32_t backoff_us               = config->retry_policy.backoff_us;
+    uint32_t i2c_controller_stat      = RESET_VAL;
+    uint32_t timeout_us;
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+    uint32_t start;
+#endif
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != write_buff);
+
+    /* I2C controller transfer configuration */
+    transfer_config.slaveAddress      = MTB_CTP_FT5406_I2C_ADDRESS;
+    transfer_config.buffer            = write_buff;
+    transfer_config.bufferSize        = buff_size;
+    /* Generate Stop condition at the end of transaction */
+    transfer_config.xferPending       = false;
+
+    do
+    {
+        if (RESET_VAL != attempt)
+        {
+            backoff_us = mtb_ctp_ft5406_retry_backoff(config, backoff_us);
+        }
+        attempt++;
+
+        if (!mtb_ctp_ft5406_lock_bus(config, false, config->retry_policy.timeout_us))
+        {
+            i2c_status = CY_SCB_I2C_MASTER_NOT_READY;
+            continue;
+        }
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+        start = mtb_ctp_ft5406_stats_time(config);
+#endif
+
+        /* Initiate write transaction */
+        /* The Start condition is generated to begin this transaction */
+        config->xfer_polled = true;
+        i2c_status = Cy_SCB_I2C_MasterWrite(config->i2c_base,
+                                            &transfer_config,
+                                            config->i2c_context);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            STATS_ADD(config, transactions, 1U);
+            timeout_us = config->retry_policy.timeout_us;
+
+            /* Wait until controller complete write transfer or time out has occurred */
+            i2c_controller_stat = Cy_SCB_I2C_MasterGetStatus(config->i2c_base,
+                                                             config->i2c_context);
+            while ((CY_SCB_I2C_MASTER_BUSY & i2c_controller_stat) && timeout_us)
+            {
+                Cy_SysLib_DelayUs(I2C_POLL_DELAY_US);
+                timeout_us -= I2C_POLL_DELAY_US;
+                i2c_controller_stat = Cy_SCB_I2C_MasterGetStatus(config->i2c_base,
+                                                                 config->i2c_context);
+            }
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+            mtb_ctp_ft5406_stats_add_latency(config, config->stats.write_latency, start);
+            mtb_ctp_ft5406_stats_add_errors(config, i2c_controller_stat);
+#endif
+
+            if ((!(I2C_CONTROLLER_ERROR_MASK & i2c_controller_stat)) &&
+                (transfer_config.bufferSize ==
+                 Cy_SCB_I2C_MasterGetTransferCount(config->i2c_base,
+                                                   config->i2c_context)))
+            {
+                STATS_ADD(config, bytes, buff_size);
+                i2c_status = CY_SCB_I2C_SUCCESS;
+            }
+            else
+            {
+                if (0U != (CY_SCB_I2C_MASTER_BUSY & i2c_controller_stat))
+                {
+                    /* End the transfer still in progress */
+                    Cy_SCB_I2C_MasterAbortWrite(config->i2c_base, config->i2c_context);
+                    STATS_ADD(config, timeouts, 1U);
+                    i2c_status = CY_SCB_I2C_MASTER_MANUAL_TIMEOUT;
+                }
+                else
+                {
+                    i2c_status = mtb_ctp_i2c_get_error_status(i2c_controller_stat);
+                }
+            }
+        }
+
+        config->xfer_polled = false;
+        mtb_ctp_ft5406_unlock_bus(config);
+
+        if ((CY_SCB_I2C_SUCCESS != i2c_status) && (CY_SCB_I2C_MASTER_NOT_READY != i2c_status))
+        {
+            /* Timeout/error recovery */
+            mtb_ctp_ft5406_recover_bus(config, attempt);
+        }
+    } while ((CY_SCB_I2C_SUCCESS != i2c_status) &&
+             (attempt < config->retry_policy.max_attempts));
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_wait_read
+********************************************************************************
+*
+* Waits for the completion of the read started on the state machine. A read
+* which does not complete in time is aborted.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* Read status, CY_SCB_I2C_MASTER_MANUAL_TIMEOUT if the read is aborted.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_wait_read(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t timeout_us = config->retry_policy.timeout_us;
+
+    /* Wait until state machine completes the transfer or time out has occurred */
+    while ((MTB_CTP_FT5406_XFER_IDLE != config->xfer_state) && timeout_us)
+    {
+        Cy_SysLib_DelayUs(I2C_POLL_DELAY_US);
+        timeout_us -= I2C_POLL_DELAY_US;
+    }
+
+    /* The read may complete between the last check and the abort */
+    if ((MTB_CTP_FT5406_XFER_IDLE != config->xfer_state) &&
+        mtb_ctp_ft5406_abort_read(config))
+    {
+        i2c_status = CY_SCB_I2C_MASTER_MANUAL_TIMEOUT;
+        STATS_ADD(config, timeouts, 1U);
+    }
+    else
+    {
+        i2c_status = config->xfer_status;
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_read_regs
+********************************************************************************
+*
+* Reads consecutive FT5406 registers in a single repeated Start transaction
+* and waits for its completion. Failed attempts are retried according to the
+* retry policy of the instance.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* Address of the first register.
+*
+* \param read_buff
+* Pointer to the buffer for the register values.
+*
+* \param read_size
+* Number of registers to read.
+*
+* \return cy_en_scb_i2c_status_t
+* Read operation status based on I2C communication.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_regs(mtb_ctp_ft5406_config_t* config,
+                                                       uint8_t reg_addr,
+                                                       uint8_t* read_buff,
+                                                       uint32_t read_size)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t attempt                  = RESET_VAL;
+    uint32_t backoff_us               = config->retry_policy.backoff_us;
+
+    do
+    {
+        if (RESET_VAL != attempt)
+        {
+            backoff_us = mtb_ctp_ft5406_retry_backoff(config, backoff_us);
+        }
+        attempt++;
+
+        i2c_status = mtb_ctp_ft5406_reserve_xfer(config);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            i2c_status = mtb_ctp_ft5406_start_reg_read(config, reg_addr, read_buff, read_size,
+                                                       NULL, NULL,
+                                                       config->retry_policy.timeout_us);
+        }
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            i2c_status = mtb_ctp_ft5406_wait_read(config);
+
+            if (CY_SCB_I2C_SUCCESS != i2c_status)
+            {
+                /* Timeout/error recovery */
+                mtb_ctp_ft5406_recover_bus(config, attempt);
+            }
+        }
+    } while ((CY_SCB_I2C_SUCCESS != i2c_status) &&
+             (attempt < config->retry_policy.max_attempts));
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_claim_bus
+********************************************************************************
+*
+* Reserves the bus of the instance for blocking register writes. Touch reads
+* requested by the INT pin meanwhile are deferred until the bus is released.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* CY_SCB_I2C_MASTER_NOT_READY if a touch read is in progress.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_claim_bus(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (MTB_CTP_FT5406_XFER_IDLE != config->xfer_state)
+    {
+        i2c_status = CY_SCB_I2C_MASTER_NOT_READY;
+    }
+    else
+    {
+        config->xfer_state = MTB_CTP_FT5406_XFER_WRITE_REG;
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_release_bus
+********************************************************************************
+*
+* Releases the bus reserved by mtb_ctp_ft5406_claim_bus() and starts the touch
+* read requested by the INT pin meanwhile.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_release_bus(mtb_ctp_ft5406_config_t* config)
+{
+    config->xfer_state = MTB_CTP_FT5406_XFER_IDLE;
+
+    mtb_ctp_ft5406_bus_released_ex(config);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_write_shadow
+********************************************************************************
+*
+* Writes the changed shadow registers. Changed registers separated only by
+* known host registers are coalesced into one burst write, which rewrites the
+* known registers in between with their current value.
+*
+* \param config
+* Pointer to the FT5406 instance, the bus must be claimed.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the first failed burst write, or success.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_write_shadow(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t burst[1U + MTB_CTP_FT5406_REG_SHADOW_COUNT];
+    uint64_t bridge = config->reg_valid & REG_HOST_MASK;
+    uint64_t burst_mask;
+    uint32_t first = RESET_VAL;
+    uint32_t last;
+    uint32_t end;
+
+    while ((CY_SCB_I2C_SUCCESS == i2c_status) && (0U != config->reg_dirty))
+    {
+        /* Start the burst at the next changed register */
+        while (0U == (config->reg_dirty & ((uint64_t)1U << first)))
+        {
+            first++;
+        }
+
+        /* Extend it over changed and known host registers, end at a changed one */
+        last = first;
+        for (end = first + 1U; end < MTB_CTP_FT5406_REG_SHADOW_COUNT; end++)
+        {
+            if (0U != (config->reg_dirty & ((uint64_t)1U << end)))
+            {
+                last = end;
+            }
+            else if (0U == (bridge & ((uint64_t)1U << end)))
+            {
+                break;
+            }
+            else
+            {
+                /* Known host register, rewritten if the burst continues */
+            }
+        }
+
+        burst[0] = (uint8_t)(MTB_CTP_FT5406_REG_SHADOW_FIRST + first);
+        (void)memcpy(&burst[1], &config->reg_shadow[first], (last - first) + 1U);
+
+        i2c_status = mtb_ctp_i2c_controller_write(config, burst, (last - first) + 2U);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            burst_mask = (((uint64_t)1U << last) << 1U) - ((uint64_t)1U << first);
+            config->reg_dirty &= ~burst_mask;
+            config->reg_valid |= burst_mask;
+            first = last + 1U;
+        }
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_set_reg
+********************************************************************************
+*
+* Stages a register change in the shadow without bus access. Staged changes
+* are written by mtb_ctp_ft5406_flush_regs() or the next
+* mtb_ctp_ft5406_write_reg(). A change to the known value of a register changed
+* by the host only is dropped.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* FT5406 register address, in the shadow window.
+*
+* \param value
+* Register value.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_set_reg(mtb_ctp_ft5406_config_t* config,
+                                   uint8_t reg_addr,
+                                   uint8_t value)
+{
+    uint32_t index   = (uint32_t)reg_addr - MTB_CTP_FT5406_REG_SHADOW_FIRST;
+    uint64_t reg_bit = REG_BIT(reg_addr);
+
+    CY_ASSERT(REG_IN_SHADOW(reg_addr));
+
+    /* Redundant write of a register only the host changes */
+    if ((0U != (config->reg_valid & REG_HOST_MASK & reg_bit)) &&
+        (0U == (config->reg_dirty & reg_bit)) &&
+        (value == config->reg_shadow[index]))
+    {
+        return;
+    }
+
+    config->reg_shadow[index] = value;
+    config->reg_dirty        |= reg_bit;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_flush_regs
+********************************************************************************
+*
+* Writes the staged register changes. Adjacent changes are coalesced into
+* burst writes. Changes which fail to be written are discarded, and their
+* registers are read from the FT5406 again when they are next read, so a
+* failed setter is not written by the next one.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_flush_regs(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    if (0U != config->reg_dirty)
+    {
+        i2c_status = mtb_ctp_ft5406_claim_bus(config);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            i2c_status = mtb_ctp_ft5406_write_shadow(config);
+            mtb_ctp_ft5406_release_bus(config);
+        }
+
+        if (CY_SCB_I2C_SUCCESS != i2c_status)
+        {
+            /* The FT5406 keeps its value of the registers not written */
+            config->reg_valid &= ~config->reg_dirty;
+            config->reg_dirty  = RESET_VAL;
+        }
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_write_reg
+********************************************************************************
+*
+* Writes an FT5406 register. Registers in the shadow window are written
+* through the shadow: the write is skipped if the register is changed by the
+* host only and already holds the value, and staged register changes are
+* written with it. The write is blocking and is retried according to the retry
+* policy. Touch reads requested by the INT pin during the write are started
+* once it completes.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* FT5406 register address.
+*
+* \param value
+* Register value.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_write_reg(mtb_ctp_ft5406_config_t* config,
+                                                       uint8_t reg_addr,
+                                                       uint8_t value)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t write_buff[] = { reg_addr, value };
+
+    if (REG_IN_SHADOW(reg_addr))
+    {
+        mtb_ctp_ft5406_set_reg(config, reg_addr, value);
+        i2c_status = mtb_ctp_ft5406_flush_regs(config);
+    }
+    else
+    {
+        i2c_status = mtb_ctp_ft5406_claim_bus(config);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            i2c_status = mtb_ctp_i2c_controller_write(config, write_buff, sizeof(write_buff));
+            mtb_ctp_ft5406_release_bus(config);
+        }
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_load_regs
+********************************************************************************
+*
+* Makes consecutive shadow registers known. Registers not served by the
+* shadow are read from the FT5406 in a single transaction; staged changes are
+* kept.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param reg_addr
+* Address of the first register, in the shadow window.
+*
+* \param count
+* Number of registers, in the shadow window.
+*
+* \return cy_en_scb_i2c_status_t
+* Register read status.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_load_regs(mtb_ctp_ft5406_config_t* config,
+                                                       uint8_t reg_addr,
+                                                       uint32_t count)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t read_buff[MTB_CTP_FT5406_REG_SHADOW_COUNT];
+    uint32_t first = (uint32_t)reg_addr - MTB_CTP_FT5406_REG_SHADOW_FIRST;
+    uint64_t mask  = ((((uint64_t)1U << (count - 1U)) << 1U) - 1U) << first;
+    uint64_t served;
+    uint32_t i;
+
+    CY_ASSERT(REG_IN_SHADOW(reg_addr) && ((first + count) <= MTB_CTP_FT5406_REG_SHADOW_COUNT));
+
+    /* Identification registers and registers changed by the host only */
+    served = config->reg_dirty | (config->reg_valid & (REG_HOST_MASK | REG_CONST_MASK));
+
+    if (mask != (served & mask))
+    {
+        i2c_status = mtb_ctp_ft5406_read_regs(config, reg_addr, read_buff, count);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            for (i = 0U; i < count; i++)
+            {
+                if (0U == (config->reg_dirty & ((uint64_t)1U << (first + i))))
+                {
+                    config->reg_shadow[first + i] = read_buff[i];
+                }
+            }
+            config->reg_valid |= mask & ~config->reg_dirty;
+        }
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_read_raw_touch_data
+********************************************************************************
+*
+* This function reads the raw x, y coordinate data from the touch panel
+* controller into the touch buffer using a single repeated Start transaction.
+* The transfer is driven by the touch read state machine, this function only
+* waits for its completion. Failed attempts are retried according to the retry
+* policy of the instance.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return cy_en_scb_i2c_status_t
+* Read operation status based on I2C communication.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_raw_touch_data(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t attempt                  = RESET_VAL;
+    uint32_t backoff_us               = config->retry_policy.backoff_us;
+    uint32_t max_attempts             = config->retry_policy.max_attempts;
+
+    CY_ASSERT(NULL != config);
+
+    if (config->retry_policy.serve_last_frame)
+    {
+        /* Fail fast, the last good frame is served instead */
+        max_attempts = 1U;
+    }
+
+    do
+    {
+        if (RESET_VAL != attempt)
+        {
+            backoff_us = mtb_ctp_ft5406_retry_backoff(config, backoff_us);
+        }
+        attempt++;
+
+        i2c_status = mtb_ctp_ft5406_start_touch_read(config, NULL, NULL,
+                                                     config->retry_policy.timeout_us);
+
+        if (CY_SCB_I2C_SUCCESS == i2c_status)
+        {
+            i2c_status = mtb_ctp_ft5406_wait_read(config);
+
+            if (CY_SCB_I2C_SUCCESS != i2c_status)
+            {
+                /* Timeout/error recovery */
+                mtb_ctp_ft5406_recover_bus(config, attempt);
+            }
+        }
+    } while ((CY_SCB_I2C_SUCCESS != i2c_status) && (attempt < max_attempts));
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_get_frame
+********************************************************************************
+*
+* Gets the latest processed touch frame. In event mode, the frame read on the
+* last INT assertion is returned without bus access, otherwise a new frame is
+* read. An INT assertion which could not start its read is served here. The
+* copy is done with interrupts disabled so the frame is never torn by a
+* concurrent read.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_event
+* Pointer to the variable to store the event of the 1st touch point.
+*
+* \param touch_count
+* Pointer to the variable to store the number of touch points.
+*
+* \param touch_array
+* Pointer to the array to store the touch points, can be NULL.
+*
+* \param touch_changes
+* Pointer to the variable to store the frame change counter, can be NULL.
+*
+* \param touch_soa
+* Pointer to the structure-of-arrays output of the touch points, can be NULL.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the touch read which produced the frame. The outputs are updated
+* on success only. If the retry policy serves the last frame, a failed read
+* serves the last good frame with success.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_frame(mtb_ctp_ft5406_config_t* config,
+                                                       mtb_ctp_touch_event_t* touch_event,
+                                                       int* touch_count,
+                                                       mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                                       uint32_t* touch_changes,
+                                                       mtb_ctp_ft5406_touch_soa_t* touch_soa)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint32_t interrupt_state;
+    uint32_t trace_frame;
+    bool int_deferred;
+
+    /* INT assertion which could not start a read, e.g. as the shared bus was locked */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    int_deferred = config->int_pending && (MTB_CTP_FT5406_XFER_IDLE == config->xfer_state);
+    if (int_deferred)
+    {
+        config->int_pending = false;
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if ((NULL == config->int_port) || int_deferred)
+    {
+        i2c_status = mtb_ctp_ft5406_read_raw_touch_data(config);
+    }
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (NULL != config->int_port)
+    {
+        /* Event mode: serve the latest frame without bus access */
+        i2c_status = config->int_status;
+    }
+
+    if (config->retry_policy.serve_last_frame)
+    {
+        /* The snapshot is only updated by successful reads */
+        i2c_status = CY_SCB_I2C_SUCCESS;
+    }
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        *touch_event = config->touch_single_event;
+        *touch_count = config->touch_count;
+
+        if (NULL != touch_array)
+        {
+            (void)memcpy(touch_array, config->touch_array, sizeof(config->touch_array));
+        }
+
+        if (NULL != touch_changes)
+        {
+            *touch_changes = config->touch_changes;
+        }
+
+        if (NULL != touch_soa)
+        {
+            *touch_soa = config->touch_soa;
+        }
+
+    }
+
+    trace_frame = config->trace_frame;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    /* Returns without a critical section if the frame was already picked up */
+    if ((CY_SCB_I2C_SUCCESS == i2c_status) && TRACE_ENABLED(config))
+    {
+        mtb_ctp_ft5406_trace_pickup(config->trace, trace_frame, config->get_timestamp_us());
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_register_instance
+********************************************************************************
+*
+* Registers the instance in a free I2C event callback slot. An instance which
+* is already registered keeps its slot.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return int
+* Index of the callback slot, or -1 if all slots are in use by other instances
+* or another instance is registered on the same I2C bus.
+*
+*******************************************************************************/
+static int mtb_ctp_ft5406_register_instance(mtb_ctp_ft5406_config_t* config)
+{
+    int slot = -1;
+    uint32_t i;
+
+    for (i = 0U; i < MTB_CTP_FT5406_MAX_INSTANCES; i++)
+    {
+        if (config == ft5406_instances[i])
+        {
+            return (int)i;
+        }
+
+        /* One FT5406 per I2C bus: the I2C events of the bus reach one instance only */
+        if ((NULL != ft5406_instances[i]) && (config->i2c_base == ft5406_instances[i]->i2c_base))
+        {
+            return -1;
+        }
+
+        if ((slot < 0) && (NULL == ft5406_instances[i]))
+        {
+            slot = (int)i;
+        }
+    }
+
+    if (slot >= 0)
+    {
+        ft5406_instances[slot] = config;
+    }
+
+    return slot;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_init_ex
+********************************************************************************
+*
+* Performs FT5406 Touch panel controller initialization using I2C interface for
+* the given instance. Each instance must use its own I2C bus and configuration
+* structure, which holds the buffers and the state of the instance.
+*
+* \param config
+* Pointer to the FT5406 configuration structure of the instance.
+*
+* \return cy_en_scb_i2c_status_t
+* Touch panel initialization status based on I2C communication.
+* CY_SCB_I2C_BAD_PARAM is returned if MTB_CTP_FT5406_MAX_INSTANCES instances
+* are already initialized, or if another instance is initialized on the same
+* I2C bus. A failed initialization leaves the instance deinitialized.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_init_ex(mtb_ctp_ft5406_config_t* config)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    uint8_t device_mode[] = { MTB_CTP_FT5406_DEVICE_MODE, MTB_CTP_FT5406_NORMAL_MODE };
+    int slot;
+
+    CY_ASSERT(NULL != config);
+
+    config->xfer_state        = MTB_CTP_FT5406_XFER_IDLE;
+    config->xfer_status       = CY_SCB_I2C_SUCCESS;
+    config->xfer_touch_read   = false;
+    config->xfer_polled       = false;
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    config->xfer_dma_wait     = false;
+#endif
+    config->read_cb           = NULL;
+    config->read_cb_user_data = NULL;
+    config->touch_last_count  = RESET_VAL;
+    config->touch_front       = RESET_VAL;
+    config->touch_back        = 1U;
+    config->touch_held        = TOUCH_BUFF_NONE;
+    config->int_pending       = false;
+    config->int_status        = CY_SCB_I2C_SUCCESS;
+    config->trace_int_valid   = false;
+    config->trace_frame       = RESET_VAL;
+
+    mtb_ctp_ft5406_set_transform_ex(config, config->transform);
+    mtb_ctp_ft5406_set_retry_ex(config, config->retry);
+
+    mtb_ctp_ft5406_init_filter(config);
+
+    /* Register values are unknown until read or written */
+    config->reg_valid         = RESET_VAL;
+    config->reg_dirty         = RESET_VAL;
+
+    /* No touch is reported until the first frame is read */
+    config->touch_single_event = MTB_CTP_TOUCH_RESERVED;
+    config->touch_count        = RESET_VAL;
+    config->touch_gesture_id   = MTB_CTP_FT5406_HW_GESTURE_NONE;
+    (void)memset(config->touch_array, 0, sizeof(config->touch_array));
+    (void)memset(&config->touch_soa, 0, sizeof(config->touch_soa));
+    (void)memset(config->touch_buff, 0, sizeof(config->touch_buff));
+    config->touch_changes          = RESET_VAL;
+    config->touch_reported_changes = RESET_VAL;
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+    (void)memset(&config->stats, 0, sizeof(config->stats));
+#endif
+
+    slot = mtb_ctp_ft5406_register_instance(config);
+    if (slot < 0)
+    {
+        return CY_SCB_I2C_BAD_PARAM;
+    }
+
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    /* Completion of DMA reads is reported through the DataWire channel interrupt */
+    if (NULL != config->dma)
+    {
+        CY_ASSERT(NULL != config->dma->base);
+        CY_ASSERT(NULL != config->dma->descriptor);
+
+        Cy_DMA_Channel_SetInterruptMask(config->dma->base, config->dma->channel,
+                                        CY_DMA_INTR_MASK);
+    }
+#endif
+
+    /* Completion of touch read transfers is reported through the I2C event callback.
+     * The callback of another driver on the same I2C context keeps receiving the
+     * events of its own transfers. */
+    if (ft5406_event_callbacks[slot] != config->i2c_context->cbEvents)
+    {
+        ft5406_chained_callbacks[slot] = config->i2c_context->cbEvents;
+    }
+    Cy_SCB_I2C_RegisterEventCallback(config->i2c_base,
+                                     ft5406_event_callbacks[slot],
+                                     config->i2c_context);
+
+    i2c_status = mtb_ctp_i2c_controller_write(config, device_mode, sizeof(device_mode));
+
+    /* Pulse INT on every touch report instead of holding it while touched */
+    if ((CY_SCB_I2C_SUCCESS == i2c_status) && (NULL != config->int_port))
+    {
+        i2c_status = mtb_ctp_ft5406_write_reg(config, MTB_CTP_FT5406_G_MODE,
+                                              MTB_CTP_FT5406_INT_TRIGGER_MODE);
+    }
+
+    /* A failed initialization does not keep the I2C bus */
+    if (CY_SCB_I2C_SUCCESS != i2c_status)
+    {
+        mtb_ctp_ft5406_deinit_ex(config);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_init
+********************************************************************************
+*
+* Performs FT5406 Touch panel controller initialization using I2C interface.
+* The instance becomes the default instance used by the functions without
+* instance parameter.
+*
+* \param mtb_ft5406_config
+* Pointer to the FT5406 configuration structure.
+*
+* \return cy_en_scb_i2c_status_t
+* Touch panel initialization status based on I2C communication.
+*
+* \func usage
+* \snippet snippet/main.c snippet_mtb_ctp_ft5406_init
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_init(mtb_ctp_ft5406_config_t* mtb_ft5406_config)
+{
+    CY_ASSERT(NULL != mtb_ft5406_config);
+
+    ft5406_config = mtb_ft5406_config;
+
+    return mtb_ctp_ft5406_init_ex(mtb_ft5406_config);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_deinit_ex
+********************************************************************************
+*
+* Releases the given instance: aborts its touch read in progress, restores the
+* I2C event callback registered on the I2C context before the instance, and
+* frees its instance slot, so that the I2C bus can be initialized again, also
+* with another configuration structure. Disable the INT pin and DataWire
+* channel interrupts of the instance before. An instance which is not
+* initialized is left unchanged.
+*
+* \param config
+* Pointer to the FT5406 configuration structure of the instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_deinit_ex(mtb_ctp_ft5406_config_t* config)
+{
+    uint32_t interrupt_state;
+    uint32_t i;
+
+    CY_ASSERT(NULL != config);
+
+    for (i = 0U; i < MTB_CTP_FT5406_MAX_INSTANCES; i++)
+    {
+        if (config == ft5406_instances[i])
+        {
+            (void)mtb_ctp_ft5406_abort_read(config);
+
+            /* The I2C events stop reaching the slot before it is freed */
+            interrupt_state = Cy_SysLib_EnterCriticalSection();
+            Cy_SCB_I2C_RegisterEventCallback(config->i2c_base,
+                                             ft5406_chained_callbacks[i],
+                                             config->i2c_context);
+            ft5406_chained_callbacks[i] = NULL;
+            ft5406_instances[i]         = NULL;
+            Cy_SysLib_ExitCriticalSection(interrupt_state);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_deinit
+********************************************************************************
+*
+* Releases the default instance. See mtb_ctp_ft5406_deinit_ex().
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_deinit(void)
+{
+    mtb_ctp_ft5406_deinit_ex(ft5406_config);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_single_touch_ex
+********************************************************************************
+*
+* Reads single touch event coordinates from the FT5406 touch panel controller
+* of the given instance using I2C interface. In event mode, returns the latest
+* frame read on the INT assertion without accessing the bus.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_event
+* Pointer to the variable for capturing generated touch event.
+*
+* \param touch_x
+* Pointer to the variable for capturing X touch co-ordinate of the generated
+* touch event.
+*
+* \param touch_y
+* Pointer to the variable for capturing Y touch co-ordinate of the generated
+* touch event.
+*
+* \return cy_en_scb_i2c_status_t
+* Single touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_single_touch_ex(mtb_ctp_ft5406_config_t* config,
+                                                          mtb_ctp_touch_event_t* touch_event,
+                                                          int* touch_x,
+                                                          int* touch_y)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = RESET_VAL;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != touch_event);
+    CY_ASSERT(NULL != touch_x);
+    CY_ASSERT(NULL != touch_y);
+
+    /* Reset touch event */
+    *touch_event = MTB_CTP_TOUCH_RESERVED;
+
+    i2c_status = mtb_ctp_ft5406_get_frame(config, touch_event, &touch_count, touch_array,
+                                          NULL, NULL);
+
+    /* Update coordinates only if there is touch detected */
+    if ((CY_SCB_I2C_SUCCESS == i2c_status) && (0 < touch_count) &&
+        ((MTB_CTP_TOUCH_DOWN == *touch_event) || (MTB_CTP_TOUCH_CONTACT == *touch_event)))
+    {
+        *touch_x = touch_array[0].touch_x;
+        *touch_y = touch_array[0].touch_y;
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_single_touch
+********************************************************************************
+*
+* Reads single touch event coordinates from the default FT5406 instance.
+* See mtb_ctp_ft5406_get_single_touch_ex().
+*
+* \param touch_event
+* Pointer to the variable for capturing generated touch event.
+*
+* \param touch_x
+* Pointer to the variable for capturing X touch co-ordinate of the generated
+* touch event.
+*
+* \param touch_y
+* Pointer to the variable for capturing Y touch co-ordinate of the generated
+* touch event.
+*
+* \return cy_en_scb_i2c_status_t
+* Single touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_single_touch(mtb_ctp_touch_event_t* touch_event,
+                                                       int* touch_x,
+                                                       int* touch_y)
+{
+    return mtb_ctp_ft5406_get_single_touch_ex(ft5406_config, touch_event, touch_x, touch_y);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch_ex
+********************************************************************************
+*
+* Reads multi touch event coordinates from the FT5406 touch panel controller
+* of the given instance using I2C interface. In event mode, returns the latest
+* frame read on the INT assertion without accessing the bus.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
+*
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_ex(mtb_ctp_ft5406_config_t* config,
+                                                         int* touch_count,
+                                                         mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    mtb_ctp_touch_event_t touch_event;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != touch_count);
+    CY_ASSERT(NULL != touch_array);
+
+    return mtb_ctp_ft5406_get_frame(config, &touch_event, touch_count, touch_array, NULL,
+                                    NULL);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch
+********************************************************************************
+*
+* Reads multi touch event coordinates from the default FT5406 instance.
+* See mtb_ctp_ft5406_get_multi_touch_ex().
+*
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
+*
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch(int* touch_count,
+                                                      mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    return mtb_ctp_ft5406_get_multi_touch_ex(ft5406_config, touch_count, touch_array);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch_changed_ex
+********************************************************************************
+*
+* Reads multi touch event coordinates like mtb_ctp_ft5406_get_multi_touch_ex()
+* and reports whether the touch points changed since the previous call of this
+* function. Frames are compared after the coordinate transform and the jitter
+* filter, so a resting finger reports no change once the filter holds it.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
+*
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
+*
+* \param changed
+* Pointer to the variable set to true if the touch points changed.
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_changed_ex(mtb_ctp_ft5406_config_t* config,
+                                                                 int* touch_count,
+                                                                 mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                                                 bool* changed)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+    mtb_ctp_touch_event_t touch_event;
+    uint32_t touch_changes = RESET_VAL;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != touch_count);
+    CY_ASSERT(NULL != touch_array);
+    CY_ASSERT(NULL != changed);
+
+    *changed = false;
+
+    i2c_status = mtb_ctp_ft5406_get_frame(config, &touch_event, touch_count, touch_array,
+                                          &touch_changes, NULL);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        *changed = (touch_changes != config->touch_reported_changes);
+        config->touch_reported_changes = touch_changes;
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch_changed
+********************************************************************************
+*
+* Reads multi touch event coordinates from the default FT5406 instance and
+* reports whether they changed. See mtb_ctp_ft5406_get_multi_touch_changed_ex().
+*
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
+*
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
+*
+* \param changed
+* Pointer to the variable set to true if the touch points changed.
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_changed(int* touch_count,
+                                                              mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                                              bool* changed)
+{
+    return mtb_ctp_ft5406_get_multi_touch_changed_ex(ft5406_config, touch_count, touch_array,
+                                                     changed);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch_soa_ex
+********************************************************************************
+*
+* Reads multi touch event coordinates from the FT5406 touch panel controller
+* of the given instance into a structure-of-arrays output. Each coordinate
+* and attribute is stored in its own contiguous array, so consumers that
+* process one field of all touch points do not stride over the other fields.
+* In event mode, returns the latest frame read on the INT assertion without
+* accessing the bus.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_soa
+* Pointer to the structure-of-arrays touch output.
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_soa_ex(mtb_ctp_ft5406_config_t* config,
+                                                             mtb_ctp_ft5406_touch_soa_t* touch_soa)
+{
+    mtb_ctp_touch_event_t touch_event;
+    int touch_count = RESET_VAL;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != touch_soa);
+
+    /* The structure-of-arrays frame is written by the decode pipeline */
+    return mtb_ctp_ft5406_get_frame(config, &touch_event, &touch_count, NULL, NULL, touch_soa);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_multi_touch_soa
+********************************************************************************
+*
+* Reads multi touch event coordinates from the default FT5406 instance into a
+* structure-of-arrays output. See mtb_ctp_ft5406_get_multi_touch_soa_ex().
+*
+* \param touch_soa
+* Pointer to the structure-of-arrays touch output.
+*
+* \return cy_en_scb_i2c_status_t
+* Multi touch read operation status based on I2C communication.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_soa(mtb_ctp_ft5406_touch_soa_t* touch_soa)
+{
+    return mtb_ctp_ft5406_get_multi_touch_soa_ex(ft5406_config, touch_soa);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_gesture_id_ex
+********************************************************************************
+*
+* Returns the hardware gesture ID reported by the FT5406 in the latest touch
+* frame of the given instance. No bus access is performed.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return uint8_t
+* Hardware gesture ID, MTB_CTP_FT5406_HW_GESTURE_NONE if no gesture is detected.
+*
+*******************************************************************************/
+uint8_t mtb_ctp_ft5406_get_gesture_id_ex(const mtb_ctp_ft5406_config_t* config)
+{
+    CY_ASSERT(NULL != config);
+
+    return config->touch_gesture_id;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_gesture_id
+********************************************************************************
+*
+* Returns the hardware gesture ID of the default FT5406 instance.
+* See mtb_ctp_ft5406_get_gesture_id_ex().
+*
+* \return uint8_t
+* Hardware gesture ID, MTB_CTP_FT5406_HW_GESTURE_NONE if no gesture is detected.
+*
+*******************************************************************************/
+uint8_t mtb_ctp_ft5406_get_gesture_id(void)
+{
+    return mtb_ctp_ft5406_get_gesture_id_ex(ft5406_config);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_acquire_view_ex
+********************************************************************************
+*
+* Acquires a read-only view of the latest complete touch frame of the given
+* instance without copying it. The touch points are decoded on access by the
+* mtb_ctp_ft5406_view_get_*() functions, with the coordinate transform but
+* without the jitter filter. No bus access is performed: the frame is the one
+* of the latest successful touch read, an empty frame before the first one.
+* Touch reads land in the other touch buffers until the view is released with
+* mtb_ctp_ft5406_release_view(). One view per instance can be held at a time.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param view
+* Pointer to the view to initialize.
+*
+* \return bool
+* True on success, false if a view of the instance is already held.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_acquire_view_ex(mtb_ctp_ft5406_config_t* config,
+                                    mtb_ctp_ft5406_view_t* view)
+{
+    const mtb_ctp_ft5406_touch_data_t* touch_data = NULL;
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != view);
+
+    /* Pin the front buffer, the read completion cannot switch it meanwhile */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    if (TOUCH_BUFF_NONE == config->touch_held)
+    {
+        config->touch_held = config->touch_front;
+        touch_data = (const mtb_ctp_ft5406_touch_data_t*)(const void*)
+                     config->touch_buff[config->touch_held];
+
+        if (TRACE_ENABLED(config))
+        {
+            mtb_ctp_ft5406_trace_pickup(config->trace, config->trace_frame,
+                                        config->get_timestamp_us());
+        }
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (NULL == touch_data)
+    {
+        return false;
+    }
+
+    view->config      = config;
+    view->touch_data  = touch_data;
+    view->touch_count = mtb_ctp_ft5406_get_touch_count(touch_data);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_acquire_view
+********************************************************************************
+*
+* Acquires a read-only view of the latest complete touch frame of the default
+* FT5406 instance. See mtb_ctp_ft5406_acquire_view_ex().
+*
+* \param view
+* Pointer to the view to initialize.
+*
+* \return bool
+* True on success, false if a view is already held.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_acquire_view(mtb_ctp_ft5406_view_t* view)
+{
+    return mtb_ctp_ft5406_acquire_view_ex(ft5406_config, view);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_release_view
+********************************************************************************
+*
+* Releases a view acquired by mtb_ctp_ft5406_acquire_view(). The touch data of
+* the view must not be accessed afterwards.
+*
+* \param view
+* Pointer to the acquired view.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_release_view(mtb_ctp_ft5406_view_t* view)
+{
+    CY_ASSERT(NULL != view);
+    CY_ASSERT(NULL != view->config);
+
+    /* Single byte store, the read start sees either the held or no buffer */
+    view->config->touch_held = TOUCH_BUFF_NONE;
+    view->touch_data         = NULL;
+    view->touch_count        = RESET_VAL;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_pop_frame_ex
+********************************************************************************
+*
+* Retrieves the oldest frame from the frame ring of the given instance with
+* mtb_ctp_ft5406_frame_ring_pop() and, if the instance has a latency trace,
+* records the pickup of the frame. The ring pop itself neither locks nor
+* disables interrupts; recording the pickup takes a short critical section.
+*
+* \param config
+* Pointer to the FT5406 instance, with a frame ring.
+*
+* \param frame
+* Pointer to the variable to store the frame.
+*
+* \return bool
+* True if a frame is retrieved, false if the ring is empty.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_pop_frame_ex(mtb_ctp_ft5406_config_t* config,
+                                 mtb_ctp_ft5406_frame_t* frame)
+{
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != config->frame_ring);
+
+    if (!mtb_ctp_ft5406_frame_ring_pop(config->frame_ring, frame))
+    {
+        return false;
+    }
+
+    if (TRACE_ENABLED(config))
+    {
+        mtb_ctp_ft5406_trace_pickup(config->trace, frame->trace_frame,
+                                    config->get_timestamp_us());
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_pop_frame
+********************************************************************************
+*
+* Retrieves the oldest frame from the frame ring of the default FT5406
+* instance. See mtb_ctp_ft5406_pop_frame_ex().
+*
+* \param frame
+* Pointer to the variable to store the frame.
+*
+* \return bool
+* True if a frame is retrieved, false if the ring is empty.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_pop_frame(mtb_ctp_ft5406_frame_t* frame)
+{
+    return mtb_ctp_ft5406_pop_frame_ex(ft5406_config, frame);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_view_get_event
+********************************************************************************
+*
+* Decodes the event of a touch point of the view.
+*
+* \param view
+* Pointer to the acquired view.
+*
+* \param index
+* Touch point index, less than the touch count of the view.
+*
+* \return mtb_ctp_touch_event_t
+* Event of the touch point.
+*
+*******************************************************************************/
+mtb_ctp_touch_event_t mtb_ctp_ft5406_view_get_event(const mtb_ctp_ft5406_view_t* view,
+                                                    uint32_t index)
+{
+    CY_ASSERT(NULL != view);
+    CY_ASSERT(index < view->touch_count);
+
+    return TOUCH_POINT_GET_EVENT(view->touch_data->touch_points[index]);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_view_get_id
+********************************************************************************
+*
+* Decodes the ID of a touch point of the view.
+*
+* \param view
+* Pointer to the acquired view.
+*
+* \param index
+* Touch point index, less than the touch count of the view.
+*
+* \return uint8_t
+* ID of the touch point.
+*
+*******************************************************************************/
+uint8_t mtb_ctp_ft5406_view_get_id(const mtb_ctp_ft5406_view_t* view, uint32_t index)
+{
+    CY_ASSERT(NULL != view);
+    CY_ASSERT(index < view->touch_count);
+
+    return (uint8_t)(view->touch_data->touch_points[index].YH >> 4U);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_view_get_position
+********************************************************************************
+*
+* Decodes the coordinates of a touch point of the view and applies the
+* coordinate transform of the instance.
+*
+* \param view
+* Pointer to the acquired view.
+*
+* \param index
+* Touch point index, less than the touch count of the view.
+*
+* \param touch_x
+* Pointer to the variable to store the X coordinate.
+*
+* \param touch_y
+* Pointer to the variable to store the Y coordinate.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_view_get_position(const mtb_ctp_ft5406_view_t* view,
+                                      uint32_t index,
+                                      uint16_t* touch_x,
+                                      uint16_t* touch_y)
+{
+    const mtb_ctp_ft5406_touch_point_t* point;
+
+    CY_ASSERT(NULL != view);
+    CY_ASSERT(index < view->touch_count);
+    CY_ASSERT((NULL != touch_x) && (NULL != touch_y));
+
+    point    = &view->touch_data->touch_points[index];
+    *touch_x = (uint16_t)(((uint16_t)(point->XH & 0x0fU) << 8U) | point->XL);
+    *touch_y = (uint16_t)(((uint16_t)(point->YH & 0x0fU) << 8U) | point->YL);
+    mtb_ctp_ft5406_transform_point(view->config, touch_x, touch_y);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_set_coefficient
+********************************************************************************
+*
+* Stores a Q16.16 transform coefficient computed in 64 bits.
+*
+* \param coefficient
+* Pointer to the coefficient.
+*
+* \param value
+* Coefficient value.
+*
+* \return bool
+* True if the value fits the coefficient, false otherwise.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_set_coefficient(int32_t* coefficient, int64_t value)
+{
+    if ((value < (int64_t)INT32_MIN) || (value > (int64_t)INT32_MAX))
+    {
+        return false;
+    }
+
+    *coefficient = (int32_t)value;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_transform_ex
+********************************************************************************
+*
+* Sets the coordinate transform applied to all touch points of the given
+* instance. Rotation, mirroring and scaling are folded into a single affine
+* matrix here, so each decoded point only costs two multiply-accumulates per
+* coordinate. Called by mtb_ctp_ft5406_init_ex() with the transform of the
+* configuration structure.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param transform
+* Pointer to the transform settings, NULL for panel coordinates. Without a
+* calibration matrix, a transform with a zero panel width or height, or with
+* a scaled matrix exceeding the Q16.16 coefficients (a display size 32768
+* times the panel size or more, or a scaled offset of 32768 display counts or
+* more), is ignored and panel coordinates are reported.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_set_transform_ex(mtb_ctp_ft5406_config_t* config,
+                                     const mtb_ctp_ft5406_transform_t* transform)
+{
+    mtb_ctp_ft5406_affine_t matrix = { 0, 0, 0, 0, 0, 0 };
+    uint16_t max_x = UINT16_MAX;
+    uint16_t max_y = UINT16_MAX;
+    int32_t width;
+    int32_t height;
+    int64_t scale_x = (int64_t)1 << TRANSFORM_SHIFT;
+    int64_t scale_y = (int64_t)1 << TRANSFORM_SHIFT;
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+
+    if ((NULL != transform) && (NULL == transform->calibration) &&
+        ((0U == transform->panel_width) || (0U == transform->panel_height)))
+    {
+        /* Rotation and scaling need the panel size, keep panel coordinates */
+        transform = NULL;
+    }
+
+    if ((NULL != transform) && (NULL != transform->calibration))
+    {
+        matrix = *transform->calibration;
+    }
+    else if (NULL != transform)
+    {
+        width  = (int32_t)transform->panel_width;
+        height = (int32_t)transform->panel_height;
+
+        /* Rotation and mirroring with unit coefficients */
+        switch (transform->rotation)
+        {
+            case MTB_CTP_FT5406_ROTATE_90:
+                matrix.b = -1;
+                matrix.c = height - 1;
+                matrix.d = 1;
+                width    = (int32_t)transform->panel_height;
+                height   = (int32_t)transform->panel_width;
+                break;
+
+            case MTB_CTP_FT5406_ROTATE_180:
+                matrix.a = -1;
+                matrix.c = width - 1;
+                matrix.e = -1;
+                matrix.f = height - 1;
+                break;
+
+            case MTB_CTP_FT5406_ROTATE_270:
+                matrix.b = 1;
+                matrix.d = -1;
+                matrix.f = width - 1;
+                width    = (int32_t)transform->panel_height;
+                height   = (int32_t)transform->panel_width;
+                break;
+
+            default:
+                matrix.a = 1;
+                matrix.e = 1;
+                break;
+        }
+
+        if (transform->mirror_x)
+        {
+            matrix.a = -matrix.a;
+            matrix.b = -matrix.b;
+            matrix.c = (width - 1) - matrix.c;
+        }
+        if (transform->mirror_y)
+        {
+            matrix.d = -matrix.d;
+            matrix.e = -matrix.e;
+            matrix.f = (height - 1) - matrix.f;
+        }
+
+        /* Panel to display scaling */
+        if ((0U != transform->display_width) && (0U != transform->display_height))
+        {
+            scale_x = ((int64_t)transform->display_width << TRANSFORM_SHIFT) / width;
+            scale_y = ((int64_t)transform->display_height << TRANSFORM_SHIFT) / height;
+        }
+        else
+        {
+            max_x = (uint16_t)(width - 1);
+            max_y = (uint16_t)(height - 1);
+        }
+
+        if (!(mtb_ctp_ft5406_set_coefficient(&matrix.a, (int64_t)matrix.a * scale_x) &&
+              mtb_ctp_ft5406_set_coefficient(&matrix.b, (int64_t)matrix.b * scale_x) &&
+              mtb_ctp_ft5406_set_coefficient(&matrix.c, (int64_t)matrix.c * scale_x) &&
+              mtb_ctp_ft5406_set_coefficient(&matrix.d, (int64_t)matrix.d * scale_y) &&
+              mtb_ctp_ft5406_set_coefficient(&matrix.e, (int64_t)matrix.e * scale_y) &&
+              mtb_ctp_ft5406_set_coefficient(&matrix.f, (int64_t)matrix.f * scale_y)))
+        {
+            /* The scaled matrix does not fit, keep panel coordinates */
+            transform = NULL;
+            (void)memset(&matrix, 0, sizeof(matrix));
+            max_x = UINT16_MAX;
+            max_y = UINT16_MAX;
+        }
+    }
+    else
+    {
+        /* No transform */
+    }
+
+    if ((NULL != transform) && (0U != transform->display_width) &&
+        (0U != transform->display_height))
+    {
+        max_x = transform->display_width - 1U;
+        max_y = transform->display_height - 1U;
+    }
+
+    /* Touch points are decoded from the I2C interrupt too */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    config->transform         = transform;
+    config->transform_enabled = (NULL != transform);
+    config->transform_matrix  = matrix;
+    config->transform_max_x   = max_x;
+    config->transform_max_y   = max_y;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_transform
+********************************************************************************
+*
+* Sets the coordinate transform of the default FT5406 instance.
+* See mtb_ctp_ft5406_set_transform_ex().
+*
+* \param transform
+* Pointer to the transform settings, NULL for panel coordinates.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_set_transform(const mtb_ctp_ft5406_transform_t* transform)
+{
+    mtb_ctp_ft5406_set_transform_ex(ft5406_config, transform);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_retry_ex
+********************************************************************************
+*
+* Sets the bus error handling of blocking transfers of the given instance.
+* Zero members of the policy select the default value. The timeout is rounded
+* up to the polling interval.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param retry
+* Pointer to the retry policy, NULL for the defaults.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_set_retry_ex(mtb_ctp_ft5406_config_t* config,
+                                 const mtb_ctp_ft5406_retry_t* retry)
+{
+    static const mtb_ctp_ft5406_retry_t default_retry = { 0U };
+    mtb_ctp_ft5406_retry_t policy;
+
+    CY_ASSERT(NULL != config);
+
+    policy = (NULL != retry) ? *retry : default_retry;
+
+    if (0U == policy.max_attempts)
+    {
+        policy.max_attempts = RETRY_COUNT;
+    }
+
+    if (0U == policy.timeout_us)
+    {
+        policy.timeout_us = I2C_TIMEOUT_US;
+    }
+
+    /* The completion is polled in whole intervals, rounded up without overflow */
+    if (policy.timeout_us > I2C_TIMEOUT_MAX_US)
+    {
+        policy.timeout_us = I2C_TIMEOUT_MAX_US;
+    }
+    else if (0U != (policy.timeout_us % I2C_POLL_DELAY_US))
+    {
+        policy.timeout_us += I2C_POLL_DELAY_US - (policy.timeout_us % I2C_POLL_DELAY_US);
+    }
+    else
+    {
+        /* Whole number of intervals */
+    }
+
+    config->retry_policy = policy;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_retry
+********************************************************************************
+*
+* Sets the bus error handling of the default FT5406 instance.
+* See mtb_ctp_ft5406_set_retry_ex().
+*
+* \param retry
+* Pointer to the retry policy, NULL for the defaults.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_set_retry(const mtb_ctp_ft5406_retry_t* retry)
+{
+    mtb_ctp_ft5406_set_retry_ex(ft5406_config, retry);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_tuning_ex
+********************************************************************************
+*
+* Writes the touch detection settings of the given instance. The registers are
+* written through the register shadow: registers already holding the value are
+* skipped and the changed registers are coalesced into burst writes.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param tuning
+* Pointer to the touch detection settings.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress; the settings are then not written.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_tuning_ex(mtb_ctp_ft5406_config_t* config,
+                                                    const mtb_ctp_ft5406_tuning_t* tuning)
+{
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != tuning);
+
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_THGROUP, tuning->threshold);
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_THPEAK, tuning->peak_threshold);
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_THCAL, tuning->focus_threshold);
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_THDIFF, tuning->filter_threshold);
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_PERIOD_ACTIVE, tuning->active_period);
+    mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_PERIOD_MONITOR, tuning->monitor_period);
+
+    return mtb_ctp_ft5406_flush_regs(config);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_tuning
+********************************************************************************
+*
+* Writes the touch detection settings of the default instance.
+* See mtb_ctp_ft5406_set_tuning_ex().
+*
+* \param tuning
+* Pointer to the touch detection settings.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_tuning(const mtb_ctp_ft5406_tuning_t* tuning)
+{
+    return mtb_ctp_ft5406_set_tuning_ex(ft5406_config, tuning);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_tuning_ex
+********************************************************************************
+*
+* Reads the touch detection settings of the given instance. The settings are
+* read from the FT5406 in one transaction the first time and are served from
+* the register shadow afterwards.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param tuning
+* Pointer to the structure to store the touch detection settings.
+*
+* \return cy_en_scb_i2c_status_t
+* Register read status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_tuning_ex(mtb_ctp_ft5406_config_t* config,
+                                                    mtb_ctp_ft5406_tuning_t* tuning)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != tuning);
+
+    i2c_status = mtb_ctp_ft5406_load_regs(config, MTB_CTP_FT5406_G_THGROUP,
+                                          (MTB_CTP_FT5406_G_PERIOD_MONITOR -
+                                           MTB_CTP_FT5406_G_THGROUP) + 1U);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        tuning->threshold        = REG_SHADOW(config, MTB_CTP_FT5406_G_THGROUP);
+        tuning->peak_threshold   = REG_SHADOW(config, MTB_CTP_FT5406_G_THPEAK);
+        tuning->focus_threshold  = REG_SHADOW(config, MTB_CTP_FT5406_G_THCAL);
+        tuning->filter_threshold = REG_SHADOW(config, MTB_CTP_FT5406_G_THDIFF);
+        tuning->active_period    = REG_SHADOW(config, MTB_CTP_FT5406_G_PERIOD_ACTIVE);
+        tuning->monitor_period   = REG_SHADOW(config, MTB_CTP_FT5406_G_PERIOD_MONITOR);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_tuning
+********************************************************************************
+*
+* Reads the touch detection settings of the default instance.
+* See mtb_ctp_ft5406_get_tuning_ex().
+*
+* \param tuning
+* Pointer to the structure to store the touch detection settings.
+*
+* \return cy_en_scb_i2c_status_t
+* Register read status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_tuning(mtb_ctp_ft5406_tuning_t* tuning)
+{
+    return mtb_ctp_ft5406_get_tuning_ex(ft5406_config, tuning);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_threshold_ex
+********************************************************************************
+*
+* Sets the touch detection threshold (G_THGROUP) of the given instance. The
+* write is skipped if the FT5406 already holds the value.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param threshold
+* Touch detection threshold.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_threshold_ex(mtb_ctp_ft5406_config_t* config,
+                                                       uint8_t threshold)
+{
+    CY_ASSERT(NULL != config);
+
+    return mtb_ctp_ft5406_write_reg(config, MTB_CTP_FT5406_G_THGROUP, threshold);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_threshold
+********************************************************************************
+*
+* Sets the touch detection threshold of the default instance.
+* See mtb_ctp_ft5406_set_threshold_ex().
+*
+* \param threshold
+* Touch detection threshold.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_threshold(uint8_t threshold)
+{
+    return mtb_ctp_ft5406_set_threshold_ex(ft5406_config, threshold);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_report_period_ex
+********************************************************************************
+*
+* Sets the report period in Active mode (G_PERIOD_ACTIVE) of the given
+* instance. The write is skipped if the FT5406 already holds the value.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param period
+* Report period in Active mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_report_period_ex(mtb_ctp_ft5406_config_t* config,
+                                                           uint8_t period)
+{
+    CY_ASSERT(NULL != config);
+
+    return mtb_ctp_ft5406_write_reg(config, MTB_CTP_FT5406_G_PERIOD_ACTIVE, period);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_report_period
+********************************************************************************
+*
+* Sets the report period in Active mode of the default instance.
+* See mtb_ctp_ft5406_set_report_period_ex().
+*
+* \param period
+* Report period in Active mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_report_period(uint8_t period)
+{
+    return mtb_ctp_ft5406_set_report_period_ex(ft5406_config, period);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_monitor_period_ex
+********************************************************************************
+*
+* Sets the report period in Monitor mode (G_PERIOD_MONITOR) of the given
+* instance. The write is skipped if the FT5406 already holds the value.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param period
+* Report period in Monitor mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_monitor_period_ex(mtb_ctp_ft5406_config_t* config,
+                                                            uint8_t period)
+{
+    CY_ASSERT(NULL != config);
+
+    return mtb_ctp_ft5406_write_reg(config, MTB_CTP_FT5406_G_PERIOD_MONITOR, period);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_monitor_period
+********************************************************************************
+*
+* Sets the report period in Monitor mode of the default instance.
+* See mtb_ctp_ft5406_set_monitor_period_ex().
+*
+* \param period
+* Report period in Monitor mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_monitor_period(uint8_t period)
+{
+    return mtb_ctp_ft5406_set_monitor_period_ex(ft5406_config, period);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_power_mode_ex
+********************************************************************************
+*
+* Sets the power mode (G_PMODE) of the given instance. The FT5406 leaves
+* Monitor mode by itself when touched, so the power mode is always written.
+* The FT5406 does not respond in Hibernate mode until it is reset.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param power_mode
+* MTB_CTP_FT5406_PMODE_ACTIVE, MTB_CTP_FT5406_PMODE_MONITOR, or
+* MTB_CTP_FT5406_PMODE_HIBERNATE.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_power_mode_ex(mtb_ctp_ft5406_config_t* config,
+                                                        uint8_t power_mode)
+{
+    CY_ASSERT(NULL != config);
+
+    return mtb_ctp_ft5406_write_reg(config, MTB_CTP_FT5406_G_PMODE, power_mode);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_power_mode
+********************************************************************************
+*
+* Sets the power mode of the default instance.
+* See mtb_ctp_ft5406_set_power_mode_ex().
+*
+* \param power_mode
+* MTB_CTP_FT5406_PMODE_ACTIVE, MTB_CTP_FT5406_PMODE_MONITOR, or
+* MTB_CTP_FT5406_PMODE_HIBERNATE.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_power_mode(uint8_t power_mode)
+{
+    return mtb_ctp_ft5406_set_power_mode_ex(ft5406_config, power_mode);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_auto_monitor_ex
+********************************************************************************
+*
+* Sets the automatic switch to Monitor mode (G_CTRL, G_TIME_ENTER_MONITOR) of
+* the given instance. Both registers are written in one burst write.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param enter_after_s
+* Seconds without touch after which the FT5406 enters Monitor mode, 0 to keep
+* the FT5406 in Active mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status. CY_SCB_I2C_MASTER_NOT_READY is returned if a touch
+* read is in progress.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_auto_monitor_ex(mtb_ctp_ft5406_config_t* config,
+                                                          uint8_t enter_after_s)
+{
+    CY_ASSERT(NULL != config);
+
+    if (0U != enter_after_s)
+    {
+        mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_TIME_ENTER_MONITOR, enter_after_s);
+        mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_CTRL, MTB_CTP_FT5406_CTRL_AUTO_MONITOR);
+    }
+    else
+    {
+        mtb_ctp_ft5406_set_reg(config, MTB_CTP_FT5406_G_CTRL, MTB_CTP_FT5406_CTRL_KEEP_ACTIVE);
+    }
+
+    return mtb_ctp_ft5406_flush_regs(config);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_set_auto_monitor
+********************************************************************************
+*
+* Sets the automatic switch to Monitor mode of the default instance.
+* See mtb_ctp_ft5406_set_auto_monitor_ex().
+*
+* \param enter_after_s
+* Seconds without touch after which the FT5406 enters Monitor mode, 0 to keep
+* the FT5406 in Active mode.
+*
+* \return cy_en_scb_i2c_status_t
+* Register write status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_auto_monitor(uint8_t enter_after_s)
+{
+    return mtb_ctp_ft5406_set_auto_monitor_ex(ft5406_config, enter_after_s);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_firmware_id_ex
+********************************************************************************
+*
+* Reads the firmware version (G_FIRMID) of the given instance. The register is
+* read from the FT5406 the first time and is served from the register shadow
+* afterwards.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param firmware_id
+* Pointer to the variable to store the firmware version.
+*
+* \return cy_en_scb_i2c_status_t
+* Register read status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_firmware_id_ex(mtb_ctp_ft5406_config_t* config,
+                                                         uint8_t* firmware_id)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != firmware_id);
+
+    i2c_status = mtb_ctp_ft5406_load_regs(config, MTB_CTP_FT5406_G_FIRMID, 1U);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        *firmware_id = REG_SHADOW(config, MTB_CTP_FT5406_G_FIRMID);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_firmware_id
+********************************************************************************
+*
+* Reads the firmware version of the default instance.
+* See mtb_ctp_ft5406_get_firmware_id_ex().
+*
+* \param firmware_id
+* Pointer to the variable to store the firmware version.
+*
+* \return cy_en_scb_i2c_status_t
+* Register read status.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_firmware_id(uint8_t* firmware_id)
+{
+    return mtb_ctp_ft5406_get_firmware_id_ex(ft5406_config, firmware_id);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_calibrate
+********************************************************************************
+*
+* Computes the calibration matrix which maps three touch points in panel
+* coordinates onto the three display points the user touched. The panel
+* points must be read without transform. The matrix covers rotation,
+* mirroring and scaling of the panel.
+*
+* \param panel_points
+* Touch points in panel coordinates.
+*
+* \param display_points
+* Display coordinates of the calibration targets.
+*
+* \param calibration
+* Pointer to the variable to store the calibration matrix.
+*
+* \return bool
+* True on success, false if the panel points are on one line or the matrix
+* exceeds the Q16.16 coefficients.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_calibrate(const mtb_ctp_ft5406_point_t panel_points[3],
+                              const mtb_ctp_ft5406_point_t display_points[3],
+                              mtb_ctp_ft5406_affine_t* calibration)
+{
+    int64_t x0 = (int64_t)panel_points[0].x - panel_points[2].x;
+    int64_t y0 = (int64_t)panel_points[0].y - panel_points[2].y;
+    int64_t x1 = (int64_t)panel_points[1].x - panel_points[2].x;
+    int64_t y1 = (int64_t)panel_points[1].y - panel_points[2].y;
+    int64_t dx0 = (int64_t)display_points[0].x - display_points[2].x;
+    int64_t dy0 = (int64_t)display_points[0].y - display_points[2].y;
+    int64_t dx1 = (int64_t)display_points[1].x - display_points[2].x;
+    int64_t dy1 = (int64_t)display_points[1].y - display_points[2].y;
+    int64_t det = (x0 * y1) - (x1 * y0);
+    int64_t a;
+    int64_t b;
+    int64_t d;
+    int64_t e;
+
+    CY_ASSERT(NULL != panel_points);
+    CY_ASSERT(NULL != display_points);
+    CY_ASSERT(NULL != calibration);
+
+    if (0 == det)
+    {
+        return false;
+    }
+
+    a = (((dx0 * y1) - (dx1 * y0)) * ((int64_t)1 << TRANSFORM_SHIFT)) / det;
+    b = (((x0 * dx1) - (x1 * dx0)) * ((int64_t)1 << TRANSFORM_SHIFT)) / det;
+    d = (((dy0 * y1) - (dy1 * y0)) * ((int64_t)1 << TRANSFORM_SHIFT)) / det;
+    e = (((x0 * dy1) - (x1 * dy0)) * ((int64_t)1 << TRANSFORM_SHIFT)) / det;
+
+    return mtb_ctp_ft5406_set_coefficient(&calibration->a, a) &&
+           mtb_ctp_ft5406_set_coefficient(&calibration->b, b) &&
+           mtb_ctp_ft5406_set_coefficient(&calibration->c,
+                                          ((int64_t)display_points[2].x * ((int64_t)1 << TRANSFORM_SHIFT)) -
+                                          (a * panel_points[2].x) - (b * panel_points[2].y)) &&
+           mtb_ctp_ft5406_set_coefficient(&calibration->d, d) &&
+           mtb_ctp_ft5406_set_coefficient(&calibration->e, e) &&
+           mtb_ctp_ft5406_set_coefficient(&calibration->f,
+                                          ((int64_t)display_points[2].y * ((int64_t)1 << TRANSFORM_SHIFT)) -
+                                          (d * panel_points[2].x) - (e * panel_points[2].y));
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_decode_touch_data_ex
+********************************************************************************
+*
+* Decodes raw touch data through the multi touch decode path of the given
+* instance without accessing the bus, e.g. to replay captured touch frames.
+* The jitter filter runs on the given filter state, so decoding does not
+* interfere with the touch reads of the instance.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param touch_data
+* Pointer to the raw touch data of MTB_CTP_FT5406_TOUCH_DATA_LEN bytes.
+*
+* \param touch_count
+* Pointer to the variable holding multi touch counts.
+*
+* \param touch_array
+* Pointer to the array for storing touch data for each detected touch point(s).
+*
+* \param filter_states
+* Pointer to the jitter filter state kept between the decoded frames,
+* zero-initialized before the first frame. NULL to skip the jitter filter.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_decode_touch_data_ex(mtb_ctp_ft5406_config_t* config,
+                                         const uint8_t* touch_data,
+                                         int* touch_count,
+                                         mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                         mtb_ctp_ft5406_filter_states_t* filter_states)
+{
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != touch_data);
+    CY_ASSERT(NULL != touch_count);
+    CY_ASSERT(NULL != touch_array);
+
+    mtb_ctp_ft5406_decode_multi_touch(config, touch_data, touch_count, touch_array);
+
+    if (NULL != filter_states)
+    {
+        mtb_ctp_ft5406_filter_points(config, filter_states, *touch_count, touch_array);
+    }
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_read_async_ex
+********************************************************************************
+*
+* Starts a non-blocking multi touch read from the FT5406 touch panel controller
+* of the given instance and returns immediately. The transfer is advanced by
+* the SCB I2C interrupt, and the decoded touch points are delivered to the
+* callback on completion. The retry policy does not apply: a failed read is
+* reported to the callback and not retried.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param read_cb
+* Callback to be invoked from the SCB I2C interrupt context on completion.
+* The touch array passed to the callback is valid until the next read starts.
+*
+* \param user_data
+* User data to be passed to the callback.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the transfer start. CY_SCB_I2C_MASTER_NOT_READY is returned if
+* another touch read is in progress or the shared bus is locked.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_async_ex(mtb_ctp_ft5406_config_t* config,
+                                                    mtb_ctp_ft5406_read_cb_t read_cb,
+                                                    void* user_data)
+{
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != read_cb);
+
+    return mtb_ctp_ft5406_start_touch_read(config, read_cb, user_data, 0U);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_read_async
+********************************************************************************
+*
+* Starts a non-blocking multi touch read from the default FT5406 instance.
+* See mtb_ctp_ft5406_read_async_ex().
+*
+* \param read_cb
+* Callback to be invoked from the SCB I2C interrupt context on completion.
+*
+* \param user_data
+* User data to be passed to the callback.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the transfer start.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_async(mtb_ctp_ft5406_read_cb_t read_cb, void* user_data)
+{
+    return mtb_ctp_ft5406_read_async_ex(ft5406_config, read_cb, user_data);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_is_busy_ex
+********************************************************************************
+*
+* Checks whether a touch read transfer of the given instance is in progress.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \return bool
+* True if a touch read transfer is in progress, false otherwise.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_is_busy_ex(const mtb_ctp_ft5406_config_t* config)
+{
+    CY_ASSERT(NULL != config);
+
+    return (MTB_CTP_FT5406_XFER_IDLE != config->xfer_state);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_is_busy
+********************************************************************************
+*
+* Checks whether a touch read transfer of the default instance is in progress.
+*
+* \return bool
+* True if a touch read transfer is in progress, false otherwise.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_is_busy(void)
+{
+    return mtb_ctp_ft5406_is_busy_ex(ft5406_config);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_int_handler_ex
+********************************************************************************
+*
+* Handles the FT5406 INT pin interrupt of the given instance in event mode:
+* clears the GPIO interrupt and starts the touch read. Call this function from
+* the GPIO port interrupt handler of the INT pin. If a touch read is in
+* progress, the read is started again once it completes.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_int_handler_ex(mtb_ctp_ft5406_config_t* config)
+{
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != config->int_port);
+
+    if (0U != Cy_GPIO_GetInterruptStatusMasked(config->int_port, config->int_pin))
+    {
+        Cy_GPIO_ClearInterrupt(config->int_port, config->int_pin);
+
+        /* Keep the earliest assertion until a read serves it */
+        if (TRACE_ENABLED(config) && !config->trace_int_valid)
+        {
+            config->trace_int       = config->get_timestamp_us();
+            config->trace_int_valid = true;
+        }
+
+        /* The flag is also taken by the thread side, the read is started if idle */
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        config->int_pending = true;
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+        mtb_ctp_ft5406_bus_released_ex(config);
+    }
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_int_handler
+********************************************************************************
+*
+* Handles the FT5406 INT pin interrupt of the default instance in event mode.
+* See mtb_ctp_ft5406_int_handler_ex().
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_int_handler(void)
+{
+    mtb_ctp_ft5406_int_handler_ex(ft5406_config);
+}
+
+
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_dma_handler_ex
+********************************************************************************
+*
+* Handles the interrupt of the DataWire channel receiving the touch reads of
+* the given instance: clears the channel interrupt and, once the channel
+* received its part of the read, unmasks the SCB RX interrupt so the PDL
+* receives the last bytes and completes the I2C read. A channel error aborts
+* the I2C read and ends the touch read with CY_SCB_I2C_MASTER_MANUAL_BUS_ERR,
+* leaving the latest frame intact. Call this function from the interrupt
+* handler of the channel.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_dma_handler_ex(mtb_ctp_ft5406_config_t* config)
+{
+    const mtb_ctp_ft5406_dma_t* dma;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != config->dma);
+
+    dma = config->dma;
+    if (0U == Cy_DMA_Channel_GetInterruptStatus(dma->base, dma->channel))
+    {
+        return;
+    }
+    Cy_DMA_Channel_ClearInterrupt(dma->base, dma->channel);
+
+    if (!config->xfer_dma_wait)
+    {
+        /* Channel of an aborted read */
+    }
+    else if (CY_DMA_INTR_CAUSE_COMPLETION == Cy_DMA_Channel_GetStatus(dma->base, dma->channel))
+    {
+        /* Hand the RX FIFO back to the PDL for the tail of the read */
+        config->xfer_dma_wait = false;
+        Cy_SCB_SetRxInterruptMask(config->i2c_base, CY_SCB_RX_INTR_LEVEL);
+    }
+    else
+    {
+        /* The touch data is incomplete, the PDL would wait for it forever */
+        Cy_SCB_I2C_MasterAbortRead(config->i2c_base, config->i2c_context);
+        mtb_ctp_ft5406_complete_read(config, CY_SCB_I2C_MASTER_MANUAL_BUS_ERR);
+    }
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_dma_handler
+********************************************************************************
+*
+* Handles the interrupt of the DataWire channel receiving the touch reads of
+* the default instance. See mtb_ctp_ft5406_dma_handler_ex().
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_dma_handler(void)
+{
+    mtb_ctp_ft5406_dma_handler_ex(ft5406_config);
+}
+
+
+#endif /* MTB_CTP_FT5406_ENABLE_DMA */
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_bus_released_ex
+********************************************************************************
+*
+* Starts the touch read of the given instance requested by the INT pin while
+* the I2C bus was not available, e.g. locked by another device on a shared
+* bus. Call this function after another device releases the bus lock; the
+* shared bus lock of mtb_ctp_ft5406_bus_lock.h calls it on unlock. Can be
+* called in interrupt context.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_bus_released_ex(mtb_ctp_ft5406_config_t* config)
+{
+    uint32_t interrupt_state;
+    uint32_t attempt;
+    bool int_deferred = true;
+
+    CY_ASSERT(NULL != config);
+
+    /* If the bus is taken again meanwhile, the next release retries. The second
+     * attempt catches a release which passed between the failed start and the
+     * deferral. */
+    for (attempt = 0U; int_deferred && (attempt < 2U); attempt++)
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        int_deferred = config->int_pending &&
+                       (MTB_CTP_FT5406_XFER_IDLE == config->xfer_state);
+        if (int_deferred)
+        {
+            config->int_pending = false;
+        }
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+        if (int_deferred &&
+            (CY_SCB_I2C_SUCCESS != mtb_ctp_ft5406_start_touch_read(config, NULL, NULL, 0U)))
+        {
+            interrupt_state = Cy_SysLib_EnterCriticalSection();
+            config->int_pending = true;
+            int_deferred = (MTB_CTP_FT5406_XFER_IDLE == config->xfer_state);
+            Cy_SysLib_ExitCriticalSection(interrupt_state);
+        }
+        else
+        {
+            int_deferred = false;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_bus_released
+********************************************************************************
+*
+* Starts the touch read of the default instance requested by the INT pin while
+* the I2C bus was not available. See mtb_ctp_ft5406_bus_released_ex().
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_bus_released(void)
+{
+    mtb_ctp_ft5406_bus_released_ex(ft5406_config);
+}
+
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_stats_ex
+********************************************************************************
+*
+* Takes a consistent snapshot of the I2C transaction statistics of the given
+* instance. The statistics are counted from the instance initialization or the
+* last mtb_ctp_ft5406_reset_stats_ex() call.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+* \param stats
+* Pointer to the variable to store the statistics.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_get_stats_ex(const mtb_ctp_ft5406_config_t* config,
+                                 mtb_ctp_ft5406_stats_t* stats)
+{
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+    CY_ASSERT(NULL != stats);
+
+    /* Touch reads update the statistics from the SCB I2C interrupt */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    *stats = config->stats;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_get_stats
+********************************************************************************
+*
+* Takes a snapshot of the I2C transaction statistics of the default instance.
+* See mtb_ctp_ft5406_get_stats_ex().
+*
+* \param stats
+* Pointer to the variable to store the statistics.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_get_stats(mtb_ctp_ft5406_stats_t* stats)
+{
+    mtb_ctp_ft5406_get_stats_ex(ft5406_config, stats);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_reset_stats_ex
+********************************************************************************
+*
+* Clears the I2C transaction statistics of the given instance.
+*
+* \param config
+* Pointer to the FT5406 instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_reset_stats_ex(mtb_ctp_ft5406_config_t* config)
+{
+    uint32_t interrupt_state;
+
+    CY_ASSERT(NULL != config);
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    (void)memset(&config->stats, 0, sizeof(config->stats));
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function name: mtb_ctp_ft5406_reset_stats
+********************************************************************************
+*
+* Clears the I2C transaction statistics of the default instance.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_reset_stats(void)
+{
+    mtb_ctp_ft5406_reset_stats_ex(ft5406_config);
+}
+
+
+#endif /* MTB_CTP_FT5406_ENABLE_STATS */
+
 /* [] END OF FILE */
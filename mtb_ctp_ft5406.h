@@ -45,21 +45,104 @@ extern "C" {
 /* FT5406 maximum number of simultaneously detected touches. */
 #define MTB_CTP_FT5406_MAX_TOUCHES            (5U)
 
+/* Number of touch points decoded from each frame. Defaults to all touch
+ * points. Applications which only use the first touch points can reduce it
+ * to bound the decode loop by a smaller constant; touches past it are not
+ * reported. */
+#ifndef MTB_CTP_FT5406_DECODE_MAX_TOUCHES
+#define MTB_CTP_FT5406_DECODE_MAX_TOUCHES     MTB_CTP_FT5406_MAX_TOUCHES
+#endif
+
+#if (MTB_CTP_FT5406_DECODE_MAX_TOUCHES < 1U) || \
+    (MTB_CTP_FT5406_DECODE_MAX_TOUCHES > MTB_CTP_FT5406_MAX_TOUCHES)
+#error "MTB_CTP_FT5406_DECODE_MAX_TOUCHES must be in range from 1 to MTB_CTP_FT5406_MAX_TOUCHES"
+#endif
+
+/* Number of distinct touch IDs, the FT5406 reports 4-bit touch IDs. */
+#define MTB_CTP_FT5406_TOUCH_ID_COUNT         (16U)
+
 /* FT5406 register address where touch data begins. */
 #define MTB_CTP_FT5406_TOUCH_DATA_SUBADDR     (1U)
 
 /* FT5406 raw touch data length. */
 #define MTB_CTP_FT5406_TOUCH_DATA_LEN         (32U)
 
+/* Number of touch buffers: the latest frame, the frame held by the view, and the read in progress. */
+#define MTB_CTP_FT5406_TOUCH_BUFF_COUNT       (3U)
+
 /* FT5406 registers and value(s) */
 #define MTB_CTP_FT5406_DEVICE_MODE            (0x00U)
 #define MTB_CTP_REG_READ_TOUCH_DATA           (0x01U)
 
+#define MTB_CTP_FT5406_G_THGROUP              (0x80U)
+#define MTB_CTP_FT5406_G_THPEAK               (0x81U)
+#define MTB_CTP_FT5406_G_THCAL                (0x82U)
+#define MTB_CTP_FT5406_G_THWATER              (0x83U)
+#define MTB_CTP_FT5406_G_THTEMP               (0x84U)
+#define MTB_CTP_FT5406_G_THDIFF               (0x85U)
+#define MTB_CTP_FT5406_G_CTRL                 (0x86U)
+#define MTB_CTP_FT5406_G_TIME_ENTER_MONITOR   (0x87U)
+#define MTB_CTP_FT5406_G_PERIOD_ACTIVE        (0x88U)
+#define MTB_CTP_FT5406_G_PERIOD_MONITOR       (0x89U)
+#define MTB_CTP_FT5406_G_AUTO_CLB_MODE        (0xA0U)
+#define MTB_CTP_FT5406_G_LIB_VERSION_H        (0xA1U)
+#define MTB_CTP_FT5406_G_LIB_VERSION_L        (0xA2U)
+#define MTB_CTP_FT5406_G_CIPHER               (0xA3U)
+#define MTB_CTP_FT5406_G_MODE                 (0xA4U)
+#define MTB_CTP_FT5406_G_PMODE                (0xA5U)
+#define MTB_CTP_FT5406_G_FIRMID               (0xA6U)
+#define MTB_CTP_FT5406_G_STATE                (0xA7U)
+#define MTB_CTP_FT5406_G_VENDOR_ID            (0xA8U)
+
+/* Window of configuration registers kept in the register shadow */
+#define MTB_CTP_FT5406_REG_SHADOW_FIRST       (0x80U)
+#define MTB_CTP_FT5406_REG_SHADOW_COUNT       (48U)
+
 #define MTB_CTP_FT5406_NORMAL_MODE            (0x00U)
+#define MTB_CTP_FT5406_INT_TRIGGER_MODE       (0x01U)
+#define MTB_CTP_FT5406_CTRL_KEEP_ACTIVE       (0x00U)
+#define MTB_CTP_FT5406_CTRL_AUTO_MONITOR      (0x01U)
+#define MTB_CTP_FT5406_PMODE_ACTIVE           (0x00U)
+#define MTB_CTP_FT5406_PMODE_MONITOR          (0x01U)
+#define MTB_CTP_FT5406_PMODE_HIBERNATE        (0x03U)
+
+/* FT5406 hardware gesture IDs (GEST_ID register) */
+#define MTB_CTP_FT5406_HW_GESTURE_NONE        (0x00U)
+#define MTB_CTP_FT5406_HW_GESTURE_MOVE_UP     (0x10U)
+#define MTB_CTP_FT5406_HW_GESTURE_MOVE_LEFT   (0x14U)
+#define MTB_CTP_FT5406_HW_GESTURE_MOVE_DOWN   (0x18U)
+#define MTB_CTP_FT5406_HW_GESTURE_MOVE_RIGHT  (0x1CU)
+#define MTB_CTP_FT5406_HW_GESTURE_ZOOM_IN     (0x48U)
+#define MTB_CTP_FT5406_HW_GESTURE_ZOOM_OUT    (0x49U)
 
 /* CTP I2C target address */
 #define MTB_CTP_FT5406_I2C_ADDRESS            (0x38U)
 
+/* Maximum number of driver instances, each on its own I2C bus (1 to 4). */
+#ifndef MTB_CTP_FT5406_MAX_INSTANCES
+#define MTB_CTP_FT5406_MAX_INSTANCES          (2U)
+#endif
+
+#if ((MTB_CTP_FT5406_MAX_INSTANCES < 1U) || (MTB_CTP_FT5406_MAX_INSTANCES > 4U))
+#error "MTB_CTP_FT5406_MAX_INSTANCES must be in range from 1 to 4"
+#endif
+
+/* I2C transaction statistics, 1 to enable. When disabled, the statistics and
+ * their API are not compiled. */
+#ifndef MTB_CTP_FT5406_ENABLE_STATS
+#define MTB_CTP_FT5406_ENABLE_STATS           (0U)
+#endif
+
+/* DMA reception of touch reads, 1 to enable. When disabled, the dma member of
+ * mtb_ctp_ft5406_config_t and the DMA API are not compiled. */
+#ifndef MTB_CTP_FT5406_ENABLE_DMA
+#define MTB_CTP_FT5406_ENABLE_DMA             (0U)
+#endif
+
+/* Number of latency histogram buckets. Bucket n counts transfers taking
+ * 2^n to 2^(n+1)-1 microseconds, the last bucket counts all longer ones. */
+#define MTB_CTP_FT5406_STATS_LATENCY_BUCKETS  (16U)
+
 
 /*******************************************************************************
 * Data Structures
@@ -102,24 +185,392 @@ typedef struct
     uint16_t touch_y; /* Y coordinate of the touch point */
 } mtb_ctp_multi_touch_point_t;
 
+/* Multi touch points stored as structure-of-arrays */
+typedef struct
+{
+    uint8_t touch_count;                               /* Number of valid touch points */
+    uint8_t touch_event[MTB_CTP_FT5406_MAX_TOUCHES];   /* mtb_ctp_touch_event_t of each point */
+    uint8_t touch_id[MTB_CTP_FT5406_MAX_TOUCHES];      /* Id of each touch point */
+    uint16_t touch_x[MTB_CTP_FT5406_MAX_TOUCHES];      /* X coordinate of each touch point */
+    uint16_t touch_y[MTB_CTP_FT5406_MAX_TOUCHES];      /* Y coordinate of each touch point */
+} mtb_ctp_ft5406_touch_soa_t;
+
+/* Touch read transfer state */
+typedef enum
+{
+    MTB_CTP_FT5406_XFER_IDLE,       /* No transfer in progress. */
+    MTB_CTP_FT5406_XFER_WRITE_ADDR, /* Writing register address. */
+    MTB_CTP_FT5406_XFER_READ_DATA,  /* Reading register data after repeated Start. */
+    MTB_CTP_FT5406_XFER_WRITE_REG,  /* Blocking register write in progress. */
+    MTB_CTP_FT5406_XFER_LOCK_WAIT   /* Waiting for the shared bus lock. */
+} mtb_ctp_ft5406_xfer_state_t;
+
+/* Touch data read mode */
+typedef enum
+{
+    MTB_CTP_FT5406_READ_FULL,    /* Read all touch points on every poll. */
+    MTB_CTP_FT5406_READ_ADAPTIVE /* Size the read from the previous touch count. */
+} mtb_ctp_ft5406_read_mode_t;
+
+/* Rotation of the touch coordinates, clockwise */
+typedef enum
+{
+    MTB_CTP_FT5406_ROTATE_0,   /* Panel coordinates are display coordinates. */
+    MTB_CTP_FT5406_ROTATE_90,  /* Panel X axis runs down the display. */
+    MTB_CTP_FT5406_ROTATE_180, /* Both axes are inverted. */
+    MTB_CTP_FT5406_ROTATE_270  /* Panel X axis runs up the display. */
+} mtb_ctp_ft5406_rotation_t;
+
+/* Affine coordinate transform with Q16.16 coefficients:
+ * x' = (a * x + b * y + c) >> 16, y' = (d * x + e * y + f) >> 16 */
+typedef struct
+{
+    int32_t a;
+    int32_t b;
+    int32_t c;
+    int32_t d;
+    int32_t e;
+    int32_t f;
+} mtb_ctp_ft5406_affine_t;
+
+/* Touch coordinate point */
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+} mtb_ctp_ft5406_point_t;
+
+/* Touch coordinate transform settings */
+typedef struct
+{
+    mtb_ctp_ft5406_rotation_t rotation; /* Rotation applied to the panel coordinates */
+    bool mirror_x;                      /* Mirror X after rotation */
+    bool mirror_y;                      /* Mirror Y after rotation */
+    uint16_t panel_width;               /* Panel X coordinate range */
+    uint16_t panel_height;              /* Panel Y coordinate range */
+    uint16_t display_width;             /* Display width, 0 for no scaling */
+    uint16_t display_height;            /* Display height, 0 for no scaling */
+    const mtb_ctp_ft5406_affine_t* calibration; /* Calibration from mtb_ctp_ft5406_calibrate(),
+                                                   replaces rotation, mirroring and scaling
+                                                   if not NULL */
+} mtb_ctp_ft5406_transform_t;
+
+/* Touch point jitter filter settings. Positions are filtered per touch ID in
+ * display coordinates. */
+typedef struct
+{
+    uint16_t deadband;        /* Movement in counts ignored while a contact rests, 0 to disable */
+    uint16_t alpha_min;       /* Weight of the new position in 1/256 for slow movements,
+                                 0 disables smoothing */
+    uint16_t alpha_max;       /* Weight of the new position in 1/256 at speed_threshold,
+                                 0 for no smoothing of fast movements */
+    uint16_t speed_threshold; /* Movement in counts per frame where alpha_max is reached,
+                                 0 for a fixed alpha_min */
+} mtb_ctp_ft5406_filter_t;
+
+/* Bus error handling of blocking transfers. Zero members select the default
+ * value. */
+typedef struct
+{
+    uint8_t max_attempts;     /* Attempts of each transfer including the first one (5) */
+    uint32_t timeout_us;      /* Completion timeout of each attempt (10000) */
+    uint32_t backoff_us;      /* Delay before the first retry, 0 to retry immediately */
+    uint32_t backoff_max_us;  /* The delay doubles on each retry up to this value,
+                                 0 for a fixed delay */
+    bool light_recovery;      /* Recover the first failure by ending the transfer only; the
+                                 I2C controller is re-enabled on repeated failures */
+    bool serve_last_frame;    /* Touch reads make one attempt and serve the last good
+                                 frame on failure */
+} mtb_ctp_ft5406_retry_t;
+
+/* FT5406 touch detection settings, see mtb_ctp_ft5406_set_tuning() */
+typedef struct
+{
+    uint8_t threshold;         /* Touch detection threshold (G_THGROUP) */
+    uint8_t peak_threshold;    /* Peak detection threshold (G_THPEAK) */
+    uint8_t focus_threshold;   /* Touch focus threshold (G_THCAL) */
+    uint8_t filter_threshold;  /* Point filter threshold (G_THDIFF) */
+    uint8_t active_period;     /* Report period in Active mode (G_PERIOD_ACTIVE) */
+    uint8_t monitor_period;    /* Report period in Monitor mode (G_PERIOD_MONITOR) */
+} mtb_ctp_ft5406_tuning_t;
+
+/* Lock of an I2C bus shared with other devices. lock() waits up to timeout_us
+ * for the bus and returns false if it is not obtained; priority is set for
+ * touch reads. Both functions are called from the I2C and INT interrupts, where
+ * lock() is called with a zero timeout. Unlocks by other devices must call
+ * mtb_ctp_ft5406_bus_released(). See mtb_ctp_ft5406_bus_lock.h. */
+typedef struct
+{
+    bool (* lock)(void* context, bool priority, uint32_t timeout_us);
+    void (* unlock)(void* context);
+    void* context;
+} mtb_ctp_ft5406_bus_lock_t;
+
+/* Filtered position of a touch ID in Q24.8 */
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+} mtb_ctp_ft5406_filter_state_t;
+
+/* Jitter filter state of all touch IDs. Zero-initialize before the first frame. */
+typedef struct
+{
+    uint16_t active;                                                    /* Touch IDs in contact */
+    mtb_ctp_ft5406_filter_state_t points[MTB_CTP_FT5406_TOUCH_ID_COUNT]; /* Filtered positions */
+} mtb_ctp_ft5406_filter_states_t;
+
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+/* I2C transaction statistics. The latency histograms require the
+ * get_timestamp_us time source. */
+typedef struct
+{
+    uint32_t transactions; /* I2C transactions started, including retries */
+    uint32_t bytes;        /* Bytes transferred by successful transactions */
+    uint32_t retries;      /* Transactions repeated after a failure */
+    uint32_t recoveries;   /* I2C controller re-enables after a failure */
+    uint32_t timeouts;     /* Transactions not completed in time */
+    uint32_t addr_nak;     /* Failures by I2C controller error bit */
+    uint32_t data_nak;
+    uint32_t arb_lost;
+    uint32_t abort_start;
+    uint32_t bus_err;
+    uint32_t read_latency[MTB_CTP_FT5406_STATS_LATENCY_BUCKETS];  /* Touch read transfers */
+    uint32_t write_latency[MTB_CTP_FT5406_STATS_LATENCY_BUCKETS]; /* Register write transfers */
+} mtb_ctp_ft5406_stats_t;
+#endif /* MTB_CTP_FT5406_ENABLE_STATS */
+
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+/* DataWire channel receiving touch reads. The channel must be triggered by the
+ * RX FIFO of the SCB, one byte per trigger, and disable itself after the
+ * descriptor. The driver sets the source, destination and count of the
+ * descriptor for each read, all but the last two bytes, which the PDL
+ * receives to end the read. It enables the channel interrupt, whose handler
+ * must call mtb_ctp_ft5406_dma_handler(). */
+typedef struct
+{
+    DW_Type* base;                       /* DataWire block */
+    uint32_t channel;                    /* Channel number */
+    cy_stc_dma_descriptor_t* descriptor; /* Descriptor of the channel */
+} mtb_ctp_ft5406_dma_t;
+#endif /* MTB_CTP_FT5406_ENABLE_DMA */
+
+/* Timestamp source returning a free-running time in microseconds */
+typedef uint32_t (* mtb_ctp_ft5406_get_timestamp_t)(void);
+
+/* Ring of decoded touch frames, see mtb_ctp_ft5406_frame_ring.h */
+typedef struct mtb_ctp_ft5406_frame_ring mtb_ctp_ft5406_frame_ring_t;
+
+/* Decoded touch frame of the ring, see mtb_ctp_ft5406_frame_ring.h */
+typedef struct mtb_ctp_ft5406_frame mtb_ctp_ft5406_frame_t;
+
+/* Raw touch frame capture writer, see mtb_ctp_ft5406_capture.h */
+typedef struct mtb_ctp_ft5406_capture mtb_ctp_ft5406_capture_t;
+
+/* Touch latency trace, see mtb_ctp_ft5406_trace.h */
+typedef struct mtb_ctp_ft5406_trace mtb_ctp_ft5406_trace_t;
+
+/* Touch read completion callback. Invoked from the SCB I2C interrupt context. */
+typedef void (* mtb_ctp_ft5406_read_cb_t)(cy_en_scb_i2c_status_t status,
+                                          int touch_count,
+                                          const mtb_ctp_multi_touch_point_t* touch_array,
+                                          void* user_data);
+
 /* FT5406 touch controller configuration structure */
 typedef struct
 {
     CySCB_Type* i2c_base;
     cy_stc_scb_i2c_context_t* i2c_context;
-    uint8_t touch_buff[MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    uint8_t touch_buff[MTB_CTP_FT5406_TOUCH_BUFF_COUNT][MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    mtb_ctp_ft5406_read_mode_t read_mode;
+    GPIO_PRT_Type* int_port; /* INT pin port, NULL to disable event mode */
+    uint32_t int_pin;        /* INT pin number */
+    mtb_ctp_ft5406_get_timestamp_t get_timestamp_us; /* Timestamp source, can be NULL */
+    mtb_ctp_ft5406_frame_ring_t* frame_ring; /* Ring receiving decoded frames, can be NULL */
+    mtb_ctp_ft5406_capture_t* capture;       /* Raw touch frame capture, can be NULL */
+    mtb_ctp_ft5406_trace_t* trace;           /* Touch latency trace, requires the
+                                                timestamp source, can be NULL */
+    const mtb_ctp_ft5406_transform_t* transform; /* Coordinate transform, NULL for panel
+                                                    coordinates */
+    const mtb_ctp_ft5406_filter_t* filter;       /* Jitter filter, NULL to disable */
+    const mtb_ctp_ft5406_retry_t* retry;         /* Bus error handling, NULL for the
+                                                    defaults */
+    const mtb_ctp_ft5406_bus_lock_t* bus_lock;   /* Shared bus lock, NULL if the bus is
+                                                    not shared */
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    const mtb_ctp_ft5406_dma_t* dma;             /* DMA reception of touch reads, NULL for
+                                                    the SCB interrupt */
+#endif
+
+    /* Internal state, initialized by mtb_ctp_ft5406_init(). Do not modify. */
+    volatile mtb_ctp_ft5406_xfer_state_t xfer_state;
+    volatile cy_en_scb_i2c_status_t xfer_status;
+    cy_stc_scb_i2c_master_xfer_config_t xfer_config;
+    uint8_t xfer_cmd;
+    uint8_t* xfer_read_buff;
+    uint32_t xfer_read_size;
+    bool xfer_touch_read;
+    volatile bool xfer_polled; /* Blocking transfer of the instance in progress */
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+    volatile bool xfer_dma_wait; /* DataWire channel receiving the read data */
+#endif
+    uint8_t touch_read_points;
+    volatile uint8_t touch_front; /* Touch buffer holding the latest complete frame */
+    uint8_t touch_back;           /* Touch buffer receiving the touch read */
+    volatile uint8_t touch_held;  /* Touch buffer held by the frame view */
+    uint8_t touch_last_count;
+    volatile bool int_pending;
+    volatile cy_en_scb_i2c_status_t int_status;
+    mtb_ctp_ft5406_read_cb_t read_cb;
+    void* read_cb_user_data;
+    mtb_ctp_touch_event_t touch_single_event;
+    uint8_t touch_count;
+    uint8_t touch_gesture_id;
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_touch_soa_t touch_soa;
+    uint32_t touch_changes;
+    uint32_t touch_reported_changes;
+    bool transform_enabled;
+    mtb_ctp_ft5406_affine_t transform_matrix;
+    uint16_t transform_max_x;
+    uint16_t transform_max_y;
+    uint16_t filter_alpha_min;  /* Jitter filter weights limited to 256 */
+    uint16_t filter_alpha_max;
+    mtb_ctp_ft5406_filter_states_t filter_states;
+    mtb_ctp_ft5406_retry_t retry_policy;
+    uint64_t reg_valid;      /* Shadow registers holding the FT5406 value */
+    uint64_t reg_dirty;      /* Shadow registers waiting to be written */
+    uint8_t reg_shadow[MTB_CTP_FT5406_REG_SHADOW_COUNT];
+    volatile uint32_t trace_int;        /* INT assertion not served by a read yet */
+    volatile bool trace_int_valid;
+    uint32_t trace_request;             /* INT assertion or request of the touch read */
+    uint32_t trace_start;               /* Bus start of the touch read */
+    uint32_t trace_frame;               /* Trace frame number of the latest frame */
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+    uint32_t stats_read_start;
+    mtb_ctp_ft5406_stats_t stats;
+#endif
 } mtb_ctp_ft5406_config_t;
 
+/* Read-only view of the latest complete touch frame, see mtb_ctp_ft5406_acquire_view() */
+typedef struct
+{
+    mtb_ctp_ft5406_config_t* config;               /* Instance owning the frame */
+    const mtb_ctp_ft5406_touch_data_t* touch_data; /* Raw touch data of the frame */
+    uint8_t touch_count;                           /* Number of valid touch points */
+} mtb_ctp_ft5406_view_t;
+
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 cy_en_scb_i2c_status_t mtb_ctp_ft5406_init(mtb_ctp_ft5406_config_t* mtb_ctp_ft5406_config);
+void mtb_ctp_ft5406_deinit(void);
 cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_single_touch(mtb_ctp_touch_event_t* touch_event,
                                                        int* touch_x,
                                                        int* touch_y);
 cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch(int* touch_count,
                                                       mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES]);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_changed(int* touch_count,
+                                                              mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                                              bool* changed);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_soa(mtb_ctp_ft5406_touch_soa_t* touch_soa);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_async(mtb_ctp_ft5406_read_cb_t read_cb, void* user_data);
+bool mtb_ctp_ft5406_is_busy(void);
+void mtb_ctp_ft5406_int_handler(void);
+void mtb_ctp_ft5406_bus_released(void);
+void mtb_ctp_ft5406_set_transform(const mtb_ctp_ft5406_transform_t* transform);
+void mtb_ctp_ft5406_set_retry(const mtb_ctp_ft5406_retry_t* retry);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_tuning(const mtb_ctp_ft5406_tuning_t* tuning);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_tuning(mtb_ctp_ft5406_tuning_t* tuning);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_threshold(uint8_t threshold);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_report_period(uint8_t period);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_monitor_period(uint8_t period);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_power_mode(uint8_t power_mode);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_auto_monitor(uint8_t enter_after_s);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_firmware_id(uint8_t* firmware_id);
+uint8_t mtb_ctp_ft5406_get_gesture_id(void);
+bool mtb_ctp_ft5406_acquire_view(mtb_ctp_ft5406_view_t* view);
+void mtb_ctp_ft5406_release_view(mtb_ctp_ft5406_view_t* view);
+bool mtb_ctp_ft5406_pop_frame(mtb_ctp_ft5406_frame_t* frame);
+mtb_ctp_touch_event_t mtb_ctp_ft5406_view_get_event(const mtb_ctp_ft5406_view_t* view,
+                                                    uint32_t index);
+uint8_t mtb_ctp_ft5406_view_get_id(const mtb_ctp_ft5406_view_t* view, uint32_t index);
+void mtb_ctp_ft5406_view_get_position(const mtb_ctp_ft5406_view_t* view,
+                                      uint32_t index,
+                                      uint16_t* touch_x,
+                                      uint16_t* touch_y);
+bool mtb_ctp_ft5406_calibrate(const mtb_ctp_ft5406_point_t panel_points[3],
+                              const mtb_ctp_ft5406_point_t display_points[3],
+                              mtb_ctp_ft5406_affine_t* calibration);
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+void mtb_ctp_ft5406_get_stats(mtb_ctp_ft5406_stats_t* stats);
+void mtb_ctp_ft5406_reset_stats(void);
+#endif
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+void mtb_ctp_ft5406_dma_handler(void);
+#endif
+
+/* Instance functions */
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_init_ex(mtb_ctp_ft5406_config_t* config);
+void mtb_ctp_ft5406_deinit_ex(mtb_ctp_ft5406_config_t* config);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_single_touch_ex(mtb_ctp_ft5406_config_t* config,
+                                                          mtb_ctp_touch_event_t* touch_event,
+                                                          int* touch_x,
+                                                          int* touch_y);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_ex(mtb_ctp_ft5406_config_t* config,
+                                                         int* touch_count,
+                                                         mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES]);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_changed_ex(mtb_ctp_ft5406_config_t* config,
+                                                                 int* touch_count,
+                                                                 mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                                                 bool* changed);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_multi_touch_soa_ex(mtb_ctp_ft5406_config_t* config,
+                                                             mtb_ctp_ft5406_touch_soa_t* touch_soa);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_read_async_ex(mtb_ctp_ft5406_config_t* config,
+                                                    mtb_ctp_ft5406_read_cb_t read_cb,
+                                                    void* user_data);
+bool mtb_ctp_ft5406_is_busy_ex(const mtb_ctp_ft5406_config_t* config);
+void mtb_ctp_ft5406_decode_touch_data_ex(mtb_ctp_ft5406_config_t* config,
+                                         const uint8_t* touch_data,
+                                         int* touch_count,
+                                         mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                         mtb_ctp_ft5406_filter_states_t* filter_states);
+void mtb_ctp_ft5406_int_handler_ex(mtb_ctp_ft5406_config_t* config);
+void mtb_ctp_ft5406_bus_released_ex(mtb_ctp_ft5406_config_t* config);
+uint8_t mtb_ctp_ft5406_get_gesture_id_ex(const mtb_ctp_ft5406_config_t* config);
+bool mtb_ctp_ft5406_acquire_view_ex(mtb_ctp_ft5406_config_t* config,
+                                   mtb_ctp_ft5406_view_t* view);
+bool mtb_ctp_ft5406_pop_frame_ex(mtb_ctp_ft5406_config_t* config,
+                                 mtb_ctp_ft5406_frame_t* frame);
+void mtb_ctp_ft5406_set_transform_ex(mtb_ctp_ft5406_config_t* config,
+                                     const mtb_ctp_ft5406_transform_t* transform);
+void mtb_ctp_ft5406_set_retry_ex(mtb_ctp_ft5406_config_t* config,
+                                 const mtb_ctp_ft5406_retry_t* retry);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_tuning_ex(mtb_ctp_ft5406_config_t* config,
+                                                    const mtb_ctp_ft5406_tuning_t* tuning);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_tuning_ex(mtb_ctp_ft5406_config_t* config,
+                                                    mtb_ctp_ft5406_tuning_t* tuning);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_threshold_ex(mtb_ctp_ft5406_config_t* config,
+                                                       uint8_t threshold);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_report_period_ex(mtb_ctp_ft5406_config_t* config,
+                                                           uint8_t period);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_monitor_period_ex(mtb_ctp_ft5406_config_t* config,
+                                                            uint8_t period);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_power_mode_ex(mtb_ctp_ft5406_config_t* config,
+                                                        uint8_t power_mode);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_set_auto_monitor_ex(mtb_ctp_ft5406_config_t* config,
+                                                          uint8_t enter_after_s);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_get_firmware_id_ex(mtb_ctp_ft5406_config_t* config,
+                                                         uint8_t* firmware_id);
+#if (MTB_CTP_FT5406_ENABLE_STATS)
+void mtb_ctp_ft5406_get_stats_ex(const mtb_ctp_ft5406_config_t* config,
+                                 mtb_ctp_ft5406_stats_t* stats);
+void mtb_ctp_ft5406_reset_stats_ex(mtb_ctp_ft5406_config_t* config);
+#endif
+#if (MTB_CTP_FT5406_ENABLE_DMA)
+void mtb_ctp_ft5406_dma_handler_ex(mtb_ctp_ft5406_config_t* config);
+#endif
 
 
 #if defined(__cplusplus)
@@ -0,0 +1,384 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_bus_lock.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the lock of an I2C bus shared by the FT5406 and
+* other devices.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_bus_lock.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Polling interval of the lock without RTOS */
+#define BUS_LOCK_POLL_US                   (10U)
+
+#define RESET_VAL                          (0U)
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_grant
+********************************************************************************
+*
+* Takes the lock if it is free and the request is next in turn. Priority
+* requests go first unless they were granted
+* MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST times in a row while other requests
+* wait. Must be called with interrupts disabled.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+* \param priority
+* True for a priority request.
+*
+* \return bool
+* True if the lock is taken.
+*
+*******************************************************************************/
+static bool mtb_ctp_ft5406_shared_bus_grant(mtb_ctp_ft5406_shared_bus_t* bus, bool priority)
+{
+    bool granted;
+
+    if (bus->locked)
+    {
+        granted = false;
+    }
+    else if (priority)
+    {
+        granted = (RESET_VAL == bus->other_waiting) ||
+                  (MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST > bus->priority_streak);
+    }
+    else
+    {
+        granted = (RESET_VAL == bus->priority_waiting) ||
+                  (MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST <= bus->priority_streak);
+    }
+
+    if (granted)
+    {
+        bus->locked = true;
+        bus->priority_streak = (priority && (RESET_VAL != bus->other_waiting)) ?
+                               (uint8_t)(bus->priority_streak + 1U) : (uint8_t)RESET_VAL;
+    }
+
+    return granted;
+}
+
+
+#if defined(COMPONENT_RTOS_AWARE)
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_wake
+********************************************************************************
+*
+* Wakes the waiting request which is next in turn when the lock is free.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_shared_bus_wake(mtb_ctp_ft5406_shared_bus_t* bus)
+{
+    cy_semaphore_t* semaphore = NULL;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    if (bus->locked)
+    {
+        /* The owner wakes the next request on unlock */
+    }
+    else if ((RESET_VAL != bus->priority_waiting) &&
+             ((RESET_VAL == bus->other_waiting) ||
+              (MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST > bus->priority_streak)))
+    {
+        semaphore = &bus->priority_sem;
+    }
+    else if (RESET_VAL != bus->other_waiting)
+    {
+        semaphore = &bus->other_sem;
+    }
+    else
+    {
+        /* No request waiting */
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (NULL != semaphore)
+    {
+        /* Unlock is called from the I2C interrupt on touch read completion */
+        (void)cy_rtos_set_semaphore(semaphore, (0U != __get_IPSR()));
+    }
+}
+#endif /* defined(COMPONENT_RTOS_AWARE) */
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_release
+********************************************************************************
+*
+* Releases the shared bus lock and wakes the waiting request which is next in
+* turn. The unlock member of the hooks, called by the FT5406 itself, which
+* serves its deferred touch reads on its own.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_shared_bus_release(void* bus)
+{
+    mtb_ctp_ft5406_shared_bus_t* shared_bus = (mtb_ctp_ft5406_shared_bus_t*)bus;
+
+    CY_ASSERT(NULL != shared_bus);
+
+    shared_bus->locked = false;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    mtb_ctp_ft5406_shared_bus_wake(shared_bus);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_init
+********************************************************************************
+*
+* Initializes the shared bus lock in the unlocked state. Attach the FT5406
+* with mtb_ctp_ft5406_shared_bus_attach() before mtb_ctp_ft5406_init(), and
+* lock the bus around the transfers of the other devices with
+* mtb_ctp_ft5406_shared_bus_lock().
+*
+* \param bus
+* Pointer to the shared bus.
+*
+* \return bool
+* True on success, false if the RTOS semaphores cannot be created.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_shared_bus_init(mtb_ctp_ft5406_shared_bus_t* bus)
+{
+    CY_ASSERT(NULL != bus);
+
+    bus->locked           = false;
+    bus->priority_waiting = RESET_VAL;
+    bus->other_waiting    = RESET_VAL;
+    bus->priority_streak  = RESET_VAL;
+    bus->hooks.lock       = mtb_ctp_ft5406_shared_bus_lock;
+    bus->hooks.unlock     = mtb_ctp_ft5406_shared_bus_release;
+    bus->hooks.context    = bus;
+    bus->ft5406           = NULL;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    if (CY_RSLT_SUCCESS != cy_rtos_init_semaphore(&bus->priority_sem, 1U, 0U))
+    {
+        return false;
+    }
+
+    if (CY_RSLT_SUCCESS != cy_rtos_init_semaphore(&bus->other_sem, 1U, 0U))
+    {
+        (void)cy_rtos_deinit_semaphore(&bus->priority_sem);
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_free
+********************************************************************************
+*
+* Releases the RTOS resources of the shared bus lock. The lock must not be in
+* use.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_shared_bus_free(mtb_ctp_ft5406_shared_bus_t* bus)
+{
+    CY_ASSERT(NULL != bus);
+
+#if defined(COMPONENT_RTOS_AWARE)
+    (void)cy_rtos_deinit_semaphore(&bus->priority_sem);
+    (void)cy_rtos_deinit_semaphore(&bus->other_sem);
+#else
+    CY_UNUSED_PARAMETER(bus);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_attach
+********************************************************************************
+*
+* Sets the shared bus lock as bus_lock of the FT5406 configuration structure.
+* A touch read requested by the INT pin while another device holds the lock is
+* started when that device unlocks the bus. Call before mtb_ctp_ft5406_init().
+*
+* \param bus
+* Pointer to the shared bus.
+*
+* \param ft5406
+* Pointer to the FT5406 configuration structure.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_shared_bus_attach(mtb_ctp_ft5406_shared_bus_t* bus,
+                                      mtb_ctp_ft5406_config_t* ft5406)
+{
+    CY_ASSERT(NULL != bus);
+    CY_ASSERT(NULL != ft5406);
+
+    ft5406->bus_lock = &bus->hooks;
+    bus->ft5406      = ft5406;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_lock
+********************************************************************************
+*
+* Takes the shared bus lock, waiting up to the given time. Only a zero timeout
+* may be used in interrupt context. Matches the lock member of
+* mtb_ctp_ft5406_bus_lock_t.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+* \param priority
+* True for a priority request, e.g. a touch read.
+*
+* \param timeout_us
+* Time to wait for the lock in microseconds, 0 to try once.
+*
+* \return bool
+* True if the lock is taken.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_shared_bus_lock(void* bus, bool priority, uint32_t timeout_us)
+{
+    mtb_ctp_ft5406_shared_bus_t* shared_bus = (mtb_ctp_ft5406_shared_bus_t*)bus;
+    volatile uint8_t* waiting;
+    uint32_t interrupt_state;
+    bool granted;
+    bool expired = false;
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_semaphore_t* semaphore;
+    cy_time_t start;
+    cy_time_t now;
+    uint32_t timeout_ms = (timeout_us + 999U) / 1000U;
+    uint32_t elapsed_ms;
+    cy_rslt_t rslt;
+#endif
+
+    CY_ASSERT(NULL != shared_bus);
+
+    waiting = priority ? &shared_bus->priority_waiting : &shared_bus->other_waiting;
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    granted = mtb_ctp_ft5406_shared_bus_grant(shared_bus, priority);
+    if ((!granted) && (RESET_VAL != timeout_us))
+    {
+        (*waiting)++;
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (granted || (RESET_VAL == timeout_us))
+    {
+        return granted;
+    }
+
+#if defined(COMPONENT_RTOS_AWARE)
+    semaphore = priority ? &shared_bus->priority_sem : &shared_bus->other_sem;
+    (void)cy_rtos_get_time(&start);
+#endif
+
+    while ((!granted) && (!expired))
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        /* Woken on unlock when the request is next in turn */
+        rslt = cy_rtos_get_semaphore(semaphore, timeout_ms, false);
+        (void)cy_rtos_get_time(&now);
+        elapsed_ms = (uint32_t)(now - start);
+        expired = (CY_RSLT_SUCCESS != rslt) || (elapsed_ms >= timeout_ms);
+        if (!expired)
+        {
+            timeout_ms -= elapsed_ms;
+            start       = now;
+        }
+#else
+        Cy_SysLib_DelayUs(BUS_LOCK_POLL_US);
+        timeout_us = (BUS_LOCK_POLL_US < timeout_us) ? (timeout_us - BUS_LOCK_POLL_US) : RESET_VAL;
+        expired = (RESET_VAL == timeout_us);
+#endif
+
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        granted = mtb_ctp_ft5406_shared_bus_grant(shared_bus, priority);
+        if (granted || expired)
+        {
+            (*waiting)--;
+        }
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+
+#if defined(COMPONENT_RTOS_AWARE)
+    if (!granted)
+    {
+        /* A request held back by this one may be next in turn now */
+        mtb_ctp_ft5406_shared_bus_wake(shared_bus);
+    }
+#endif
+
+    return granted;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_shared_bus_unlock
+********************************************************************************
+*
+* Releases the shared bus lock taken by another device, wakes the waiting
+* request which is next in turn, and starts the touch read the attached FT5406
+* deferred meanwhile. Can be called in interrupt context.
+*
+* \param bus
+* Pointer to the shared bus.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_shared_bus_unlock(void* bus)
+{
+    mtb_ctp_ft5406_shared_bus_t* shared_bus = (mtb_ctp_ft5406_shared_bus_t*)bus;
+
+    mtb_ctp_ft5406_shared_bus_release(shared_bus);
+
+    if (NULL != shared_bus->ft5406)
+    {
+        mtb_ctp_ft5406_bus_released_ex(shared_bus->ft5406);
+    }
+}
+
+
+/* [] END OF FILE */
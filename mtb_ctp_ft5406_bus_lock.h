@@ -0,0 +1,96 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_bus_lock.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the lock of an
+* I2C bus shared by the FT5406 and other devices.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_BUS_LOCK_H
+#define MTB_CTP_FT5406_BUS_LOCK_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of priority grants in a row while other traffic waits for the bus. */
+#ifndef MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST
+#define MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST  (4U)
+#endif
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Lock of a shared I2C bus. Priority requests are granted first, bounded to
+ * MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST grants while other requests wait.
+ * Waiting blocks on RTOS semaphores with COMPONENT_RTOS_AWARE, otherwise it
+ * polls the lock. */
+typedef struct
+{
+    volatile bool locked;
+    volatile uint8_t priority_waiting; /* Number of waiting priority requests */
+    volatile uint8_t other_waiting;    /* Number of waiting other requests */
+    volatile uint8_t priority_streak;  /* Priority grants while other requests wait */
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_semaphore_t priority_sem;
+    cy_semaphore_t other_sem;
+#endif
+    mtb_ctp_ft5406_bus_lock_t hooks;   /* Hooks set as bus_lock of the FT5406 */
+    mtb_ctp_ft5406_config_t* ft5406;   /* FT5406 restarting deferred reads on unlock */
+} mtb_ctp_ft5406_shared_bus_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool mtb_ctp_ft5406_shared_bus_init(mtb_ctp_ft5406_shared_bus_t* bus);
+void mtb_ctp_ft5406_shared_bus_free(mtb_ctp_ft5406_shared_bus_t* bus);
+void mtb_ctp_ft5406_shared_bus_attach(mtb_ctp_ft5406_shared_bus_t* bus,
+                                      mtb_ctp_ft5406_config_t* ft5406);
+bool mtb_ctp_ft5406_shared_bus_lock(void* bus, bool priority, uint32_t timeout_us);
+void mtb_ctp_ft5406_shared_bus_unlock(void* bus);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_BUS_LOCK_H */
+
+
+/* [] END OF FILE */
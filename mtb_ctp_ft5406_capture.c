@@ -0,0 +1,310 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_capture.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the raw FT5406 touch frame capture and replay.
+*
+* Stream format: a 5-byte header ("FT54" and the format version) followed by
+* one record per touch read. A record is a tag byte, the 32-bit little-endian
+* timestamp, and either the raw touch data (tag holds its length) or, for a
+* failed read (tag error flag set), the 32-bit little-endian I2C status.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "mtb_ctp_ft5406_capture.h"
+#include "mtb_ctp_ft5406_internal.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define RESET_VAL                          (0U)
+
+#define CAPTURE_WORD_LEN                   (4U)
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_capture_put_word
+********************************************************************************
+*
+* Stores a 32-bit value in little-endian byte order.
+*
+* \param buff
+* Pointer to the destination.
+*
+* \param value
+* Value to store.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_capture_put_word(uint8_t* buff, uint32_t value)
+{
+    buff[0] = (uint8_t)value;
+    buff[1] = (uint8_t)(value >> 8U);
+    buff[2] = (uint8_t)(value >> 16U);
+    buff[3] = (uint8_t)(value >> 24U);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_capture_get_word
+********************************************************************************
+*
+* Loads a 32-bit value stored in little-endian byte order.
+*
+* \param buff
+* Pointer to the source.
+*
+* \return uint32_t
+* Loaded value.
+*
+*******************************************************************************/
+static uint32_t mtb_ctp_ft5406_capture_get_word(const uint8_t* buff)
+{
+    return (uint32_t)buff[0] | ((uint32_t)buff[1] << 8U) |
+           ((uint32_t)buff[2] << 16U) | ((uint32_t)buff[3] << 24U);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_capture_init
+********************************************************************************
+*
+* Initializes the capture writer and writes the stream header to the sink.
+* Attach the writer to the driver configuration to capture every touch read.
+*
+* \param capture
+* Pointer to the capture writer.
+*
+* \param write
+* Stream sink. It is invoked from the touch read completion context, which is
+* the SCB I2C interrupt for non-blocking and event mode reads, so it must only
+* copy the data, e.g. into a RAM buffer or a stream FIFO.
+*
+* \param user_data
+* User data to be passed to the sink.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_capture_init(mtb_ctp_ft5406_capture_t* capture,
+                                 mtb_ctp_ft5406_capture_write_t write,
+                                 void* user_data)
+{
+    CY_ASSERT(NULL != capture);
+    CY_ASSERT(NULL != write);
+
+    capture->write       = write;
+    capture->user_data   = user_data;
+    capture->frame_count = RESET_VAL;
+
+    (void)memcpy(capture->record, MTB_CTP_FT5406_CAPTURE_MAGIC, CAPTURE_WORD_LEN);
+    capture->record[CAPTURE_WORD_LEN] = MTB_CTP_FT5406_CAPTURE_VERSION;
+
+    capture->write(capture->record, MTB_CTP_FT5406_CAPTURE_HEADER_LEN, capture->user_data);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_capture_frame
+********************************************************************************
+*
+* Encodes a touch read into a record and writes it to the sink. Only the header
+* and the touch points reported by TD_STATUS (at least one) are stored.
+*
+* \param capture
+* Pointer to the capture writer.
+*
+* \param timestamp
+* Read completion time in microseconds.
+*
+* \param status
+* Touch read status.
+*
+* \param touch_data
+* Pointer to the raw touch data, not accessed if the read failed.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_capture_frame(mtb_ctp_ft5406_capture_t* capture,
+                                  uint32_t timestamp,
+                                  cy_en_scb_i2c_status_t status,
+                                  const uint8_t* touch_data)
+{
+    uint32_t size = 1U + CAPTURE_WORD_LEN;
+    uint32_t data_len;
+    uint8_t touch_points;
+
+    mtb_ctp_ft5406_capture_put_word(&capture->record[1], timestamp);
+
+    if (CY_SCB_I2C_SUCCESS == status)
+    {
+        touch_points = touch_data[TOUCH_DATA_COUNT_OFFSET];
+        if (MTB_CTP_FT5406_MAX_TOUCHES < touch_points)
+        {
+            touch_points = MTB_CTP_FT5406_MAX_TOUCHES;
+        }
+        else if (RESET_VAL == touch_points)
+        {
+            /* The first touch point reports the lift-off event */
+            touch_points = 1U;
+        }
+        else
+        {
+            /* Valid touch count */
+        }
+
+        data_len = TOUCH_DATA_HEADER_LEN + ((uint32_t)touch_points * TOUCH_POINT_LEN);
+
+        capture->record[0] = (uint8_t)data_len;
+        (void)memcpy(&capture->record[size], touch_data, data_len);
+        size += data_len;
+    }
+    else
+    {
+        capture->record[0] = MTB_CTP_FT5406_CAPTURE_TAG_ERROR;
+        mtb_ctp_ft5406_capture_put_word(&capture->record[size], (uint32_t)status);
+        size += CAPTURE_WORD_LEN;
+    }
+
+    capture->frame_count++;
+    capture->write(capture->record, size, capture->user_data);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_replay_init
+********************************************************************************
+*
+* Initializes the capture stream reader and validates the stream header.
+*
+* \param replay
+* Pointer to the capture stream reader.
+*
+* \param data
+* Pointer to the capture stream.
+*
+* \param size
+* Capture stream size.
+*
+* \return bool
+* True if the stream header is valid, false otherwise.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_replay_init(mtb_ctp_ft5406_replay_t* replay,
+                                const uint8_t* data,
+                                uint32_t size)
+{
+    CY_ASSERT(NULL != replay);
+    CY_ASSERT(NULL != data);
+
+    replay->data   = data;
+    replay->size   = size;
+    replay->offset = MTB_CTP_FT5406_CAPTURE_HEADER_LEN;
+
+    return (MTB_CTP_FT5406_CAPTURE_HEADER_LEN <= size) &&
+           (0 == memcmp(data, MTB_CTP_FT5406_CAPTURE_MAGIC, CAPTURE_WORD_LEN)) &&
+           (MTB_CTP_FT5406_CAPTURE_VERSION == data[CAPTURE_WORD_LEN]);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_replay_next
+********************************************************************************
+*
+* Reads the next record of the capture stream. Pass the raw touch data of a
+* successful record to mtb_ctp_ft5406_decode_touch_data_ex() to run it through
+* the driver decode path without bus access.
+*
+* \param replay
+* Pointer to the capture stream reader.
+*
+* \param record
+* Pointer to the variable to store the record.
+*
+* \return bool
+* True if a record is read, false at the end of the stream or if the stream is
+* truncated or malformed. A record which is not read is not skipped.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_replay_next(mtb_ctp_ft5406_replay_t* replay,
+                                mtb_ctp_ft5406_capture_record_t* record)
+{
+    const uint8_t* data = &replay->data[replay->offset];
+    uint32_t remaining  = replay->size - replay->offset;
+    uint32_t data_len;
+    uint8_t tag;
+
+    CY_ASSERT(NULL != record);
+
+    if ((replay->offset >= replay->size) || ((1U + CAPTURE_WORD_LEN) > remaining))
+    {
+        return false;
+    }
+
+    tag = data[0];
+    if (0U != (MTB_CTP_FT5406_CAPTURE_TAG_ERROR & tag))
+    {
+        /* The error flag carries no length */
+        if (MTB_CTP_FT5406_CAPTURE_TAG_ERROR != tag)
+        {
+            return false;
+        }
+        data_len = CAPTURE_WORD_LEN;
+    }
+    else
+    {
+        /* The header and 1 to MTB_CTP_FT5406_MAX_TOUCHES whole touch points.
+         * The upper limit also rejects the unused tag bit. */
+        data_len = (uint32_t)tag;
+        if (((TOUCH_DATA_HEADER_LEN + TOUCH_POINT_LEN) > data_len) ||
+            ((TOUCH_DATA_HEADER_LEN + (MTB_CTP_FT5406_MAX_TOUCHES * TOUCH_POINT_LEN)) < data_len) ||
+            (0U != ((data_len - TOUCH_DATA_HEADER_LEN) % TOUCH_POINT_LEN)))
+        {
+            return false;
+        }
+    }
+
+    if ((1U + CAPTURE_WORD_LEN + data_len) > remaining)
+    {
+        return false;
+    }
+
+    record->timestamp = mtb_ctp_ft5406_capture_get_word(&data[1]);
+    (void)memset(record->touch_data, 0xFF, MTB_CTP_FT5406_TOUCH_DATA_LEN);
+
+    if (0U != (MTB_CTP_FT5406_CAPTURE_TAG_ERROR & tag))
+    {
+        record->status = (cy_en_scb_i2c_status_t)mtb_ctp_ft5406_capture_get_word(&data[5]);
+    }
+    else
+    {
+        record->status = CY_SCB_I2C_SUCCESS;
+        (void)memcpy(record->touch_data, &data[1U + CAPTURE_WORD_LEN], data_len);
+    }
+
+    replay->offset += 1U + CAPTURE_WORD_LEN + data_len;
+
+    return true;
+}
+
+
+/* [] END OF FILE */
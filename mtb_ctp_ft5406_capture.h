@@ -0,0 +1,116 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_capture.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for capturing raw
+* FT5406 touch frames into a binary stream and replaying them.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_CAPTURE_H
+#define MTB_CTP_FT5406_CAPTURE_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Capture stream header: "FT54" magic followed by the format version. */
+#define MTB_CTP_FT5406_CAPTURE_MAGIC          "FT54"
+#define MTB_CTP_FT5406_CAPTURE_VERSION        (1U)
+#define MTB_CTP_FT5406_CAPTURE_HEADER_LEN     (5U)
+
+/* Record tag: error flag and raw touch data length. */
+#define MTB_CTP_FT5406_CAPTURE_TAG_ERROR      (0x80U)
+#define MTB_CTP_FT5406_CAPTURE_TAG_LEN_MASK   (0x3FU)
+
+/* Longest record: tag, 32-bit timestamp, and full raw touch data. */
+#define MTB_CTP_FT5406_CAPTURE_RECORD_MAX_LEN (1U + 4U + MTB_CTP_FT5406_TOUCH_DATA_LEN)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Capture stream sink. Invoked from the touch read completion context. */
+typedef void (* mtb_ctp_ft5406_capture_write_t)(const uint8_t* data, uint32_t size,
+                                                void* user_data);
+
+/* Capture stream writer */
+struct mtb_ctp_ft5406_capture
+{
+    mtb_ctp_ft5406_capture_write_t write; /* Stream sink */
+    void* user_data;                      /* User data passed to the sink */
+    uint32_t frame_count;                 /* Number of captured records */
+    uint8_t record[MTB_CTP_FT5406_CAPTURE_RECORD_MAX_LEN]; /* Record staging buffer */
+};
+
+/* Captured touch frame */
+typedef struct
+{
+    uint32_t timestamp;                                    /* Read completion time in microseconds */
+    cy_en_scb_i2c_status_t status;                         /* Touch read status */
+    uint8_t touch_data[MTB_CTP_FT5406_TOUCH_DATA_LEN];     /* Raw touch data, 0xFF past the captured length */
+} mtb_ctp_ft5406_capture_record_t;
+
+/* Capture stream reader */
+typedef struct
+{
+    const uint8_t* data; /* Capture stream */
+    uint32_t size;       /* Capture stream size */
+    uint32_t offset;     /* Offset of the next record */
+} mtb_ctp_ft5406_replay_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void mtb_ctp_ft5406_capture_init(mtb_ctp_ft5406_capture_t* capture,
+                                 mtb_ctp_ft5406_capture_write_t write,
+                                 void* user_data);
+void mtb_ctp_ft5406_capture_frame(mtb_ctp_ft5406_capture_t* capture,
+                                  uint32_t timestamp,
+                                  cy_en_scb_i2c_status_t status,
+                                  const uint8_t* touch_data);
+bool mtb_ctp_ft5406_replay_init(mtb_ctp_ft5406_replay_t* replay,
+                                const uint8_t* data,
+                                uint32_t size);
+bool mtb_ctp_ft5406_replay_next(mtb_ctp_ft5406_replay_t* replay,
+                                mtb_ctp_ft5406_capture_record_t* record);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_CAPTURE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,219 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_frame_ring.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the lock-free single-producer/single-consumer
+* ring of decoded FT5406 touch frames.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_frame_ring.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define FRAME_RING_MASK                    (MTB_CTP_FT5406_FRAME_RING_SIZE - 1U)
+
+#define RESET_VAL                          (0U)
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_frame_ring_init
+********************************************************************************
+*
+* Initializes the frame ring. Must be called before the ring is attached to the
+* driver configuration.
+*
+* \param ring
+* Pointer to the frame ring.
+*
+* \param policy
+* Behavior when a frame is produced while the ring is full.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_frame_ring_init(mtb_ctp_ft5406_frame_ring_t* ring,
+                                    mtb_ctp_ft5406_ring_policy_t policy)
+{
+    uint32_t i;
+
+    CY_ASSERT(NULL != ring);
+
+    ring->policy         = policy;
+    ring->head           = RESET_VAL;
+    ring->tail           = RESET_VAL;
+    ring->dropped_newest = RESET_VAL;
+    ring->dropped_oldest = RESET_VAL;
+
+    for (i = 0U; i < MTB_CTP_FT5406_FRAME_RING_SIZE; i++)
+    {
+        ring->slots[i].sequence = RESET_VAL;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_frame_ring_push
+********************************************************************************
+*
+* Stores a frame in the ring. Must be called from the producer context only.
+*
+* \param ring
+* Pointer to the frame ring.
+*
+* \param frame
+* Pointer to the frame to store.
+*
+* \return bool
+* True if the frame is stored, false if it is dropped because the ring is full
+* and the policy is MTB_CTP_FT5406_RING_DROP_NEWEST.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_frame_ring_push(mtb_ctp_ft5406_frame_ring_t* ring,
+                                    const mtb_ctp_ft5406_frame_t* frame)
+{
+    uint32_t head = ring->head;
+    mtb_ctp_ft5406_frame_slot_t* slot = &ring->slots[head & FRAME_RING_MASK];
+
+    CY_ASSERT(NULL != frame);
+
+    if ((MTB_CTP_FT5406_RING_DROP_NEWEST == ring->policy) &&
+        ((head - ring->tail) >= MTB_CTP_FT5406_FRAME_RING_SIZE))
+    {
+        ring->dropped_newest++;
+        return false;
+    }
+
+    /* Mark the slot as being written so a concurrent pop discards its copy */
+    slot->sequence = RESET_VAL;
+    __DMB();
+
+    slot->frame = *frame;
+
+    __DMB();
+    slot->sequence = head + 1U;
+
+    /* Publish the frame */
+    __DMB();
+    ring->head = head + 1U;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_frame_ring_pop
+********************************************************************************
+*
+* Retrieves the oldest frame from the ring. Must be called from the consumer
+* context only. Neither locks nor disables interrupts: with the
+* MTB_CTP_FT5406_RING_DROP_OLDEST policy, a frame overwritten by the producer
+* during the copy is detected and skipped. The pop is not recorded in the
+* latency trace of the driver, see mtb_ctp_ft5406_pop_frame().
+*
+* \param ring
+* Pointer to the frame ring.
+*
+* \param frame
+* Pointer to the variable to store the frame.
+*
+* \return bool
+* True if a frame is retrieved, false if the ring is empty.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_frame_ring_pop(mtb_ctp_ft5406_frame_ring_t* ring,
+                                   mtb_ctp_ft5406_frame_t* frame)
+{
+    uint32_t tail = ring->tail;
+    uint32_t head;
+    uint32_t sequence;
+    const mtb_ctp_ft5406_frame_slot_t* slot;
+
+    CY_ASSERT(NULL != frame);
+
+    for (;;)
+    {
+        head = ring->head;
+        __DMB();
+
+        if (head == tail)
+        {
+            ring->tail = tail;
+            return false;
+        }
+
+        /* Skip the frames already overwritten by the producer */
+        if ((head - tail) > MTB_CTP_FT5406_FRAME_RING_SIZE)
+        {
+            ring->dropped_oldest += (head - tail) - MTB_CTP_FT5406_FRAME_RING_SIZE;
+            tail = head - MTB_CTP_FT5406_FRAME_RING_SIZE;
+        }
+
+        slot     = &ring->slots[tail & FRAME_RING_MASK];
+        sequence = slot->sequence;
+        __DMB();
+
+        *frame = slot->frame;
+
+        __DMB();
+        if ((sequence == (tail + 1U)) && (sequence == slot->sequence))
+        {
+            break;
+        }
+
+        /* The slot was overwritten during the copy */
+        ring->dropped_oldest++;
+        tail++;
+    }
+
+    /* Release the slot to the producer */
+    __DMB();
+    ring->tail = tail + 1U;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_frame_ring_get_overflows
+********************************************************************************
+*
+* Returns the number of frames lost because the ring was full.
+*
+* \param ring
+* Pointer to the frame ring.
+*
+* \return uint32_t
+* Number of dropped frames.
+*
+*******************************************************************************/
+uint32_t mtb_ctp_ft5406_frame_ring_get_overflows(const mtb_ctp_ft5406_frame_ring_t* ring)
+{
+    CY_ASSERT(NULL != ring);
+
+    return ring->dropped_newest + ring->dropped_oldest;
+}
+
+
+/* [] END OF FILE */
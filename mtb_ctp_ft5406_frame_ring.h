@@ -0,0 +1,114 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_frame_ring.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the lock-free
+* single-producer/single-consumer ring of decoded FT5406 touch frames.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_FRAME_RING_H
+#define MTB_CTP_FT5406_FRAME_RING_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of frames in the ring, must be a power of two. */
+#ifndef MTB_CTP_FT5406_FRAME_RING_SIZE
+#define MTB_CTP_FT5406_FRAME_RING_SIZE        (8U)
+#endif
+
+#if ((MTB_CTP_FT5406_FRAME_RING_SIZE & (MTB_CTP_FT5406_FRAME_RING_SIZE - 1U)) != 0U)
+#error "MTB_CTP_FT5406_FRAME_RING_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Behavior when a frame is produced while the ring is full */
+typedef enum
+{
+    MTB_CTP_FT5406_RING_DROP_NEWEST, /* The new frame is discarded. */
+    MTB_CTP_FT5406_RING_DROP_OLDEST  /* The oldest unread frame is overwritten. */
+} mtb_ctp_ft5406_ring_policy_t;
+
+/* Decoded touch frame */
+struct mtb_ctp_ft5406_frame
+{
+    uint32_t timestamp; /* Acquisition time in microseconds, 0 if no time source is set */
+    uint8_t touch_count; /* Number of valid touch points */
+    uint8_t gesture_id;  /* Hardware gesture ID, see MTB_CTP_FT5406_HW_GESTURE_NONE */
+    mtb_ctp_multi_touch_point_t touch_points[MTB_CTP_FT5406_MAX_TOUCHES]; /* Touch points */
+    uint32_t trace_frame; /* Latency trace frame number, if the driver has a trace */
+};
+
+/* Frame ring slot */
+typedef struct
+{
+    volatile uint32_t sequence; /* Index of the stored frame plus one, 0 while written */
+    mtb_ctp_ft5406_frame_t frame;
+} mtb_ctp_ft5406_frame_slot_t;
+
+/* Single-producer/single-consumer frame ring */
+struct mtb_ctp_ft5406_frame_ring
+{
+    mtb_ctp_ft5406_ring_policy_t policy;
+    volatile uint32_t head;           /* Written by the producer only */
+    volatile uint32_t tail;           /* Written by the consumer only */
+    volatile uint32_t dropped_newest; /* Written by the producer only */
+    volatile uint32_t dropped_oldest; /* Written by the consumer only */
+    mtb_ctp_ft5406_frame_slot_t slots[MTB_CTP_FT5406_FRAME_RING_SIZE];
+};
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void mtb_ctp_ft5406_frame_ring_init(mtb_ctp_ft5406_frame_ring_t* ring,
+                                    mtb_ctp_ft5406_ring_policy_t policy);
+bool mtb_ctp_ft5406_frame_ring_push(mtb_ctp_ft5406_frame_ring_t* ring,
+                                    const mtb_ctp_ft5406_frame_t* frame);
+bool mtb_ctp_ft5406_frame_ring_pop(mtb_ctp_ft5406_frame_ring_t* ring,
+                                   mtb_ctp_ft5406_frame_t* frame);
+uint32_t mtb_ctp_ft5406_frame_ring_get_overflows(const mtb_ctp_ft5406_frame_ring_t* ring);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_FRAME_RING_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,623 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_gesture.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the gesture recognizer running on the tracked
+* FT5406 contact events.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_gesture.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define GESTURE_QUEUE_MASK                 (MTB_CTP_FT5406_GESTURE_QUEUE_SIZE - 1U)
+
+#define RESET_VAL                          (0U)
+
+/* Fixed-point scale of pinch and rotation values */
+#define GESTURE_Q8_SHIFT                   (8U)
+#define GESTURE_Q8_ONE                     ((int32_t)1 << GESTURE_Q8_SHIFT)
+
+/* Default thresholds */
+#define DEFAULT_TAP_MAX_MOVE               (10U)
+#define DEFAULT_TAP_MAX_US                 (250000U)
+#define DEFAULT_DOUBLE_TAP_GAP_US          (300000U)
+#define DEFAULT_LONG_PRESS_US              (600000U)
+#define DEFAULT_SWIPE_MIN_MOVE             (80U)
+#define DEFAULT_SWIPE_MAX_US               (500000U)
+#define DEFAULT_PINCH_STEP                 (26U)
+#define DEFAULT_ROTATE_STEP                (66U)
+
+#define GESTURE_DEFAULT(VALUE, DEFAULT)    ((0U != (VALUE)) ? (VALUE) : (DEFAULT))
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_sqrt
+********************************************************************************
+*
+* Computes the integer square root.
+*
+* \param value
+* Value to compute the square root of.
+*
+* \return uint64_t
+* Largest integer whose square is not greater than value.
+*
+*******************************************************************************/
+static uint64_t mtb_ctp_ft5406_gesture_sqrt(uint64_t value)
+{
+    uint64_t root = RESET_VAL;
+    uint64_t bit  = 1ULL << 62U;
+
+    while (bit > value)
+    {
+        bit >>= 2U;
+    }
+
+    while (0U != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root   = (root >> 1U) + bit;
+        }
+        else
+        {
+            root >>= 1U;
+        }
+        bit >>= 2U;
+    }
+
+    return root;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_distance
+********************************************************************************
+*
+* Returns the distance of two coordinates.
+*
+* \param a
+* First coordinate.
+*
+* \param b
+* Second coordinate.
+*
+* \return uint32_t
+* Absolute difference of the coordinates.
+*
+*******************************************************************************/
+static inline uint32_t mtb_ctp_ft5406_gesture_distance(uint16_t a, uint16_t b)
+{
+    return (a > b) ? (uint32_t)(a - b) : (uint32_t)(b - a);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_length
+********************************************************************************
+*
+* Returns the length of a finger vector. The squared length of coordinates
+* across the full 16-bit range needs 64 bits, the length fits 32 bits.
+*
+* \param dx
+* X component of the vector.
+*
+* \param dy
+* Y component of the vector.
+*
+* \return uint32_t
+* Length of the vector, rounded down.
+*
+*******************************************************************************/
+static uint32_t mtb_ctp_ft5406_gesture_length(int32_t dx, int32_t dy)
+{
+    return (uint32_t)mtb_ctp_ft5406_gesture_sqrt((uint64_t)((int64_t)dx * dx) +
+                                                 (uint64_t)((int64_t)dy * dy));
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_push
+********************************************************************************
+*
+* Stores a gesture event in the queue. The event is dropped if the queue is
+* full.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param type
+* Recognized gesture.
+*
+* \param timestamp
+* Time of the frame completing the gesture.
+*
+* \param x
+* X position of the gesture.
+*
+* \param y
+* Y position of the gesture.
+*
+* \param value
+* Gesture value, see mtb_ctp_ft5406_gesture_event_t.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_gesture_push(mtb_ctp_ft5406_gesture_t* gesture,
+                                        mtb_ctp_ft5406_gesture_type_t type,
+                                        uint32_t timestamp,
+                                        uint16_t x,
+                                        uint16_t y,
+                                        int32_t value)
+{
+    mtb_ctp_ft5406_gesture_event_t* event;
+
+    if ((gesture->head - gesture->tail) >= MTB_CTP_FT5406_GESTURE_QUEUE_SIZE)
+    {
+        gesture->dropped++;
+    }
+    else
+    {
+        event = &gesture->events[gesture->head & GESTURE_QUEUE_MASK];
+        event->type      = type;
+        event->timestamp = timestamp;
+        event->x         = x;
+        event->y         = y;
+        event->value     = value;
+        gesture->head++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_finish_primary
+********************************************************************************
+*
+* Recognizes a swipe, tap, or double tap when the single finger is lifted.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param timestamp
+* Time of the frame.
+*
+* \param event
+* Pointer to the contact up event of the finger.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_gesture_finish_primary(mtb_ctp_ft5406_gesture_t* gesture,
+                                                  uint32_t timestamp,
+                                                  const mtb_ctp_ft5406_track_event_t* event)
+{
+    const mtb_ctp_ft5406_gesture_config_t* config = &gesture->config;
+    uint32_t duration = timestamp - gesture->primary_time;
+    uint32_t move_x = mtb_ctp_ft5406_gesture_distance(event->touch_x, gesture->primary_down_x);
+    uint32_t move_y = mtb_ctp_ft5406_gesture_distance(event->touch_y, gesture->primary_down_y);
+    mtb_ctp_ft5406_gesture_type_t type;
+    int32_t velocity;
+
+    if ((((move_x > move_y) ? move_x : move_y) >= config->swipe_min_move) &&
+        (duration <= config->swipe_max_us))
+    {
+        /* Swipe along the dominant axis */
+        if (move_x >= move_y)
+        {
+            type = (event->touch_x > gesture->primary_down_x) ?
+                   MTB_CTP_FT5406_GESTURE_SWIPE_RIGHT : MTB_CTP_FT5406_GESTURE_SWIPE_LEFT;
+            velocity = event->velocity_x;
+        }
+        else
+        {
+            type = (event->touch_y > gesture->primary_down_y) ?
+                   MTB_CTP_FT5406_GESTURE_SWIPE_DOWN : MTB_CTP_FT5406_GESTURE_SWIPE_UP;
+            velocity = event->velocity_y;
+        }
+
+        mtb_ctp_ft5406_gesture_push(gesture, type, timestamp, event->touch_x, event->touch_y,
+                                    (velocity < 0) ? -velocity : velocity);
+        gesture->tap_valid = false;
+    }
+    else if (!gesture->primary_moved && (duration <= config->tap_max_us))
+    {
+        mtb_ctp_ft5406_gesture_push(gesture, MTB_CTP_FT5406_GESTURE_TAP, timestamp,
+                                    event->touch_x, event->touch_y, 0);
+
+        if (gesture->tap_valid &&
+            ((timestamp - gesture->tap_time) <= config->double_tap_gap_us) &&
+            (mtb_ctp_ft5406_gesture_distance(event->touch_x, gesture->tap_x) <=
+             (2U * config->tap_max_move)) &&
+            (mtb_ctp_ft5406_gesture_distance(event->touch_y, gesture->tap_y) <=
+             (2U * config->tap_max_move)))
+        {
+            mtb_ctp_ft5406_gesture_push(gesture, MTB_CTP_FT5406_GESTURE_DOUBLE_TAP, timestamp,
+                                        event->touch_x, event->touch_y, 0);
+            gesture->tap_valid = false;
+        }
+        else
+        {
+            gesture->tap_valid = true;
+            gesture->tap_time  = timestamp;
+            gesture->tap_x     = event->touch_x;
+            gesture->tap_y     = event->touch_y;
+        }
+    }
+    else
+    {
+        /* Drag or slow movement is no gesture */
+        gesture->tap_valid = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_start_pair
+********************************************************************************
+*
+* Takes the current finger vector as reference of a two finger gesture.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_gesture_start_pair(mtb_ctp_ft5406_gesture_t* gesture)
+{
+    int32_t dx = (int32_t)gesture->pair_x[1] - (int32_t)gesture->pair_x[0];
+    int32_t dy = (int32_t)gesture->pair_y[1] - (int32_t)gesture->pair_y[0];
+    uint32_t length = mtb_ctp_ft5406_gesture_length(dx, dy);
+
+    gesture->pair_active       = true;
+    gesture->pair_moved        = false;
+    gesture->pair_start_length = length;
+    gesture->pair_scale        = GESTURE_Q8_ONE;
+    gesture->pair_ref_dx       = dx;
+    gesture->pair_ref_dy       = dy;
+    gesture->pair_ref_length   = length;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_update_pair
+********************************************************************************
+*
+* Recognizes pinch and rotation of the two fingers. The rotation is measured
+* with the cross product of the reference and the current finger vector, so
+* no trigonometric functions are needed.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param timestamp
+* Time of the frame.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_gesture_update_pair(mtb_ctp_ft5406_gesture_t* gesture,
+                                               uint32_t timestamp)
+{
+    const mtb_ctp_ft5406_gesture_config_t* config = &gesture->config;
+    int32_t dx = (int32_t)gesture->pair_x[1] - (int32_t)gesture->pair_x[0];
+    int32_t dy = (int32_t)gesture->pair_y[1] - (int32_t)gesture->pair_y[0];
+    uint32_t length = mtb_ctp_ft5406_gesture_length(dx, dy);
+    uint16_t center_x = (uint16_t)(((uint32_t)gesture->pair_x[0] + gesture->pair_x[1]) / 2U);
+    uint16_t center_y = (uint16_t)(((uint32_t)gesture->pair_y[0] + gesture->pair_y[1]) / 2U);
+    int32_t scale;
+    int32_t sine;
+    int32_t step;
+
+    if (0U != gesture->pair_start_length)
+    {
+        scale = (int32_t)((length << GESTURE_Q8_SHIFT) / gesture->pair_start_length);
+        step  = scale - gesture->pair_scale;
+
+        if (((step < 0) ? -step : step) >= (int32_t)config->pinch_step)
+        {
+            mtb_ctp_ft5406_gesture_push(gesture, MTB_CTP_FT5406_GESTURE_PINCH, timestamp,
+                                        center_x, center_y, scale);
+            gesture->pair_scale = scale;
+        }
+    }
+
+    if ((0U != gesture->pair_ref_length) && (0U != length))
+    {
+        /* Sine of the angle between reference and current vector, Q8 */
+        sine = (int32_t)((((int64_t)gesture->pair_ref_dx * dy) -
+                          ((int64_t)gesture->pair_ref_dy * dx)) * GESTURE_Q8_ONE /
+                         ((int64_t)gesture->pair_ref_length * length));
+
+        if ((sine >= (int32_t)config->rotate_step) || (sine <= -(int32_t)config->rotate_step))
+        {
+            /* Y grows downwards, so a positive cross product is clockwise */
+            mtb_ctp_ft5406_gesture_push(gesture, MTB_CTP_FT5406_GESTURE_ROTATE, timestamp,
+                                        center_x, center_y, (sine > 0) ? 1 : -1);
+            gesture->pair_ref_dx     = dx;
+            gesture->pair_ref_dy     = dy;
+            gesture->pair_ref_length = length;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_init
+********************************************************************************
+*
+* Initializes the gesture recognizer with no contact down and an empty event
+* queue.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param config
+* Pointer to the thresholds, NULL for the default thresholds. Zero members
+* select the default value.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_gesture_init(mtb_ctp_ft5406_gesture_t* gesture,
+                                 const mtb_ctp_ft5406_gesture_config_t* config)
+{
+    static const mtb_ctp_ft5406_gesture_config_t default_config = { 0U };
+
+    CY_ASSERT(NULL != gesture);
+
+    if (NULL == config)
+    {
+        config = &default_config;
+    }
+
+    gesture->config.tap_max_move      = GESTURE_DEFAULT(config->tap_max_move,
+                                                        DEFAULT_TAP_MAX_MOVE);
+    gesture->config.tap_max_us        = GESTURE_DEFAULT(config->tap_max_us,
+                                                        DEFAULT_TAP_MAX_US);
+    gesture->config.double_tap_gap_us = GESTURE_DEFAULT(config->double_tap_gap_us,
+                                                        DEFAULT_DOUBLE_TAP_GAP_US);
+    gesture->config.long_press_us     = GESTURE_DEFAULT(config->long_press_us,
+                                                        DEFAULT_LONG_PRESS_US);
+    gesture->config.swipe_min_move    = GESTURE_DEFAULT(config->swipe_min_move,
+                                                        DEFAULT_SWIPE_MIN_MOVE);
+    gesture->config.swipe_max_us      = GESTURE_DEFAULT(config->swipe_max_us,
+                                                        DEFAULT_SWIPE_MAX_US);
+    gesture->config.pinch_step        = GESTURE_DEFAULT(config->pinch_step,
+                                                        DEFAULT_PINCH_STEP);
+    gesture->config.rotate_step       = GESTURE_DEFAULT(config->rotate_step,
+                                                        DEFAULT_ROTATE_STEP);
+
+    gesture->contact_count = RESET_VAL;
+    gesture->primary_down  = false;
+    gesture->tap_valid     = false;
+    gesture->pair_active   = false;
+    gesture->head          = RESET_VAL;
+    gesture->tail          = RESET_VAL;
+    gesture->dropped       = RESET_VAL;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_update
+********************************************************************************
+*
+* Updates the recognizer with the contact events of one frame from
+* mtb_ctp_ft5406_tracker_update(). Must be called for every frame, also
+* without events, so that long presses are recognized. The work per frame is
+* bounded by MTB_CTP_FT5406_TRACKER_MAX_EVENTS.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param timestamp
+* Acquisition time of the frame in microseconds.
+*
+* \param events
+* Contact events of the frame.
+*
+* \param event_count
+* Number of contact events.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_gesture_update(mtb_ctp_ft5406_gesture_t* gesture,
+                                   uint32_t timestamp,
+                                   const mtb_ctp_ft5406_track_event_t* events,
+                                   uint32_t event_count)
+{
+    const mtb_ctp_ft5406_track_event_t* event;
+    uint32_t i;
+    uint32_t k;
+
+    CY_ASSERT(NULL != gesture);
+    CY_ASSERT((NULL != events) || (0U == event_count));
+
+    for (i = 0U; i < event_count; i++)
+    {
+        event = &events[i];
+
+        switch (event->touch_event)
+        {
+            case MTB_CTP_TOUCH_DOWN:
+                gesture->contact_count++;
+
+                if (1U == gesture->contact_count)
+                {
+                    gesture->primary_id     = event->touch_id;
+                    gesture->primary_down   = true;
+                    gesture->primary_done   = false;
+                    gesture->primary_moved  = false;
+                    gesture->primary_time   = timestamp;
+                    gesture->primary_down_x = event->touch_x;
+                    gesture->primary_down_y = event->touch_y;
+                    gesture->primary_x      = event->touch_x;
+                    gesture->primary_y      = event->touch_y;
+                }
+                else if ((2U == gesture->contact_count) && gesture->primary_down)
+                {
+                    /* Second finger turns the gesture into a two finger gesture */
+                    gesture->primary_done = true;
+                    gesture->tap_valid    = false;
+                    gesture->pair_id[0]   = gesture->primary_id;
+                    gesture->pair_x[0]    = gesture->primary_x;
+                    gesture->pair_y[0]    = gesture->primary_y;
+                    gesture->pair_id[1]   = event->touch_id;
+                    gesture->pair_x[1]    = event->touch_x;
+                    gesture->pair_y[1]    = event->touch_y;
+                    mtb_ctp_ft5406_gesture_start_pair(gesture);
+                }
+                else
+                {
+                    /* Further fingers are ignored */
+                }
+                break;
+
+            case MTB_CTP_TOUCH_CONTACT:
+                if (gesture->primary_down && (event->touch_id == gesture->primary_id))
+                {
+                    gesture->primary_x = event->touch_x;
+                    gesture->primary_y = event->touch_y;
+
+                    if ((mtb_ctp_ft5406_gesture_distance(event->touch_x, gesture->primary_down_x) >
+                         gesture->config.tap_max_move) ||
+                        (mtb_ctp_ft5406_gesture_distance(event->touch_y, gesture->primary_down_y) >
+                         gesture->config.tap_max_move))
+                    {
+                        gesture->primary_moved = true;
+                    }
+                }
+
+                if (gesture->pair_active)
+                {
+                    for (k = 0U; k < 2U; k++)
+                    {
+                        if (event->touch_id == gesture->pair_id[k])
+                        {
+                            gesture->pair_x[k]  = event->touch_x;
+                            gesture->pair_y[k]  = event->touch_y;
+                            gesture->pair_moved = true;
+                        }
+                    }
+                }
+                break;
+
+            case MTB_CTP_TOUCH_UP:
+                if (0U != gesture->contact_count)
+                {
+                    gesture->contact_count--;
+                }
+
+                if (gesture->pair_active &&
+                    ((event->touch_id == gesture->pair_id[0]) ||
+                     (event->touch_id == gesture->pair_id[1])))
+                {
+                    gesture->pair_active = false;
+                }
+
+                if (gesture->primary_down && (event->touch_id == gesture->primary_id))
+                {
+                    gesture->primary_down = false;
+
+                    if (!gesture->primary_done)
+                    {
+                        mtb_ctp_ft5406_gesture_finish_primary(gesture, timestamp, event);
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (gesture->pair_active && gesture->pair_moved)
+    {
+        gesture->pair_moved = false;
+        mtb_ctp_ft5406_gesture_update_pair(gesture, timestamp);
+    }
+
+    if (gesture->primary_down && !gesture->primary_done && !gesture->primary_moved &&
+        ((timestamp - gesture->primary_time) >= gesture->config.long_press_us))
+    {
+        mtb_ctp_ft5406_gesture_push(gesture, MTB_CTP_FT5406_GESTURE_LONG_PRESS, timestamp,
+                                    gesture->primary_x, gesture->primary_y, 0);
+        gesture->primary_done = true;
+        gesture->tap_valid    = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_pop
+********************************************************************************
+*
+* Retrieves the oldest gesture event from the queue.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \param event
+* Pointer to the variable to store the gesture event.
+*
+* \return bool
+* True if an event is retrieved, false if the queue is empty.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_gesture_pop(mtb_ctp_ft5406_gesture_t* gesture,
+                                mtb_ctp_ft5406_gesture_event_t* event)
+{
+    bool result = false;
+
+    CY_ASSERT(NULL != gesture);
+    CY_ASSERT(NULL != event);
+
+    if (gesture->head != gesture->tail)
+    {
+        *event = gesture->events[gesture->tail & GESTURE_QUEUE_MASK];
+        gesture->tail++;
+        result = true;
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_gesture_get_overflows
+********************************************************************************
+*
+* Returns the number of gesture events dropped because the queue was full.
+*
+* \param gesture
+* Pointer to the gesture recognizer.
+*
+* \return uint32_t
+* Number of dropped gesture events.
+*
+*******************************************************************************/
+uint32_t mtb_ctp_ft5406_gesture_get_overflows(const mtb_ctp_ft5406_gesture_t* gesture)
+{
+    CY_ASSERT(NULL != gesture);
+
+    return gesture->dropped;
+}
+
+
+/* [] END OF FILE */
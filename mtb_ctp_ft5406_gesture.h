@@ -0,0 +1,161 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_gesture.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the gesture
+* recognizer running on the tracked FT5406 contact events.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_GESTURE_H
+#define MTB_CTP_FT5406_GESTURE_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_tracker.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of gesture events in the queue, must be a power of two. */
+#ifndef MTB_CTP_FT5406_GESTURE_QUEUE_SIZE
+#define MTB_CTP_FT5406_GESTURE_QUEUE_SIZE     (8U)
+#endif
+
+#if ((MTB_CTP_FT5406_GESTURE_QUEUE_SIZE & (MTB_CTP_FT5406_GESTURE_QUEUE_SIZE - 1U)) != 0U)
+#error "MTB_CTP_FT5406_GESTURE_QUEUE_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Recognized gesture */
+typedef enum
+{
+    MTB_CTP_FT5406_GESTURE_TAP,         /* Short touch without movement. */
+    MTB_CTP_FT5406_GESTURE_DOUBLE_TAP,  /* Second tap close to the previous one. */
+    MTB_CTP_FT5406_GESTURE_LONG_PRESS,  /* Touch held without movement. */
+    MTB_CTP_FT5406_GESTURE_SWIPE_UP,    /* Fast single finger movement up. */
+    MTB_CTP_FT5406_GESTURE_SWIPE_DOWN,  /* Fast single finger movement down. */
+    MTB_CTP_FT5406_GESTURE_SWIPE_LEFT,  /* Fast single finger movement left. */
+    MTB_CTP_FT5406_GESTURE_SWIPE_RIGHT, /* Fast single finger movement right. */
+    MTB_CTP_FT5406_GESTURE_PINCH,       /* Two finger distance changed. */
+    MTB_CTP_FT5406_GESTURE_ROTATE       /* Two finger angle changed. */
+} mtb_ctp_ft5406_gesture_type_t;
+
+/* Gesture event */
+typedef struct
+{
+    mtb_ctp_ft5406_gesture_type_t type;
+    uint32_t timestamp; /* Time of the frame completing the gesture */
+    uint16_t x;         /* Position of the touch, or center of two finger gestures */
+    uint16_t y;
+    int32_t value;      /* PINCH: finger distance relative to the gesture start in Q24.8,
+                           ROTATE: 1 clockwise, -1 counterclockwise,
+                           SWIPE: velocity in counts per millisecond in Q24.8, else 0 */
+} mtb_ctp_ft5406_gesture_event_t;
+
+/* Gesture recognizer thresholds. Zero members select the default values. */
+typedef struct
+{
+    uint16_t tap_max_move;      /* Movement in counts still recognized as tap (10) */
+    uint32_t tap_max_us;        /* Longest tap (250 ms) */
+    uint32_t double_tap_gap_us; /* Longest time between the taps of a double tap (300 ms) */
+    uint32_t long_press_us;     /* Shortest long press (600 ms) */
+    uint16_t swipe_min_move;    /* Shortest swipe movement in counts (80) */
+    uint32_t swipe_max_us;      /* Longest swipe (500 ms) */
+    uint16_t pinch_step;        /* Distance change in Q8 reported as pinch (26, about 10 %) */
+    uint16_t rotate_step;       /* Sine of the angle reported as rotation in Q8 (66, about 15
+                                   degrees) */
+} mtb_ctp_ft5406_gesture_config_t;
+
+/* Gesture recognizer */
+typedef struct
+{
+    mtb_ctp_ft5406_gesture_config_t config;
+    uint8_t contact_count;      /* Contacts down */
+
+    /* Single finger gestures */
+    uint8_t primary_id;
+    bool primary_down;
+    bool primary_done;          /* Moved, long pressed, or joined by a second finger */
+    bool primary_moved;
+    uint32_t primary_time;
+    uint16_t primary_down_x;
+    uint16_t primary_down_y;
+    uint16_t primary_x;
+    uint16_t primary_y;
+    bool tap_valid;
+    uint32_t tap_time;
+    uint16_t tap_x;
+    uint16_t tap_y;
+
+    /* Two finger gestures */
+    bool pair_active;
+    bool pair_moved;
+    uint8_t pair_id[2];
+    uint16_t pair_x[2];
+    uint16_t pair_y[2];
+    uint32_t pair_start_length;  /* Finger distance at the gesture start */
+    int32_t pair_scale;          /* Last reported scale, Q8 */
+    int32_t pair_ref_dx;         /* Finger vector at the last reported rotation */
+    int32_t pair_ref_dy;
+    uint32_t pair_ref_length;
+
+    /* Event queue */
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+    mtb_ctp_ft5406_gesture_event_t events[MTB_CTP_FT5406_GESTURE_QUEUE_SIZE];
+} mtb_ctp_ft5406_gesture_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void mtb_ctp_ft5406_gesture_init(mtb_ctp_ft5406_gesture_t* gesture,
+                                 const mtb_ctp_ft5406_gesture_config_t* config);
+void mtb_ctp_ft5406_gesture_update(mtb_ctp_ft5406_gesture_t* gesture,
+                                   uint32_t timestamp,
+                                   const mtb_ctp_ft5406_track_event_t* events,
+                                   uint32_t event_count);
+bool mtb_ctp_ft5406_gesture_pop(mtb_ctp_ft5406_gesture_t* gesture,
+                                mtb_ctp_ft5406_gesture_event_t* event);
+uint32_t mtb_ctp_ft5406_gesture_get_overflows(const mtb_ctp_ft5406_gesture_t* gesture);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_GESTURE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_internal.h
+*
+* \brief
+* Provides constants shared by the FT5406 driver library sources. Not part of
+* the library API.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_INTERNAL_H
+#define MTB_CTP_FT5406_INTERNAL_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Raw touch data layout: GEST_ID, TD_STATUS, then touch points */
+#define TOUCH_DATA_HEADER_LEN              (2U)
+#define TOUCH_DATA_COUNT_OFFSET            (1U)
+#define TOUCH_POINT_LEN                    (sizeof(mtb_ctp_ft5406_touch_point_t))
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_INTERNAL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,357 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_scheduler.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the activity adaptive touch polling scheduler of
+* the FT5406.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_scheduler.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Default poll periods and idle hysteresis */
+#define DEFAULT_ACTIVE_POLL_US             (10000U)
+#define DEFAULT_IDLE_POLL_US               (100000U)
+#define DEFAULT_IDLE_AFTER_US              (500000U)
+
+#define SCHEDULER_DEFAULT(VALUE, DEFAULT)  ((0U != (VALUE)) ? (VALUE) : (DEFAULT))
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_set_period
+********************************************************************************
+*
+* Writes the FT5406 report period in Active mode if the period is configured
+* and no previous write failed.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param i2c_status
+* Status of the previous writes.
+*
+* \param period
+* Report period, 0 to leave the register unchanged.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the writes.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_set_period(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                                  cy_en_scb_i2c_status_t i2c_status,
+                                                                  uint8_t period)
+{
+    if ((CY_SCB_I2C_SUCCESS == i2c_status) && (0U != period))
+    {
+        i2c_status = mtb_ctp_ft5406_set_report_period_ex(scheduler->ft5406, period);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_set_active
+********************************************************************************
+*
+* Switches the scheduler and the FT5406 report rate between active and idle.
+* The scheduler changes state only once the register writes succeed, so a
+* failed switch is retried on the next update.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param active
+* True when contact is detected, false when the panel becomes idle.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the register writes.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_set_active(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                                  bool active)
+{
+    const mtb_ctp_ft5406_scheduler_config_t* config = &scheduler->config;
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    if (active)
+    {
+        if (config->monitor_when_idle)
+        {
+            i2c_status = mtb_ctp_ft5406_set_power_mode_ex(scheduler->ft5406,
+                                                          MTB_CTP_FT5406_PMODE_ACTIVE);
+        }
+        i2c_status = mtb_ctp_ft5406_scheduler_set_period(scheduler, i2c_status,
+                                                         config->active_period);
+    }
+    else
+    {
+        i2c_status = mtb_ctp_ft5406_scheduler_set_period(scheduler, i2c_status,
+                                                         config->idle_period);
+        if ((CY_SCB_I2C_SUCCESS == i2c_status) && config->monitor_when_idle)
+        {
+            /* The FT5406 returns to active mode by itself when touched */
+            i2c_status = mtb_ctp_ft5406_set_power_mode_ex(scheduler->ft5406,
+                                                          MTB_CTP_FT5406_PMODE_MONITOR);
+        }
+    }
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        scheduler->active = active;
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_init
+********************************************************************************
+*
+* Initializes the scheduler in the active state with the first poll due
+* immediately, and writes the report rate and power mode settings to the
+* FT5406. The FT5406 instance must be initialized.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param ft5406
+* Pointer to the FT5406 instance.
+*
+* \param config
+* Pointer to the scheduler settings, NULL for the default settings.
+*
+* \param now
+* Current time in microseconds.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the register writes.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_init(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                     mtb_ctp_ft5406_config_t* ft5406,
+                                                     const mtb_ctp_ft5406_scheduler_config_t* config,
+                                                     uint32_t now)
+{
+    static const mtb_ctp_ft5406_scheduler_config_t default_config = { 0U };
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != scheduler);
+    CY_ASSERT(NULL != ft5406);
+
+    if (NULL == config)
+    {
+        config = &default_config;
+    }
+
+    scheduler->ft5406 = ft5406;
+    scheduler->config = *config;
+    scheduler->config.active_poll_us = SCHEDULER_DEFAULT(config->active_poll_us,
+                                                         DEFAULT_ACTIVE_POLL_US);
+    scheduler->config.idle_poll_us   = SCHEDULER_DEFAULT(config->idle_poll_us,
+                                                         DEFAULT_IDLE_POLL_US);
+    scheduler->config.idle_after_us  = SCHEDULER_DEFAULT(config->idle_after_us,
+                                                         DEFAULT_IDLE_AFTER_US);
+    scheduler->active       = false;
+    scheduler->last_contact = now;
+    scheduler->deadline     = now;
+
+    if (0U != config->monitor_period)
+    {
+        i2c_status = mtb_ctp_ft5406_set_monitor_period_ex(ft5406, config->monitor_period);
+    }
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        i2c_status = mtb_ctp_ft5406_set_auto_monitor_ex(ft5406, config->monitor_after_s);
+    }
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        i2c_status = mtb_ctp_ft5406_scheduler_set_active(scheduler, true);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_update
+********************************************************************************
+*
+* Updates the scheduler with the touch count of a frame and schedules the next
+* poll. Contact switches to the active state at once; the scheduler becomes
+* idle after idle_after_us without contact. Use this function when frames are
+* read by other means, e.g. in event mode or with non-blocking reads.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param now
+* Time of the frame in microseconds.
+*
+* \param touch_count
+* Number of touch points of the frame.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the register writes on a change between active and idle.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_update(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                       uint32_t now,
+                                                       int touch_count)
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != scheduler);
+
+    if (0 < touch_count)
+    {
+        scheduler->last_contact = now;
+
+        if (!scheduler->active)
+        {
+            i2c_status = mtb_ctp_ft5406_scheduler_set_active(scheduler, true);
+        }
+    }
+    else if (scheduler->active &&
+             ((now - scheduler->last_contact) >= scheduler->config.idle_after_us))
+    {
+        i2c_status = mtb_ctp_ft5406_scheduler_set_active(scheduler, false);
+    }
+    else
+    {
+        /* No change */
+    }
+
+    scheduler->deadline = now + (scheduler->active ? scheduler->config.active_poll_us :
+                                 scheduler->config.idle_poll_us);
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_poll
+********************************************************************************
+*
+* Reads the touch points and updates the scheduler with them. Call this
+* function when the poll deadline is reached.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param now
+* Current time in microseconds.
+*
+* \param touch_count
+* Pointer to the variable to store the number of touch points.
+*
+* \param touch_array
+* Pointer to the array to store the touch points.
+*
+* \return cy_en_scb_i2c_status_t
+* Status of the touch read, or of the register writes if the read succeeded.
+*
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_poll(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                     uint32_t now,
+                                                     int* touch_count,
+                                                     mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    cy_en_scb_i2c_status_t i2c_status = CY_SCB_I2C_SUCCESS;
+
+    CY_ASSERT(NULL != scheduler);
+    CY_ASSERT(NULL != touch_count);
+
+    i2c_status = mtb_ctp_ft5406_get_multi_touch_ex(scheduler->ft5406, touch_count, touch_array);
+
+    if (CY_SCB_I2C_SUCCESS == i2c_status)
+    {
+        i2c_status = mtb_ctp_ft5406_scheduler_update(scheduler, now, *touch_count);
+    }
+    else
+    {
+        /* Try again after the current period */
+        scheduler->deadline = now + (scheduler->active ? scheduler->config.active_poll_us :
+                                     scheduler->config.idle_poll_us);
+    }
+
+    return i2c_status;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_next_poll_deadline
+********************************************************************************
+*
+* Returns the time of the next poll, e.g. to program a timer or to compute the
+* RTOS delay of the polling task.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \return uint32_t
+* Time of the next poll in microseconds.
+*
+*******************************************************************************/
+uint32_t mtb_ctp_ft5406_scheduler_next_poll_deadline(const mtb_ctp_ft5406_scheduler_t* scheduler)
+{
+    CY_ASSERT(NULL != scheduler);
+
+    return scheduler->deadline;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_scheduler_is_due
+********************************************************************************
+*
+* Checks whether the next poll is due. The comparison is valid across the
+* wrap-around of the time source.
+*
+* \param scheduler
+* Pointer to the scheduler.
+*
+* \param now
+* Current time in microseconds.
+*
+* \return bool
+* True if the poll deadline is reached.
+*
+*******************************************************************************/
+bool mtb_ctp_ft5406_scheduler_is_due(const mtb_ctp_ft5406_scheduler_t* scheduler, uint32_t now)
+{
+    CY_ASSERT(NULL != scheduler);
+
+    return ((int32_t)(now - scheduler->deadline) >= 0);
+}
+
+
+/* [] END OF FILE */
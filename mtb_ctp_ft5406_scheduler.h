@@ -0,0 +1,97 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_scheduler.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the activity
+* adaptive touch polling scheduler of the FT5406.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_SCHEDULER_H
+#define MTB_CTP_FT5406_SCHEDULER_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Scheduler settings. Zero poll periods select the default values, zero
+ * register values leave the FT5406 register unchanged. */
+typedef struct
+{
+    uint32_t active_poll_us;   /* Poll period while touched (10 ms) */
+    uint32_t idle_poll_us;     /* Poll period while idle (100 ms) */
+    uint32_t idle_after_us;    /* Time without contact before going idle (500 ms) */
+    uint8_t active_period;     /* PERIODACTIVE report period while touched */
+    uint8_t idle_period;       /* PERIODACTIVE report period while idle */
+    uint8_t monitor_period;    /* PERIODMONITOR report period in monitor mode */
+    uint8_t monitor_after_s;   /* Seconds without contact before the FT5406 enters monitor
+                                  mode by itself, 0 keeps it active */
+    bool monitor_when_idle;    /* Switch the FT5406 to monitor mode when idle */
+} mtb_ctp_ft5406_scheduler_config_t;
+
+/* Activity adaptive polling scheduler */
+typedef struct
+{
+    mtb_ctp_ft5406_config_t* ft5406;   /* FT5406 instance */
+    mtb_ctp_ft5406_scheduler_config_t config;
+    bool active;                       /* Contact seen within idle_after_us */
+    uint32_t last_contact;             /* Time of the last frame with contact */
+    uint32_t deadline;                 /* Time of the next poll */
+} mtb_ctp_ft5406_scheduler_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_init(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                     mtb_ctp_ft5406_config_t* ft5406,
+                                                     const mtb_ctp_ft5406_scheduler_config_t* config,
+                                                     uint32_t now);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_update(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                       uint32_t now,
+                                                       int touch_count);
+cy_en_scb_i2c_status_t mtb_ctp_ft5406_scheduler_poll(mtb_ctp_ft5406_scheduler_t* scheduler,
+                                                     uint32_t now,
+                                                     int* touch_count,
+                                                     mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES]);
+uint32_t mtb_ctp_ft5406_scheduler_next_poll_deadline(const mtb_ctp_ft5406_scheduler_t* scheduler);
+bool mtb_ctp_ft5406_scheduler_is_due(const mtb_ctp_ft5406_scheduler_t* scheduler, uint32_t now);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_SCHEDULER_H */
+
+
+/* [] END OF FILE */
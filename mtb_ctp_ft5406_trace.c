@@ -0,0 +1,251 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_trace.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the end-to-end touch latency trace of the FT5406.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_trace.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define RESET_VAL                          (0U)
+
+/* Percentile index in a sorted array of COUNT durations */
+#define TRACE_PERCENTILE(COUNT, PERCENT)   ((((COUNT) - 1U) * (PERCENT)) / 100U)
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_trace_init
+********************************************************************************
+*
+* Initializes the trace with no recorded frames. Attach the trace to the driver
+* configuration together with a timestamp source to trace every touch read.
+*
+* \param trace
+* Pointer to the trace.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_trace_init(mtb_ctp_ft5406_trace_t* trace)
+{
+    CY_ASSERT(NULL != trace);
+
+    trace->head   = RESET_VAL;
+    trace->count  = RESET_VAL;
+    trace->frames = RESET_VAL;
+    trace->picked = RESET_VAL;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_trace_frame
+********************************************************************************
+*
+* Records the stages of a decoded touch frame, overwriting the oldest record
+* when the trace is full. The pickup stages are completed by
+* mtb_ctp_ft5406_trace_pickup(). Called by the driver on touch read completion.
+*
+* \param trace
+* Pointer to the trace.
+*
+* \param request_time
+* Time of the INT assertion, or of the read request in polling mode.
+*
+* \param start_time
+* Time the touch read transfer was started on the bus.
+*
+* \param complete_time
+* Time the touch read transfer completed.
+*
+* \param decode_time
+* Time the frame was decoded.
+*
+* \return uint32_t
+* Number of the traced frame, which identifies it for the pickup.
+*
+*******************************************************************************/
+uint32_t mtb_ctp_ft5406_trace_frame(mtb_ctp_ft5406_trace_t* trace,
+                                    uint32_t request_time,
+                                    uint32_t start_time,
+                                    uint32_t complete_time,
+                                    uint32_t decode_time)
+{
+    mtb_ctp_ft5406_trace_record_t* record;
+    uint32_t frame;
+
+    CY_ASSERT(NULL != trace);
+
+    frame  = trace->frames;
+    record = &trace->records[trace->head];
+    record->frame        = frame;
+    record->request_time = request_time;
+    record->decode_time  = decode_time;
+    record->stage_us[MTB_CTP_FT5406_TRACE_START]    = start_time - request_time;
+    record->stage_us[MTB_CTP_FT5406_TRACE_TRANSFER] = complete_time - start_time;
+    record->stage_us[MTB_CTP_FT5406_TRACE_DECODE]   = decode_time - complete_time;
+    record->stage_us[MTB_CTP_FT5406_TRACE_PICKUP]   = MTB_CTP_FT5406_TRACE_NONE;
+    record->stage_us[MTB_CTP_FT5406_TRACE_TOTAL]    = MTB_CTP_FT5406_TRACE_NONE;
+
+    trace->frames = frame + 1U;
+    trace->head   = (trace->head + 1U) % MTB_CTP_FT5406_TRACE_SIZE;
+    if (MTB_CTP_FT5406_TRACE_SIZE > trace->count)
+    {
+        trace->count++;
+    }
+
+    return frame;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_trace_pickup
+********************************************************************************
+*
+* Records the consumer pickup of a traced frame. Only the first pickup of a
+* frame is recorded; a frame which is never picked up, e.g. as a newer frame
+* replaced it, keeps no pickup stage, and a frame whose record was overwritten
+* is ignored. Called by the driver when a frame is served to the application:
+* by a touch output call, a view acquisition, the read callback, or
+* mtb_ctp_ft5406_pop_frame(). Repeated pickups of the latest picked up frame,
+* e.g. by polling without a new frame, return without a critical section.
+*
+* \param trace
+* Pointer to the trace.
+*
+* \param frame
+* Number of the frame returned by mtb_ctp_ft5406_trace_frame().
+*
+* \param pickup_time
+* Time the frame was served to the application.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_trace_pickup(mtb_ctp_ft5406_trace_t* trace, uint32_t frame,
+                                 uint32_t pickup_time)
+{
+    mtb_ctp_ft5406_trace_record_t* record;
+    uint32_t interrupt_state;
+    uint32_t age;
+
+    CY_ASSERT(NULL != trace);
+
+    /* Single word load, the pickup stores it in the critical section */
+    if ((frame + 1U) == trace->picked)
+    {
+        return;
+    }
+
+    /* The read completion may trace a new frame meanwhile */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    age = trace->frames - frame;
+    if ((0U < age) && (age <= trace->count))
+    {
+        record = &trace->records[(trace->head + MTB_CTP_FT5406_TRACE_SIZE - age) %
+                                 MTB_CTP_FT5406_TRACE_SIZE];
+
+        if ((frame == record->frame) &&
+            (MTB_CTP_FT5406_TRACE_NONE == record->stage_us[MTB_CTP_FT5406_TRACE_PICKUP]))
+        {
+            record->stage_us[MTB_CTP_FT5406_TRACE_PICKUP] = pickup_time - record->decode_time;
+            record->stage_us[MTB_CTP_FT5406_TRACE_TOTAL]  = pickup_time - record->request_time;
+        }
+    }
+    trace->picked = frame + 1U;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_trace_get_summary
+********************************************************************************
+*
+* Computes the median, 99th percentile and maximum duration of each stage over
+* the recorded frames. The records are copied one at a time in a critical
+* section, so the summary can be taken while the driver traces new frames.
+* The computation sorts MTB_CTP_FT5406_TRACE_SIZE values per stage and is
+* intended for diagnostics, not for the touch processing path.
+*
+* \param trace
+* Pointer to the trace.
+*
+* \param summary
+* Array to store the summary of each stage, indexed by
+* mtb_ctp_ft5406_trace_stage_t. Stages without recorded frames have a zero
+* count and zero durations.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_trace_get_summary(const mtb_ctp_ft5406_trace_t* trace,
+                                      mtb_ctp_ft5406_trace_summary_t summary[MTB_CTP_FT5406_TRACE_STAGE_COUNT])
+{
+    uint32_t values[MTB_CTP_FT5406_TRACE_SIZE];
+    uint32_t interrupt_state;
+    uint32_t count;
+    uint32_t value;
+    uint32_t stage;
+    uint32_t i;
+    uint32_t j;
+
+    CY_ASSERT(NULL != trace);
+    CY_ASSERT(NULL != summary);
+
+    for (stage = 0U; stage < (uint32_t)MTB_CTP_FT5406_TRACE_STAGE_COUNT; stage++)
+    {
+        count = RESET_VAL;
+
+        for (i = 0U; i < MTB_CTP_FT5406_TRACE_SIZE; i++)
+        {
+            interrupt_state = Cy_SysLib_EnterCriticalSection();
+            value = (i < trace->count) ? trace->records[i].stage_us[stage] :
+                    MTB_CTP_FT5406_TRACE_NONE;
+            Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+            if (MTB_CTP_FT5406_TRACE_NONE == value)
+            {
+                continue;
+            }
+
+            /* Insertion sort, the trace is small */
+            for (j = count; (j > 0U) && (values[j - 1U] > value); j--)
+            {
+                values[j] = values[j - 1U];
+            }
+            values[j] = value;
+            count++;
+        }
+
+        summary[stage].count  = count;
+        summary[stage].p50_us = (RESET_VAL == count) ? RESET_VAL :
+                                values[TRACE_PERCENTILE(count, 50U)];
+        summary[stage].p99_us = (RESET_VAL == count) ? RESET_VAL :
+                                values[TRACE_PERCENTILE(count, 99U)];
+        summary[stage].max_us = (RESET_VAL == count) ? RESET_VAL : values[count - 1U];
+    }
+}
+
+
+/* [] END OF FILE */
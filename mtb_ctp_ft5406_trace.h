@@ -0,0 +1,121 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_trace.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the end-to-end
+* touch latency trace of the FT5406.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+
+#ifndef MTB_CTP_FT5406_TRACE_H
+#define MTB_CTP_FT5406_TRACE_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of frames kept in the trace. */
+#ifndef MTB_CTP_FT5406_TRACE_SIZE
+#define MTB_CTP_FT5406_TRACE_SIZE             (64U)
+#endif
+
+/* Stage duration of a frame which did not reach the stage. */
+#define MTB_CTP_FT5406_TRACE_NONE             (0xFFFFFFFFU)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Latency stages of a touch frame */
+typedef enum
+{
+    MTB_CTP_FT5406_TRACE_START,      /* INT assertion or read request to transfer start */
+    MTB_CTP_FT5406_TRACE_TRANSFER,   /* Transfer start to transfer complete */
+    MTB_CTP_FT5406_TRACE_DECODE,     /* Transfer complete to decode complete */
+    MTB_CTP_FT5406_TRACE_PICKUP,     /* Decode complete to consumer pickup */
+    MTB_CTP_FT5406_TRACE_TOTAL,      /* INT assertion or read request to consumer pickup */
+    MTB_CTP_FT5406_TRACE_STAGE_COUNT
+} mtb_ctp_ft5406_trace_stage_t;
+
+/* Traced frame */
+typedef struct
+{
+    uint32_t frame;         /* Frame number, see mtb_ctp_ft5406_trace_frame() */
+    uint32_t request_time;  /* INT assertion or read request */
+    uint32_t decode_time;   /* Decode completion */
+    uint32_t stage_us[MTB_CTP_FT5406_TRACE_STAGE_COUNT]; /* Stage durations in microseconds */
+} mtb_ctp_ft5406_trace_record_t;
+
+/* Latency percentiles of one stage in microseconds */
+typedef struct
+{
+    uint32_t count;  /* Number of frames which reached the stage */
+    uint32_t p50_us; /* Median */
+    uint32_t p99_us; /* 99th percentile */
+    uint32_t max_us; /* Maximum */
+} mtb_ctp_ft5406_trace_summary_t;
+
+/* Latency trace of the latest MTB_CTP_FT5406_TRACE_SIZE frames */
+struct mtb_ctp_ft5406_trace
+{
+    uint32_t head;          /* Index of the next record */
+    uint32_t count;         /* Number of valid records */
+    uint32_t frames;        /* Number of the next traced frame */
+    volatile uint32_t picked; /* Number of the latest picked up frame plus one, 0 if none */
+    mtb_ctp_ft5406_trace_record_t records[MTB_CTP_FT5406_TRACE_SIZE];
+};
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void mtb_ctp_ft5406_trace_init(mtb_ctp_ft5406_trace_t* trace);
+uint32_t mtb_ctp_ft5406_trace_frame(mtb_ctp_ft5406_trace_t* trace,
+                                    uint32_t request_time,
+                                    uint32_t start_time,
+                                    uint32_t complete_time,
+                                    uint32_t decode_time);
+void mtb_ctp_ft5406_trace_pickup(mtb_ctp_ft5406_trace_t* trace, uint32_t frame,
+                                 uint32_t pickup_time);
+void mtb_ctp_ft5406_trace_get_summary(const mtb_ctp_ft5406_trace_t* trace,
+                                      mtb_ctp_ft5406_trace_summary_t summary[MTB_CTP_FT5406_TRACE_STAGE_COUNT]);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_TRACE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,321 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_tracker.c
+* \version 1.1.0
+*
+* \brief
+* Provides implementation of the per touch ID tracker of decoded FT5406 touch
+* frames.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406_tracker.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define RESET_VAL                          (0U)
+
+/* Value of contact_of_id for touch IDs without contact */
+#define NO_CONTACT                         (0xFFU)
+
+#define TOUCH_ID_MASK                      (MTB_CTP_FT5406_TOUCH_ID_COUNT - 1U)
+#define TOUCH_ID_BIT(ID)                   ((uint16_t)(1U << (ID)))
+
+/* Counts per microsecond to Q24.8 counts per millisecond */
+#define VELOCITY_SCALE                     ((int64_t)1000 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT)
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_tracker_saturate
+********************************************************************************
+*
+* Limits a value to a signed range.
+*
+* \param value
+* Value to limit.
+*
+* \param limit
+* Largest magnitude of the result.
+*
+* \return int64_t
+* Value limited to -limit to limit.
+*
+*******************************************************************************/
+static inline int64_t mtb_ctp_ft5406_tracker_saturate(int64_t value, int64_t limit)
+{
+    if (value > limit)
+    {
+        value = limit;
+    }
+    else if (value < -limit)
+    {
+        value = -limit;
+    }
+    else
+    {
+        /* In range */
+    }
+
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_tracker_emit
+********************************************************************************
+*
+* Stores a contact event in the event array.
+*
+* \param event
+* Pointer to the event array element.
+*
+* \param touch_event
+* Event of the contact.
+*
+* \param contact
+* Pointer to the contact state.
+*
+* \param delta_x
+* X movement since the previous frame, saturated to the int16_t range.
+*
+* \param delta_y
+* Y movement since the previous frame, saturated to the int16_t range.
+*
+*******************************************************************************/
+static void mtb_ctp_ft5406_tracker_emit(mtb_ctp_ft5406_track_event_t* event,
+                                        mtb_ctp_touch_event_t touch_event,
+                                        const mtb_ctp_ft5406_contact_t* contact,
+                                        int32_t delta_x,
+                                        int32_t delta_y)
+{
+    event->touch_event = touch_event;
+    event->touch_id    = contact->touch_id;
+    event->touch_x     = contact->touch_x;
+    event->touch_y     = contact->touch_y;
+    event->delta_x     = (int16_t)mtb_ctp_ft5406_tracker_saturate(delta_x, INT16_MAX);
+    event->delta_y     = (int16_t)mtb_ctp_ft5406_tracker_saturate(delta_y, INT16_MAX);
+    event->velocity_x  = contact->velocity_x;
+    event->velocity_y  = contact->velocity_y;
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_tracker_init
+********************************************************************************
+*
+* Initializes the tracker with no contact down.
+*
+* \param tracker
+* Pointer to the tracker.
+*
+*******************************************************************************/
+void mtb_ctp_ft5406_tracker_init(mtb_ctp_ft5406_tracker_t* tracker)
+{
+    uint32_t i;
+
+    CY_ASSERT(NULL != tracker);
+
+    tracker->timestamp = RESET_VAL;
+
+    for (i = 0U; i < MTB_CTP_FT5406_TOUCH_ID_COUNT; i++)
+    {
+        tracker->contact_of_id[i] = NO_CONTACT;
+    }
+
+    for (i = 0U; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
+    {
+        tracker->contacts[i].active = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mtb_ctp_ft5406_tracker_update
+********************************************************************************
+*
+* Updates the tracker with a decoded touch frame and reports the contact
+* events of the frame. Every MTB_CTP_TOUCH_DOWN event is followed by exactly
+* one MTB_CTP_TOUCH_UP event of the same touch ID: a contact which disappears
+* from the report, is reported up, or is reported down again without being
+* lifted is lifted by the tracker. Lifted contacts are reported first, so
+* their touch IDs can be reused in the same frame.
+*
+* Velocity is computed from the timestamps of consecutive frames and is 0 if
+* the frames carry no timestamp.
+*
+* \param tracker
+* Pointer to the tracker.
+*
+* \param timestamp
+* Acquisition time of the frame in microseconds, e.g. from the frame ring.
+*
+* \param touch_count
+* Number of valid touch points.
+*
+* \param touch_array
+* Decoded touch points of the frame.
+*
+* \param events
+* Pointer to the array for storing the contact events of the frame.
+*
+* \return uint32_t
+* Number of contact events stored in events.
+*
+*******************************************************************************/
+uint32_t mtb_ctp_ft5406_tracker_update(mtb_ctp_ft5406_tracker_t* tracker,
+                                       uint32_t timestamp,
+                                       int touch_count,
+                                       const mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                       mtb_ctp_ft5406_track_event_t events[MTB_CTP_FT5406_TRACKER_MAX_EVENTS])
+{
+    uint32_t event_count = RESET_VAL;
+    uint32_t count;
+    uint32_t elapsed_us  = timestamp - tracker->timestamp;
+    uint16_t reported    = RESET_VAL; /* Touch IDs down in this frame */
+    uint16_t restarted   = RESET_VAL; /* Touch IDs put down again without being lifted */
+    uint16_t handled     = RESET_VAL;
+    uint32_t i;
+
+    CY_ASSERT(NULL != tracker);
+    CY_ASSERT(NULL != touch_array);
+    CY_ASSERT(NULL != events);
+
+    count = (touch_count > 0) ? (uint32_t)touch_count : RESET_VAL;
+    if (MTB_CTP_FT5406_MAX_TOUCHES < count)
+    {
+        count = MTB_CTP_FT5406_MAX_TOUCHES;
+    }
+
+    /* Collect the touch IDs which are down */
+    for (i = 0U; i < count; i++)
+    {
+        uint8_t id = touch_array[i].touch_id & TOUCH_ID_MASK;
+
+        if ((MTB_CTP_TOUCH_DOWN == touch_array[i].touch_event) ||
+            (MTB_CTP_TOUCH_CONTACT == touch_array[i].touch_event))
+        {
+            reported |= TOUCH_ID_BIT(id);
+
+            if ((MTB_CTP_TOUCH_DOWN == touch_array[i].touch_event) &&
+                (NO_CONTACT != tracker->contact_of_id[id]))
+            {
+                restarted |= TOUCH_ID_BIT(id);
+            }
+        }
+    }
+
+    /* Lift the contacts which are not down anymore */
+    for (i = 0U; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
+    {
+        mtb_ctp_ft5406_contact_t* contact = &tracker->contacts[i];
+        uint16_t id_bit;
+
+        if (contact->active)
+        {
+            id_bit = TOUCH_ID_BIT(contact->touch_id);
+
+            if ((0U == (reported & id_bit)) || (0U != (restarted & id_bit)))
+            {
+                mtb_ctp_ft5406_tracker_emit(&events[event_count++], MTB_CTP_TOUCH_UP,
+                                            contact, 0, 0);
+                contact->active = false;
+                tracker->contact_of_id[contact->touch_id] = NO_CONTACT;
+            }
+        }
+    }
+
+    /* Put down new contacts and move the tracked ones */
+    for (i = 0U; i < count; i++)
+    {
+        uint8_t id = touch_array[i].touch_id & TOUCH_ID_MASK;
+        uint8_t index = tracker->contact_of_id[id];
+        mtb_ctp_ft5406_contact_t* contact;
+        int32_t delta_x;
+        int32_t delta_y;
+
+        /* Skip lifted touch points and repeated touch IDs */
+        if ((0U == (reported & TOUCH_ID_BIT(id))) || (0U != (handled & TOUCH_ID_BIT(id))))
+        {
+            continue;
+        }
+        handled |= TOUCH_ID_BIT(id);
+
+        if (NO_CONTACT == index)
+        {
+            /* A free contact always exists: at most count touch IDs are down */
+            index = 0U;
+            while (tracker->contacts[index].active)
+            {
+                index++;
+            }
+
+            contact = &tracker->contacts[index];
+            contact->active     = true;
+            contact->touch_id   = id;
+            contact->touch_x    = touch_array[i].touch_x;
+            contact->touch_y    = touch_array[i].touch_y;
+            contact->velocity_x = RESET_VAL;
+            contact->velocity_y = RESET_VAL;
+            tracker->contact_of_id[id] = index;
+
+            mtb_ctp_ft5406_tracker_emit(&events[event_count++], MTB_CTP_TOUCH_DOWN,
+                                        contact, 0, 0);
+        }
+        else
+        {
+            contact = &tracker->contacts[index];
+            delta_x = (int32_t)touch_array[i].touch_x - (int32_t)contact->touch_x;
+            delta_y = (int32_t)touch_array[i].touch_y - (int32_t)contact->touch_y;
+
+            /* Transformed coordinates are up to 16-bit, so the scaled delta
+             * needs 64 bits, and the velocity of a jump within a few
+             * microseconds is limited to the int32_t range */
+            if ((0U != elapsed_us) && (elapsed_us <= (uint32_t)INT32_MAX))
+            {
+                contact->velocity_x = (int32_t)mtb_ctp_ft5406_tracker_saturate(
+                    ((int64_t)delta_x * VELOCITY_SCALE) / (int64_t)elapsed_us, INT32_MAX);
+                contact->velocity_y = (int32_t)mtb_ctp_ft5406_tracker_saturate(
+                    ((int64_t)delta_y * VELOCITY_SCALE) / (int64_t)elapsed_us, INT32_MAX);
+            }
+            else
+            {
+                contact->velocity_x = RESET_VAL;
+                contact->velocity_y = RESET_VAL;
+            }
+
+            contact->touch_x = touch_array[i].touch_x;
+            contact->touch_y = touch_array[i].touch_y;
+
+            mtb_ctp_ft5406_tracker_emit(&events[event_count++], MTB_CTP_TOUCH_CONTACT,
+                                        contact, delta_x, delta_y);
+        }
+    }
+
+    tracker->timestamp = timestamp;
+
+    return event_count;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+* \file mtb_ctp_ft5406_tracker.h
+*
+* \brief
+* Provides constants, data structures, and API prototypes for the per touch ID
+* tracker of decoded FT5406 touch frames.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_CTP_FT5406_TRACKER_H
+#define MTB_CTP_FT5406_TRACKER_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "mtb_ctp_ft5406.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Maximum number of events of one frame: every tracked contact is lifted and
+ * as many new contacts are put down. */
+#define MTB_CTP_FT5406_TRACKER_MAX_EVENTS     (2U * MTB_CTP_FT5406_MAX_TOUCHES)
+
+/* Number of fractional bits of the contact velocity */
+#define MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT (8U)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Tracked contact event */
+typedef struct
+{
+    mtb_ctp_touch_event_t touch_event; /* MTB_CTP_TOUCH_DOWN, MTB_CTP_TOUCH_CONTACT or
+                                          MTB_CTP_TOUCH_UP */
+    uint8_t touch_id;                  /* Id of the contact */
+    uint16_t touch_x;                  /* X coordinate of the contact */
+    uint16_t touch_y;                  /* Y coordinate of the contact */
+    int16_t delta_x;                   /* X movement since the previous frame, saturated */
+    int16_t delta_y;                   /* Y movement since the previous frame, saturated */
+    int32_t velocity_x;                /* X velocity in counts per millisecond, Q24.8,
+                                          saturated */
+    int32_t velocity_y;                /* Y velocity in counts per millisecond, Q24.8,
+                                          saturated */
+} mtb_ctp_ft5406_track_event_t;
+
+/* Tracked contact state */
+typedef struct
+{
+    bool active;        /* Contact is down */
+    uint8_t touch_id;   /* Id of the contact */
+    uint16_t touch_x;   /* Last X coordinate */
+    uint16_t touch_y;   /* Last Y coordinate */
+    int32_t velocity_x; /* Last X velocity, Q24.8 */
+    int32_t velocity_y; /* Last Y velocity, Q24.8 */
+} mtb_ctp_ft5406_contact_t;
+
+/* Per touch ID contact tracker */
+typedef struct
+{
+    uint32_t timestamp;                                            /* Time of the previous frame */
+    uint8_t contact_of_id[MTB_CTP_FT5406_TOUCH_ID_COUNT];          /* Contact index of each
+                                                                    * touch ID */
+    mtb_ctp_ft5406_contact_t contacts[MTB_CTP_FT5406_MAX_TOUCHES]; /* Contact states */
+} mtb_ctp_ft5406_tracker_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void mtb_ctp_ft5406_tracker_init(mtb_ctp_ft5406_tracker_t* tracker);
+uint32_t mtb_ctp_ft5406_tracker_update(mtb_ctp_ft5406_tracker_t* tracker,
+                                       uint32_t timestamp,
+                                       int touch_count,
+                                       const mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES],
+                                       mtb_ctp_ft5406_track_event_t events[MTB_CTP_FT5406_TRACKER_MAX_EVENTS]);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* MTB_CTP_FT5406_TRACKER_H */
+
+
+/* [] END OF FILE */
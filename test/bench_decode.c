@@ -0,0 +1,299 @@
+/*******************************************************************************
+* \file bench_decode.c
+*
+* \brief
+* Touch data decode benchmark. Compares mtb_ctp_ft5406_decode_touch_data_ex()
+* with the multi touch decoder of v1.0.0 for 1 to 5 touch points, reporting
+* the host time and, on x86, the time stamp counter cycles per frame.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mtb_ctp_ft5406.h"
+#include "ft5406_sim.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES()                     (__rdtsc())
+#else
+#define BENCH_CYCLES()                     (0ULL)
+#endif
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_ITERATIONS                   (100000U)
+
+/* Timed blocks of BENCH_ITERATIONS frames per decoder, the fastest one is reported */
+#define BENCH_BLOCKS                       (20U)
+
+#define NS_PER_S                           (1000000000ULL)
+
+#define RESET_VAL                          (0U)
+
+/* Touch point field accessors of v1.0.0 */
+#define TOUCH_POINT_GET_EVENT(T) ((mtb_ctp_touch_event_t)(uint8_t)((T).XH >> 6U))
+#define TOUCH_POINT_GET_ID(T)    ((T).YH >> 4)
+#define TOUCH_POINT_GET_X(T)     (int)((((uint16_t)(T).XH & 0x0fU) << 8) | \
+                                      (uint16_t)(T).XL)
+#define TOUCH_POINT_GET_Y(T)     (int)((((uint16_t)(T).YH & 0x0fU) << 8) | \
+                                      (uint16_t)(T).YL)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+typedef void (* bench_decode_t)(uint8_t* touch_buff, int* touch_count,
+                                mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES]);
+
+typedef struct
+{
+    const char* name;
+    bench_decode_t decode;
+} bench_decoder_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static cy_stc_scb_i2c_context_t i2c_context;
+static mtb_ctp_ft5406_config_t ft5406_config;
+
+
+/*******************************************************************************
+* Function Name: decode_v100
+********************************************************************************
+*
+* Multi touch decoder of v1.0.0, including the clear of the whole touch array
+* after decoding. It decodes in place and clears an out of range touch count
+* in the touch buffer, so it runs on a scratch copy of the frame.
+*
+*******************************************************************************/
+static void decode_v100(uint8_t* touch_buff, int* touch_count,
+                        mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    mtb_ctp_ft5406_touch_data_t* touch_data = (mtb_ctp_ft5406_touch_data_t*)(void*)touch_buff;
+    uint8_t i = RESET_VAL;
+
+    /* Check for valid number of touches - otherwise ignore touch information */
+    if (MTB_CTP_FT5406_MAX_TOUCHES < touch_data->touch_detection_count)
+    {
+        touch_data->touch_detection_count = RESET_VAL;
+    }
+
+    /* Decode number of touches */
+    if (touch_count)
+    {
+        *touch_count = touch_data->touch_detection_count;
+    }
+
+    /* Decode valid touch points */
+    for (i = 0; i < touch_data->touch_detection_count; i++)
+    {
+        touch_array[i].touch_event = TOUCH_POINT_GET_EVENT(touch_data->touch_points[i]);
+        touch_array[i].touch_id    = TOUCH_POINT_GET_ID(touch_data->touch_points[i]);
+        touch_array[i].touch_x     = TOUCH_POINT_GET_X(touch_data->touch_points[i]);
+        touch_array[i].touch_y     = TOUCH_POINT_GET_Y(touch_data->touch_points[i]);
+    }
+
+    /* Clear vacant elements of touch_array */
+    for (i = 0; i < MTB_CTP_FT5406_MAX_TOUCHES; i++)
+    {
+        touch_array[i].touch_event = MTB_CTP_TOUCH_RESERVED;
+        touch_array[i].touch_id    = RESET_VAL;
+        touch_array[i].touch_x     = RESET_VAL;
+        touch_array[i].touch_y     = RESET_VAL;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: decode_current
+********************************************************************************
+*
+* Multi touch decoder of the driver, through the decode path of the replay.
+*
+*******************************************************************************/
+static void decode_current(uint8_t* touch_buff, int* touch_count,
+                           mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES])
+{
+    /* Without the jitter filter, as the v1.0.0 decoder */
+    mtb_ctp_ft5406_decode_touch_data_ex(&ft5406_config, touch_buff, touch_count, touch_array,
+                                        NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: wall_time_ns
+********************************************************************************
+*
+* Returns the host monotonic time in nanoseconds.
+*
+*******************************************************************************/
+static unsigned long long wall_time_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((unsigned long long)now.tv_sec * NS_PER_S) + (unsigned long long)now.tv_nsec;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_block
+********************************************************************************
+*
+* Decodes a frame BENCH_ITERATIONS times and returns the elapsed wall time and
+* cycles.
+*
+*******************************************************************************/
+static void bench_block(bench_decode_t volatile decode, uint8_t* scratch,
+                        unsigned long long* wall_ns, unsigned long long* cycles)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    unsigned long long wall_start;
+    unsigned long long cycles_start;
+    int touch_count;
+    uint32_t i;
+
+    wall_start   = wall_time_ns();
+    cycles_start = BENCH_CYCLES();
+
+    for (i = 0U; i < BENCH_ITERATIONS; i++)
+    {
+        /* The decoder is called through a volatile pointer so it is not hoisted */
+        decode(scratch, &touch_count, touch_array);
+    }
+
+    *cycles  = BENCH_CYCLES() - cycles_start;
+    *wall_ns = wall_time_ns() - wall_start;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+*
+* Decodes a frame with each decoder in BENCH_BLOCKS blocks of BENCH_ITERATIONS
+* and prints the figures per frame of the fastest block of each decoder. The
+* blocks of the decoders alternate, so changes of the host clock or load
+* affect them alike. The frame is copied once into a scratch buffer, outside
+* the timed loop.
+*
+*******************************************************************************/
+static const bench_decoder_t bench_decoders[] =
+{
+    { "v1.0.0",  decode_v100 },
+    { "current", decode_current }
+};
+
+#define BENCH_DECODER_COUNT                (sizeof(bench_decoders) / sizeof(bench_decoders[0]))
+
+
+static void bench_run(const uint8_t* touch_buff, uint32_t touches)
+{
+    uint8_t scratch[MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    unsigned long long wall_ns[BENCH_DECODER_COUNT];
+    unsigned long long cycles[BENCH_DECODER_COUNT];
+    unsigned long long block_wall_ns;
+    unsigned long long block_cycles;
+    uint32_t block;
+    uint32_t d;
+
+    (void)memcpy(scratch, touch_buff, sizeof(scratch));
+
+    for (d = 0U; d < BENCH_DECODER_COUNT; d++)
+    {
+        wall_ns[d] = ~0ULL;
+        cycles[d]  = ~0ULL;
+    }
+
+    for (block = 0U; block < BENCH_BLOCKS; block++)
+    {
+        for (d = 0U; d < BENCH_DECODER_COUNT; d++)
+        {
+            bench_block(bench_decoders[d].decode, scratch, &block_wall_ns, &block_cycles);
+
+            if (block_wall_ns < wall_ns[d])
+            {
+                wall_ns[d] = block_wall_ns;
+                cycles[d]  = block_cycles;
+            }
+        }
+    }
+
+    for (d = 0U; d < BENCH_DECODER_COUNT; d++)
+    {
+        (void)printf("%-10s %7u %9.2f %9.1f\n", bench_decoders[d].name, (unsigned int)touches,
+                     (double)wall_ns[d] / BENCH_ITERATIONS, (double)cycles[d] / BENCH_ITERATIONS);
+    }
+}
+
+
+int main(void)
+{
+    ft5406_sim_touch_t touches[MTB_CTP_FT5406_MAX_TOUCHES];
+    uint8_t touch_buff[MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    uint32_t count;
+    uint32_t i;
+
+    ft5406_sim_reset();
+    ft5406_config.i2c_base    = &ft5406_sim_scb;
+    ft5406_config.i2c_context = &i2c_context;
+    (void)mtb_ctp_ft5406_init(&ft5406_config);
+
+    (void)printf("Per decoded frame, fastest of %u blocks of %u frames per row. Cycles are "
+                 "time stamp counter cycles, 0 if not available.\n\n",
+                 (unsigned int)BENCH_BLOCKS, (unsigned int)BENCH_ITERATIONS);
+    (void)printf("%-10s %7s %9s %9s\n", "decoder", "touches", "ns", "cycles");
+
+    for (count = 1U; count <= MTB_CTP_FT5406_MAX_TOUCHES; count++)
+    {
+        for (i = 0U; i < count; i++)
+        {
+            touches[i].x     = (uint16_t)(100U * (i + 1U));
+            touches[i].y     = (uint16_t)(200U + i);
+            touches[i].id    = (uint8_t)i;
+            touches[i].event = FT5406_SIM_EVENT_CONTACT;
+        }
+        ft5406_sim_set_touches(count, touches);
+
+        for (i = 0U; i < sizeof(touch_buff); i++)
+        {
+            touch_buff[i] = ft5406_sim_get_reg((uint8_t)(MTB_CTP_REG_READ_TOUCH_DATA + i));
+        }
+
+        bench_run(touch_buff, count);
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* \file bench_ft5406.c
+*
+* \brief
+* Touch read benchmark of the FT5406 driver library on the FT5406 bus
+* simulator. Reports per API and touch frame: the host wall time of the call,
+* the simulated latency, and the simulated bus bytes, transactions, and
+* retries, at standard and fast mode bus speeds, without and with injected
+* NAKs.
+*
+* Build with BASE_API=1 to benchmark a driver version without the v1.1.0 API,
+* e.g. make bench DRIVER_DIR=<v1.0.0 checkout> BASE_API=1.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mtb_ctp_ft5406.h"
+#include "ft5406_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_FRAMES                       (1000U)
+#define BENCH_NAK_PERIOD                   (16U)   /* One NAK every 16 transfers */
+
+#define NS_PER_S                           (1000000000ULL)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Reads one touch frame with the benchmarked API */
+typedef cy_en_scb_i2c_status_t (* bench_read_t)(void);
+
+typedef struct
+{
+    const char* name;
+    bench_read_t read;
+} bench_api_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static cy_stc_scb_i2c_context_t i2c_context;
+static mtb_ctp_ft5406_config_t ft5406_config;
+static bool nak_enabled;
+
+static const ft5406_sim_touch_t touches[] =
+{
+    { .x = 100U, .y = 200U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 300U, .y = 400U, .id = 1U, .event = FT5406_SIM_EVENT_CONTACT }
+};
+
+
+/*******************************************************************************
+* Function Name: nak_hook
+********************************************************************************
+*
+* Injects a NAK into every BENCH_NAK_PERIOD-th transfer.
+*
+*******************************************************************************/
+static void nak_hook(uint32_t transaction)
+{
+    if (nak_enabled && (0U == (transaction % BENCH_NAK_PERIOD)))
+    {
+        ft5406_sim_inject_nak(1U);
+    }
+}
+
+
+static cy_en_scb_i2c_status_t read_single_touch(void)
+{
+    mtb_ctp_touch_event_t touch_event;
+    int touch_x;
+    int touch_y;
+
+    return mtb_ctp_ft5406_get_single_touch(&touch_event, &touch_x, &touch_y);
+}
+
+
+static cy_en_scb_i2c_status_t read_multi_touch(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count;
+
+    return mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array);
+}
+
+
+#if !defined(BASE_API)
+static cy_en_scb_i2c_status_t read_multi_touch_soa(void)
+{
+    mtb_ctp_ft5406_touch_soa_t touch_soa;
+
+    return mtb_ctp_ft5406_get_multi_touch_soa(&touch_soa);
+}
+
+
+static volatile bool async_done;
+static volatile cy_en_scb_i2c_status_t async_status;
+
+static void async_cb(cy_en_scb_i2c_status_t status, int touch_count,
+                     const mtb_ctp_multi_touch_point_t* touch_array, void* user_data)
+{
+    (void)touch_count;
+    (void)touch_array;
+    (void)user_data;
+
+    async_status = status;
+    async_done   = true;
+}
+
+
+/* Starts the read and lets the simulated time pass until its completion */
+static cy_en_scb_i2c_status_t read_async(void)
+{
+    cy_en_scb_i2c_status_t status;
+
+    async_done = false;
+    status = mtb_ctp_ft5406_read_async(async_cb, NULL);
+
+    if (CY_SCB_I2C_SUCCESS == status)
+    {
+        while (!async_done)
+        {
+            ft5406_sim_run(10U);
+        }
+        status = async_status;
+    }
+
+    return status;
+}
+
+
+#endif /* !defined(BASE_API) */
+static const bench_api_t bench_apis[] =
+{
+    { "get_single_touch",     read_single_touch },
+    { "get_multi_touch",      read_multi_touch },
+#if !defined(BASE_API)
+    { "get_multi_touch_soa",  read_multi_touch_soa },
+    { "read_async",           read_async },
+#endif
+};
+
+
+/*******************************************************************************
+* Function Name: wall_time_ns
+********************************************************************************
+*
+* Returns the host monotonic time in nanoseconds.
+*
+*******************************************************************************/
+static unsigned long long wall_time_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((unsigned long long)now.tv_sec * NS_PER_S) + (unsigned long long)now.tv_nsec;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+*
+* Reads BENCH_FRAMES frames with an API and prints the per-frame figures.
+*
+*******************************************************************************/
+static void bench_run(const bench_api_t* api, uint32_t bus_hz, bool nak)
+{
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    unsigned long long wall_start;
+    unsigned long long wall_ns;
+    uint32_t sim_start;
+    uint32_t sim_us;
+    uint32_t errors = 0U;
+    uint32_t i;
+
+    ft5406_sim_reset();
+    ft5406_sim_set_bus_hz(bus_hz);
+    ft5406_sim_set_touches(2U, touches);
+    ft5406_sim_set_xfer_hook(nak_hook);
+
+    (void)memset(&ft5406_config, 0, sizeof(ft5406_config));
+    ft5406_config.i2c_base    = &ft5406_sim_scb;
+    ft5406_config.i2c_context = &i2c_context;
+    nak_enabled = false;
+    (void)mtb_ctp_ft5406_init(&ft5406_config);
+    nak_enabled = nak;
+
+    ft5406_sim_get_stats(&before);
+    sim_start  = ft5406_sim_now_us();
+    wall_start = wall_time_ns();
+
+    for (i = 0U; i < BENCH_FRAMES; i++)
+    {
+        if (CY_SCB_I2C_SUCCESS != api->read())
+        {
+            errors++;
+        }
+    }
+
+    wall_ns = wall_time_ns() - wall_start;
+    sim_us  = ft5406_sim_now_us() - sim_start;
+    ft5406_sim_get_stats(&after);
+
+    (void)printf("%-22s %7u %-6s %9.0f %11.1f %7.1f %7.2f %8.3f %7u\n",
+                 api->name, (unsigned int)(bus_hz / 1000U), nak ? "nak16" : "none",
+                 (double)wall_ns / BENCH_FRAMES,
+                 (double)sim_us / BENCH_FRAMES,
+                 (double)(after.bytes - before.bytes) / BENCH_FRAMES,
+                 (double)(after.transactions - before.transactions) / BENCH_FRAMES,
+                 (double)(after.failed - before.failed) / BENCH_FRAMES,
+                 (unsigned int)errors);
+}
+
+
+int main(void)
+{
+    static const uint32_t bus_speeds[] = { 100000U, 400000U };
+    uint32_t api;
+    uint32_t speed;
+    uint32_t nak;
+
+    (void)printf("Per touch frame, %u frames per row. Latency is simulated time; "
+                 "retries are failed transfers repeated by the driver.\n\n",
+                 (unsigned int)BENCH_FRAMES);
+    (void)printf("%-22s %7s %-6s %9s %11s %7s %7s %8s %7s\n",
+                 "API", "bus_kHz", "faults", "wall_ns", "latency_us", "bytes", "xfers",
+                 "retries", "errors");
+
+    for (api = 0U; api < (sizeof(bench_apis) / sizeof(bench_apis[0])); api++)
+    {
+        for (speed = 0U; speed < (sizeof(bus_speeds) / sizeof(bus_speeds[0])); speed++)
+        {
+            for (nak = 0U; nak < 2U; nak++)
+            {
+                bench_run(&bench_apis[api], bus_speeds[speed], (0U != nak));
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
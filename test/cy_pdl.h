@@ -0,0 +1,210 @@
+/*******************************************************************************
+* \file cy_pdl.h
+*
+* \brief
+* Host stand-in of the PDL subset used by the FT5406 driver library. The
+* functions are implemented by the FT5406 bus simulator in ft5406_sim.c.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CY_ASSERT(x)                          assert(x)
+#define CY_UNUSED_PARAMETER(x)                ((void)(x))
+
+#define __DMB()                               __sync_synchronize()
+
+/* I2C controller status bits returned by Cy_SCB_I2C_MasterGetStatus() */
+#define CY_SCB_I2C_MASTER_BUSY                (0x00000001UL)
+#define CY_SCB_I2C_MASTER_ADDR_NAK            (0x00000002UL)
+#define CY_SCB_I2C_MASTER_DATA_NAK            (0x00000004UL)
+#define CY_SCB_I2C_MASTER_ARB_LOST            (0x00000008UL)
+#define CY_SCB_I2C_MASTER_BUS_ERR             (0x00000010UL)
+#define CY_SCB_I2C_MASTER_ABORT_START         (0x00000020UL)
+
+/* I2C controller events passed to the registered event callback */
+#define CY_SCB_I2C_MASTER_WR_CMPLT_EVENT      (0x00000001UL)
+#define CY_SCB_I2C_MASTER_RD_CMPLT_EVENT      (0x00000002UL)
+#define CY_SCB_I2C_MASTER_ERR_EVENT           (0x00000004UL)
+
+/* SCB RX interrupt source of the FIFO trigger level */
+#define CY_SCB_RX_INTR_LEVEL                  (0x00000001UL)
+
+/* RX FIFO read register of an SCB, the source of RX DMA transfers */
+#define SCB_RX_FIFO_RD(base)                  (((CySCB_Type*)(base))->RX_FIFO_RD)
+
+/* DataWire channel interrupt */
+#define CY_DMA_INTR_MASK                      (0x00000001UL)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* SCB, GPIO port and DataWire register blocks, only their addresses and the
+ * SCB RX FIFO read register are used */
+typedef struct
+{
+    volatile uint32_t RX_FIFO_RD;
+} CySCB_Type;
+
+typedef struct
+{
+    uint32_t reserved;
+} GPIO_PRT_Type;
+
+typedef struct
+{
+    uint32_t reserved;
+} DW_Type;
+
+typedef enum
+{
+    CY_SCB_I2C_SUCCESS = 0,
+    CY_SCB_I2C_BAD_PARAM,
+    CY_SCB_I2C_MASTER_NOT_READY,
+    CY_SCB_I2C_MASTER_MANUAL_TIMEOUT,
+    CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK,
+    CY_SCB_I2C_MASTER_MANUAL_NAK,
+    CY_SCB_I2C_MASTER_MANUAL_ARB_LOST,
+    CY_SCB_I2C_MASTER_MANUAL_BUS_ERR,
+    CY_SCB_I2C_MASTER_MANUAL_ABORT_START
+} cy_en_scb_i2c_status_t;
+
+typedef void (* cy_cb_scb_i2c_handle_events_t)(uint32_t event);
+
+typedef struct
+{
+    uint8_t slaveAddress;
+    uint8_t* buffer;
+    uint32_t bufferSize;
+    bool xferPending;
+} cy_stc_scb_i2c_master_xfer_config_t;
+
+/* Cause of a DataWire channel interrupt */
+typedef enum
+{
+    CY_DMA_INTR_CAUSE_NO_INTR            = 0,
+    CY_DMA_INTR_CAUSE_COMPLETION         = 1,
+    CY_DMA_INTR_CAUSE_SRC_BUS_ERROR      = 2,
+    CY_DMA_INTR_CAUSE_DST_BUS_ERROR      = 3,
+    CY_DMA_INTR_CAUSE_SRC_MISAL          = 4,
+    CY_DMA_INTR_CAUSE_DST_MISAL          = 5,
+    CY_DMA_INTR_CAUSE_CURR_PTR_NULL      = 6,
+    CY_DMA_INTR_CAUSE_ACTIVE_CH_DISABLED = 7,
+    CY_DMA_INTR_CAUSE_DESCR_BUS_ERROR    = 8
+} cy_en_dma_intr_cause_t;
+
+/* DataWire descriptor with the fields set by the driver: a single X loop of
+ * byte transfers, one per trigger, disabling the channel on completion */
+typedef struct
+{
+    void const* src;
+    void* dst;
+    uint32_t xCount;
+} cy_stc_dma_descriptor_t;
+
+/* Driver context of an SCB in I2C controller mode */
+typedef struct
+{
+    volatile uint32_t masterStatus;
+    bool masterRdDir;
+    bool masterPause;
+    uint8_t* masterBuffer;
+    uint32_t masterBufferSize;
+    uint32_t masterBufferIdx;
+    cy_cb_scb_i2c_handle_events_t cbEvents;
+} cy_stc_scb_i2c_context_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterWrite(CySCB_Type* base,
+                                              cy_stc_scb_i2c_master_xfer_config_t* xferConfig,
+                                              cy_stc_scb_i2c_context_t* context);
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterRead(CySCB_Type* base,
+                                             cy_stc_scb_i2c_master_xfer_config_t* xferConfig,
+                                             cy_stc_scb_i2c_context_t* context);
+uint32_t Cy_SCB_I2C_MasterGetStatus(CySCB_Type const* base,
+                                    cy_stc_scb_i2c_context_t const* context);
+uint32_t Cy_SCB_I2C_MasterGetTransferCount(CySCB_Type const* base,
+                                           cy_stc_scb_i2c_context_t const* context);
+void Cy_SCB_I2C_MasterAbortWrite(CySCB_Type* base, cy_stc_scb_i2c_context_t* context);
+void Cy_SCB_I2C_MasterAbortRead(CySCB_Type* base, cy_stc_scb_i2c_context_t* context);
+void Cy_SCB_I2C_Disable(CySCB_Type* base, cy_stc_scb_i2c_context_t* context);
+void Cy_SCB_I2C_Enable(CySCB_Type* base);
+void Cy_SCB_I2C_RegisterEventCallback(CySCB_Type const* base,
+                                      cy_cb_scb_i2c_handle_events_t callback,
+                                      cy_stc_scb_i2c_context_t* context);
+void Cy_SCB_I2C_Interrupt(CySCB_Type* base, cy_stc_scb_i2c_context_t* context);
+void Cy_SCB_SetRxInterruptMask(CySCB_Type* base, uint32_t interruptMask);
+
+void Cy_DMA_Descriptor_SetSrcAddress(cy_stc_dma_descriptor_t* descriptor, void const* srcAddress);
+void Cy_DMA_Descriptor_SetDstAddress(cy_stc_dma_descriptor_t* descriptor, void const* dstAddress);
+void Cy_DMA_Descriptor_SetXloopDataCount(cy_stc_dma_descriptor_t* descriptor, uint32_t xCount);
+void Cy_DMA_Channel_SetDescriptor(DW_Type* base, uint32_t channel,
+                                  cy_stc_dma_descriptor_t const* descriptor);
+void Cy_DMA_Channel_Enable(DW_Type* base, uint32_t channel);
+void Cy_DMA_Channel_Disable(DW_Type* base, uint32_t channel);
+void Cy_DMA_Channel_SetInterruptMask(DW_Type* base, uint32_t channel, uint32_t interrupt);
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const* base, uint32_t channel);
+void Cy_DMA_Channel_ClearInterrupt(DW_Type* base, uint32_t channel);
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const* base, uint32_t channel);
+
+uint32_t Cy_GPIO_GetInterruptStatusMasked(const GPIO_PRT_Type* base, uint32_t pinNum);
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type* base, uint32_t pinNum);
+
+void Cy_SysLib_Delay(uint32_t milliseconds);
+void Cy_SysLib_DelayUs(uint16_t microseconds);
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+
+/* Interrupt program status, 0 in thread mode */
+uint32_t __get_IPSR(void);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* CY_PDL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+* \file cyabs_rtos.h
+*
+* \brief
+* Host stand-in of the abstraction-rtos subset used by the shared I2C bus lock
+* with COMPONENT_RTOS_AWARE. The semaphores and the time are implemented on
+* POSIX threads in cyabs_rtos_pthread.c, so the lock runs on host threads.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CYABS_RTOS_H
+#define CYABS_RTOS_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CY_RSLT_SUCCESS                       ((cy_rslt_t)0x00000000U)
+#define CY_RTOS_TIMEOUT                       ((cy_rslt_t)0x04020001U)
+#define CY_RTOS_GENERAL_ERROR                 ((cy_rslt_t)0x04020002U)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+/* Time in milliseconds */
+typedef uint32_t cy_time_t;
+
+/* Counting semaphore */
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t available;
+    uint32_t count;
+    uint32_t max_count;
+} cy_semaphore_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t* semaphore, uint32_t maxcount,
+                                 uint32_t initcount);
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t* semaphore, cy_time_t timeout_ms,
+                                bool in_isr);
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t* semaphore, bool in_isr);
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t* semaphore);
+cy_rslt_t cy_rtos_get_time(cy_time_t* tval);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* CYABS_RTOS_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,174 @@
+/*******************************************************************************
+* \file cyabs_rtos_pthread.c
+*
+* \brief
+* Provides a POSIX threads implementation of the abstraction-rtos stand-in.
+* Semaphores block on a condition variable for up to their timeout in host
+* time, and the RTOS time is the host monotonic time, so the shared I2C bus
+* lock of COMPONENT_RTOS_AWARE builds serves host threads as RTOS tasks.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <errno.h>
+#include <time.h>
+#include "cyabs_rtos.h"
+#include "ft5406_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define NS_PER_MS                          (1000000L)
+#define NS_PER_S                           (1000000000L)
+#define MS_PER_S                           (1000U)
+
+
+/*******************************************************************************
+* Function Name: cy_rtos_init_semaphore
+********************************************************************************
+*
+* Initializes a counting semaphore.
+*
+*******************************************************************************/
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t* semaphore, uint32_t maxcount,
+                                 uint32_t initcount)
+{
+    if ((0 != pthread_mutex_init(&semaphore->mutex, NULL)) ||
+        (0 != pthread_cond_init(&semaphore->available, NULL)))
+    {
+        return CY_RTOS_GENERAL_ERROR;
+    }
+
+    semaphore->count     = initcount;
+    semaphore->max_count = maxcount;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_rtos_get_semaphore
+********************************************************************************
+*
+* Takes the semaphore, waiting up to the given host time for it.
+*
+*******************************************************************************/
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t* semaphore, cy_time_t timeout_ms,
+                                bool in_isr)
+{
+    struct timespec deadline;
+    cy_rslt_t rslt = CY_RTOS_TIMEOUT;
+    int result = 0;
+
+    (void)in_isr;
+
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec  += (time_t)(timeout_ms / MS_PER_S);
+    deadline.tv_nsec += (long)(timeout_ms % MS_PER_S) * NS_PER_MS;
+    if (NS_PER_S <= deadline.tv_nsec)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= NS_PER_S;
+    }
+
+    (void)pthread_mutex_lock(&semaphore->mutex);
+    while ((0U == semaphore->count) && (ETIMEDOUT != result))
+    {
+        result = pthread_cond_timedwait(&semaphore->available, &semaphore->mutex, &deadline);
+    }
+    if (0U != semaphore->count)
+    {
+        semaphore->count--;
+        rslt = CY_RSLT_SUCCESS;
+    }
+    (void)pthread_mutex_unlock(&semaphore->mutex);
+
+    return rslt;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_rtos_set_semaphore
+********************************************************************************
+*
+* Gives the semaphore and wakes a waiting thread. A semaphore at its maximum
+* count is left unchanged. Like an RTOS kernel call which may switch context,
+* it must not be called from a thread with interrupts masked.
+*
+*******************************************************************************/
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t* semaphore, bool in_isr)
+{
+    cy_rslt_t rslt = CY_RTOS_GENERAL_ERROR;
+
+    CY_ASSERT(in_isr || (!ft5406_sim_in_critical_section()));
+
+    (void)pthread_mutex_lock(&semaphore->mutex);
+    if (semaphore->max_count > semaphore->count)
+    {
+        semaphore->count++;
+        (void)pthread_cond_signal(&semaphore->available);
+        rslt = CY_RSLT_SUCCESS;
+    }
+    (void)pthread_mutex_unlock(&semaphore->mutex);
+
+    return rslt;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_rtos_deinit_semaphore
+********************************************************************************
+*
+* Releases the resources of a semaphore, which must not be in use.
+*
+*******************************************************************************/
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t* semaphore)
+{
+    (void)pthread_cond_destroy(&semaphore->available);
+    (void)pthread_mutex_destroy(&semaphore->mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_rtos_get_time
+********************************************************************************
+*
+* Returns the host monotonic time in milliseconds.
+*
+*******************************************************************************/
+cy_rslt_t cy_rtos_get_time(cy_time_t* tval)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    *tval = (cy_time_t)(((uint64_t)now.tv_sec * MS_PER_S) + (uint64_t)(now.tv_nsec / NS_PER_MS));
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/* [] END OF FILE */
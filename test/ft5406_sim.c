@@ -0,0 +1,1391 @@
+/*******************************************************************************
+* \file ft5406_sim.c
+*
+* \brief
+* Provides implementation of the host FT5406 bus simulator and of the PDL
+* stand-in functions called by the driver library.
+*
+* Time is simulated: it advances in Cy_SysLib_Delay(), Cy_SysLib_DelayUs(),
+* and ft5406_sim_run(). A transfer completes after the time its bits take at
+* the configured bus speed, and its completion is delivered as the SCB I2C
+* interrupt unless interrupts are masked by a critical section, in which case
+* it is delivered when the critical section is left. Critical sections are a
+* recursive mutex, so the simulator can be driven from several threads.
+*
+* Each of the FT5406_SIM_BUS_COUNT simulated SCBs has its own FT5406 and INT
+* pin. The configuration functions apply to the bus selected with
+* ft5406_sim_select_bus().
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#define _XOPEN_SOURCE 700
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "ft5406_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_I2C_ADDRESS                    (0x38U)
+#define SIM_REG_COUNT                      (256U)
+
+/* FT5406 register map */
+#define SIM_REG_DEVICE_MODE                (0x00U)
+#define SIM_REG_GEST_ID                    (0x01U)
+#define SIM_REG_TD_STATUS                  (0x02U)
+#define SIM_REG_TOUCH1                     (0x03U)
+#define SIM_TOUCH_POINT_LEN                (6U)
+#define SIM_MAX_TOUCHES                    (5U)
+#define SIM_REG_ID_G_LIB_VERSION_H         (0xA1U)
+#define SIM_REG_ID_G_LIB_VERSION_L         (0xA2U)
+#define SIM_REG_ID_G_CIPHER                (0xA3U)
+#define SIM_REG_ID_G_FIRMID                (0xA6U)
+#define SIM_REG_ID_G_VENDOR_ID             (0xA8U)
+
+/* Bits of a byte with its ACK, and of the Start and Stop conditions */
+#define SIM_BITS_PER_BYTE                  (9U)
+#define SIM_BITS_START_STOP                (2U)
+
+/* RX FIFO depth of the SCB */
+#define SIM_RX_FIFO_SIZE                   (8U)
+
+#define SIM_US_PER_S                       (1000000U)
+#define SIM_ISR_IPSR                       (16U)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Simulated SCB with its FT5406 and INT pin */
+typedef struct
+{
+    CySCB_Type* scb;
+    GPIO_PRT_Type* int_port;
+
+    uint8_t regs[SIM_REG_COUNT];
+    uint8_t reg_ptr;
+    uint32_t nak_count;
+    uint32_t timeout_count;
+    ft5406_sim_stats_t stats;
+    ft5406_sim_hook_t xfer_hook;
+
+    /* Transfer in progress on the SCB */
+    cy_stc_scb_i2c_context_t* xfer_context;
+    bool xfer_active;
+    bool xfer_nak;
+    bool xfer_stalled;
+    uint64_t xfer_end_us;
+
+    /* Read data phase. The RX FIFO is read by the PDL interrupt unless it is
+     * masked, and by a DataWire channel reading SCB_RX_FIFO_RD while it holds
+     * more bytes than the trigger level. */
+    uint32_t rx_intr_mask;
+    uint32_t rx_fifo_level;
+    uint8_t rx_fifo[SIM_RX_FIFO_SIZE];
+    uint32_t rx_fifo_count;
+    bool rx_auto_ack;    /* Received bytes are ACKed while the FIFO is not full */
+    bool rx_ack_pending; /* Last received byte not ACKed, the clock is stretched */
+    bool rx_waiting;     /* No byte can be received until the FIFO is read */
+    uint32_t rx_planned; /* Bytes received at the transfer end time */
+    uint32_t rx_bytes;   /* Bytes received by the read */
+
+    /* INT pin */
+    void (* int_isr)(void);
+    uint32_t int_status;
+    bool int_pending;
+} sim_bus_t;
+
+/* DataWire channel */
+typedef struct
+{
+    cy_stc_dma_descriptor_t const* descriptor;
+    bool enabled;
+    bool error;          /* Transfer ends with a bus error */
+    void const* src;
+    uint8_t* dst;
+    uint32_t remaining;
+    uint32_t intr_mask;
+    uint32_t intr;
+    cy_en_dma_intr_cause_t status;
+} sim_dma_channel_t;
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+CySCB_Type ft5406_sim_scb;
+GPIO_PRT_Type ft5406_sim_int_port;
+CySCB_Type ft5406_sim_scb_2;
+GPIO_PRT_Type ft5406_sim_int_port_2;
+DW_Type ft5406_sim_dw;
+
+static pthread_mutex_t sim_mutex;
+static pthread_once_t sim_once = PTHREAD_ONCE_INIT;
+
+/* Interrupt masking and interrupt context of the calling thread */
+static __thread uint32_t sim_mask_nesting;
+static __thread bool sim_in_isr;
+
+static uint64_t sim_time_us;
+static uint32_t sim_bus_hz;
+static uint32_t sim_critical_sections;
+
+static sim_bus_t sim_buses[FT5406_SIM_BUS_COUNT] =
+{
+    { .scb = &ft5406_sim_scb,   .int_port = &ft5406_sim_int_port   },
+    { .scb = &ft5406_sim_scb_2, .int_port = &ft5406_sim_int_port_2 }
+};
+
+/* Bus of the configuration functions */
+static sim_bus_t* sim_bus = &sim_buses[0];
+
+static sim_dma_channel_t sim_dma_channels[FT5406_SIM_DMA_CHANNELS];
+static void (* sim_dma_isr)(void);
+static bool sim_dma_pending;
+static uint32_t sim_dma_error_count;
+
+
+/*******************************************************************************
+* Function Name: sim_init_mutex
+********************************************************************************
+*
+* Creates the recursive mutex modeling the interrupt mask.
+*
+*******************************************************************************/
+static void sim_init_mutex(void)
+{
+    pthread_mutexattr_t attr;
+
+    (void)pthread_mutexattr_init(&attr);
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    (void)pthread_mutex_init(&sim_mutex, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_lock
+********************************************************************************
+*
+* Locks the simulator state.
+*
+*******************************************************************************/
+static void sim_lock(void)
+{
+    (void)pthread_once(&sim_once, sim_init_mutex);
+    (void)pthread_mutex_lock(&sim_mutex);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_unlock
+********************************************************************************
+*
+* Unlocks the simulator state.
+*
+*******************************************************************************/
+static void sim_unlock(void)
+{
+    (void)pthread_mutex_unlock(&sim_mutex);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_bus_time_us
+********************************************************************************
+*
+* Returns the time a number of bits takes on the bus, at least 1 us.
+*
+*******************************************************************************/
+static uint64_t sim_bus_time_us(uint32_t bits)
+{
+    uint64_t time_us = ((uint64_t)bits * SIM_US_PER_S + (sim_bus_hz - 1U)) / sim_bus_hz;
+
+    return (0U != time_us) ? time_us : 1U;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_find_bus
+********************************************************************************
+*
+* Returns the simulated bus of an SCB.
+*
+*******************************************************************************/
+static sim_bus_t* sim_find_bus(CySCB_Type const* base)
+{
+    uint32_t i;
+
+    for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+    {
+        if (base == sim_buses[i].scb)
+        {
+            return &sim_buses[i];
+        }
+    }
+
+    CY_ASSERT(false);
+    return &sim_buses[0];
+}
+
+
+/*******************************************************************************
+* Function Name: sim_find_int_bus
+********************************************************************************
+*
+* Returns the simulated bus of an INT pin port.
+*
+*******************************************************************************/
+static sim_bus_t* sim_find_int_bus(const GPIO_PRT_Type* base)
+{
+    uint32_t i;
+
+    for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+    {
+        if (base == sim_buses[i].int_port)
+        {
+            return &sim_buses[i];
+        }
+    }
+
+    CY_ASSERT(false);
+    return &sim_buses[0];
+}
+
+
+/*******************************************************************************
+* Function Name: sim_start_xfer
+********************************************************************************
+*
+* Starts a transfer on the simulated bus, applying the injected faults.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t sim_start_xfer(sim_bus_t* bus,
+                                             cy_stc_scb_i2c_master_xfer_config_t* xfer_config,
+                                             cy_stc_scb_i2c_context_t* context,
+                                             bool read)
+{
+    cy_en_scb_i2c_status_t status = CY_SCB_I2C_SUCCESS;
+    uint32_t bytes;
+
+    sim_lock();
+
+    if (bus->xfer_active)
+    {
+        status = CY_SCB_I2C_MASTER_NOT_READY;
+    }
+    else
+    {
+        bus->stats.transactions++;
+        if (NULL != bus->xfer_hook)
+        {
+            bus->xfer_hook(bus->stats.transactions);
+        }
+
+        if (read)
+        {
+            /* The PDL serves the RX FIFO from its interrupt, triggered at half
+             * the FIFO or two bytes before the end. The controller ACKs the
+             * bytes of a longer read until the PDL NAKs the last one. */
+            bus->rx_intr_mask   = CY_SCB_RX_INTR_LEVEL;
+            bus->rx_fifo_level  = (1U == xfer_config->bufferSize) ? 0U :
+                                  ((SIM_RX_FIFO_SIZE / 2U) < xfer_config->bufferSize) ?
+                                  ((SIM_RX_FIFO_SIZE / 2U) - 1U) :
+                                  (xfer_config->bufferSize - 2U);
+            bus->rx_fifo_count  = 0U;
+            bus->rx_auto_ack    = (1U < xfer_config->bufferSize);
+            bus->rx_ack_pending = false;
+            bus->rx_waiting     = false;
+            bus->rx_planned     = xfer_config->bufferSize;
+            bus->rx_bytes       = 0U;
+        }
+
+        context->masterStatus     = CY_SCB_I2C_MASTER_BUSY;
+        context->masterRdDir      = read;
+        context->masterPause      = xfer_config->xferPending;
+        context->masterBuffer     = xfer_config->buffer;
+        context->masterBufferSize = xfer_config->bufferSize;
+        context->masterBufferIdx  = 0U;
+
+        bus->xfer_context = context;
+        bus->xfer_active  = true;
+        bus->xfer_stalled = false;
+        bus->xfer_nak     = (SIM_I2C_ADDRESS != xfer_config->slaveAddress);
+
+        if (0U != bus->timeout_count)
+        {
+            /* The target holds the clock low, the transfer never completes */
+            bus->timeout_count--;
+            bus->xfer_stalled = true;
+        }
+        else if (0U != bus->nak_count)
+        {
+            bus->nak_count--;
+            bus->xfer_nak = true;
+        }
+        else
+        {
+            /* No fault */
+        }
+
+        bytes = bus->xfer_nak ? 1U : (1U + xfer_config->bufferSize);
+        bus->xfer_end_us = sim_time_us + sim_bus_time_us((bytes * SIM_BITS_PER_BYTE) +
+                                                         SIM_BITS_START_STOP);
+    }
+
+    sim_unlock();
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_end_xfer
+********************************************************************************
+*
+* Ends the transfer in progress without completing it.
+*
+*******************************************************************************/
+static void sim_end_xfer(sim_bus_t* bus, cy_stc_scb_i2c_context_t* context)
+{
+    sim_lock();
+
+    if (bus->xfer_active && (bus->xfer_context == context))
+    {
+        bus->stats.bytes += 1U;
+        bus->stats.failed++;
+        bus->xfer_active = false;
+    }
+    context->masterStatus = 0U;
+
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: sim_dma_channel
+********************************************************************************
+*
+* Returns a channel of the simulated DataWire block.
+*
+*******************************************************************************/
+static sim_dma_channel_t* sim_dma_channel(DW_Type const* base, uint32_t channel)
+{
+    CY_ASSERT(&ft5406_sim_dw == base);
+    CY_ASSERT(FT5406_SIM_DMA_CHANNELS > channel);
+    CY_UNUSED_PARAMETER(base);
+
+    return &sim_dma_channels[channel];
+}
+
+
+/*******************************************************************************
+* Function Name: sim_dma_end
+********************************************************************************
+*
+* Ends the transfer of a DataWire channel, disabling the channel and raising
+* its interrupt.
+*
+*******************************************************************************/
+static void sim_dma_end(sim_dma_channel_t* channel, cy_en_dma_intr_cause_t cause)
+{
+    channel->enabled = false;
+    channel->status  = cause;
+    channel->intr    = CY_DMA_INTR_MASK;
+
+    if (0U != channel->intr_mask)
+    {
+        sim_dma_pending = true;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_rx_pop
+********************************************************************************
+*
+* Reads the oldest byte of the RX FIFO.
+*
+*******************************************************************************/
+static uint8_t sim_rx_pop(sim_bus_t* bus)
+{
+    uint8_t value = bus->rx_fifo[0];
+
+    bus->rx_fifo_count--;
+    (void)memmove(&bus->rx_fifo[0], &bus->rx_fifo[1], bus->rx_fifo_count);
+
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_serve_rx_fifo
+********************************************************************************
+*
+* Serves the RX FIFO as the hardware and the PDL do. The enabled DataWire
+* channel reading the FIFO is triggered while it holds more bytes than the
+* trigger level. The PDL interrupt, unless masked, reads the bytes of its
+* buffer, stops the automatic ACK before the last byte, and NAKs the last byte
+* followed by a Stop. With the interrupt masked nothing ends the read.
+*
+* \return
+* True if the PDL received its last byte.
+*
+*******************************************************************************/
+static bool sim_serve_rx_fifo(sim_bus_t* bus, cy_stc_scb_i2c_context_t* context)
+{
+    sim_dma_channel_t* channel = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < FT5406_SIM_DMA_CHANNELS; i++)
+    {
+        if (sim_dma_channels[i].enabled &&
+            (sim_dma_channels[i].src == (void const*)&SCB_RX_FIFO_RD(bus->scb)))
+        {
+            channel = &sim_dma_channels[i];
+        }
+    }
+
+    while ((NULL != channel) && channel->enabled && (bus->rx_fifo_level < bus->rx_fifo_count))
+    {
+        if (channel->error)
+        {
+            sim_dma_end(channel, CY_DMA_INTR_CAUSE_DST_BUS_ERROR);
+        }
+        else
+        {
+            *channel->dst = sim_rx_pop(bus);
+            channel->dst++;
+            channel->remaining--;
+            bus->stats.dma_bytes++;
+
+            if (0U == channel->remaining)
+            {
+                sim_dma_end(channel, CY_DMA_INTR_CAUSE_COMPLETION);
+            }
+        }
+    }
+
+    if (0U != bus->rx_intr_mask)
+    {
+        while ((0U != bus->rx_fifo_count) &&
+               (context->masterBufferIdx < context->masterBufferSize))
+        {
+            context->masterBuffer[context->masterBufferIdx] = sim_rx_pop(bus);
+            context->masterBufferIdx++;
+        }
+
+        if ((context->masterBufferIdx + 1U) >= context->masterBufferSize)
+        {
+            bus->rx_auto_ack = false;
+        }
+        if (context->masterBufferIdx == context->masterBufferSize)
+        {
+            return true;
+        }
+        if (bus->rx_ack_pending && (!bus->rx_auto_ack))
+        {
+            /* The PDL ACKs the byte before the last one */
+            bus->rx_ack_pending = false;
+        }
+    }
+
+    if (bus->rx_ack_pending && bus->rx_auto_ack && (SIM_RX_FIFO_SIZE > bus->rx_fifo_count))
+    {
+        bus->rx_ack_pending = false;
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_receive
+********************************************************************************
+*
+* Receives the bytes of a read due at the transfer end time into the RX FIFO,
+* serving the FIFO after each byte. The next byte is received after an ACK; a
+* byte which is not ACKed stretches the clock until the FIFO is served again.
+*
+* \return
+* True if the read completed with a NAK and Stop.
+*
+*******************************************************************************/
+static bool sim_receive(sim_bus_t* bus, cy_stc_scb_i2c_context_t* context)
+{
+    bool complete = sim_serve_rx_fifo(bus, context);
+
+    while ((!complete) && (!bus->rx_ack_pending) && (0U != bus->rx_planned))
+    {
+        bus->rx_fifo[bus->rx_fifo_count] = bus->regs[bus->reg_ptr];
+        bus->rx_fifo_count++;
+        bus->reg_ptr++;
+        bus->rx_bytes++;
+        bus->rx_planned--;
+        bus->rx_ack_pending = true;
+
+        complete = sim_serve_rx_fifo(bus, context);
+    }
+    bus->rx_planned = 0U;
+
+    if ((!complete) && (!bus->rx_ack_pending))
+    {
+        bus->rx_planned  = 1U;
+        bus->xfer_end_us = sim_time_us + sim_bus_time_us(SIM_BITS_PER_BYTE);
+    }
+    bus->rx_waiting = (!complete) && bus->rx_ack_pending;
+
+    return complete;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_resume_rx
+********************************************************************************
+*
+* Serves the RX FIFO of a read waiting for it at once, after its readers
+* changed.
+*
+*******************************************************************************/
+static void sim_resume_rx(sim_bus_t* bus)
+{
+    if (bus->xfer_active && bus->rx_waiting)
+    {
+        bus->rx_waiting  = false;
+        bus->xfer_end_us = sim_time_us;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_deliver
+********************************************************************************
+*
+* Delivers the due transfer completions and INT assertions of all buses, and
+* the DataWire channel interrupts, as interrupts, unless interrupts are masked or already being served by the
+* calling thread.
+*
+*******************************************************************************/
+static void sim_deliver(void)
+{
+    bool delivered = true;
+    sim_bus_t* bus;
+    uint32_t i;
+
+    while (delivered && (0U == sim_mask_nesting) && (!sim_in_isr))
+    {
+        delivered = false;
+
+        for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+        {
+            bus = &sim_buses[i];
+
+            if (bus->xfer_active && (!bus->xfer_stalled) && (!bus->rx_waiting) &&
+                (bus->xfer_end_us <= sim_time_us))
+            {
+                sim_in_isr = true;
+                Cy_SCB_I2C_Interrupt(bus->scb, bus->xfer_context);
+                sim_in_isr = false;
+                delivered = true;
+            }
+
+            if (bus->int_pending && (NULL != bus->int_isr))
+            {
+                bus->int_pending = false;
+                sim_in_isr = true;
+                bus->int_isr();
+                sim_in_isr = false;
+                delivered = true;
+            }
+        }
+
+        if (sim_dma_pending && (NULL != sim_dma_isr))
+        {
+            sim_dma_pending = false;
+            sim_in_isr = true;
+            sim_dma_isr();
+            sim_in_isr = false;
+            delivered = true;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_next_end_us
+********************************************************************************
+*
+* Returns the end time of the transfer completing next on any bus, or
+* UINT64_MAX if no transfer is in progress.
+*
+*******************************************************************************/
+static uint64_t sim_next_end_us(void)
+{
+    uint64_t next_us = UINT64_MAX;
+    uint32_t i;
+
+    for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+    {
+        if (sim_buses[i].xfer_active && (!sim_buses[i].xfer_stalled) &&
+            (!sim_buses[i].rx_waiting) && (sim_buses[i].xfer_end_us < next_us))
+        {
+            next_us = sim_buses[i].xfer_end_us;
+        }
+    }
+
+    return next_us;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_advance
+********************************************************************************
+*
+* Advances the simulated time, delivering the transfer completions on time.
+*
+*******************************************************************************/
+static void sim_advance(uint64_t time_us)
+{
+    uint64_t end_us;
+    uint64_t next_us;
+
+    sim_lock();
+
+    end_us  = sim_time_us + time_us;
+    next_us = sim_next_end_us();
+    while ((next_us <= end_us) && (0U == sim_mask_nesting) && (!sim_in_isr))
+    {
+        if (sim_time_us < next_us)
+        {
+            sim_time_us = next_us;
+        }
+        sim_deliver();
+        next_us = sim_next_end_us();
+    }
+    sim_time_us = end_us;
+    sim_deliver();
+
+    sim_unlock();
+
+    /* Let other threads run, e.g. the holder of a lock polled by the caller */
+    (void)sched_yield();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_reset
+********************************************************************************
+*
+* Resets the simulator: time 0, default bus speed, and on every bus no faults,
+* no touch, and the FT5406 identification registers set. Selects bus 0. The
+* DataWire channels are disabled, without interrupt handler and faults.
+*
+*******************************************************************************/
+void ft5406_sim_reset(void)
+{
+    sim_bus_t* bus;
+    uint32_t i;
+
+    sim_lock();
+
+    sim_time_us           = 0U;
+    sim_bus_hz            = FT5406_SIM_BUS_HZ_DEFAULT;
+    sim_critical_sections = 0U;
+
+    for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+    {
+        bus = &sim_buses[i];
+
+        bus->reg_ptr       = 0U;
+        bus->nak_count     = 0U;
+        bus->timeout_count = 0U;
+        bus->xfer_hook     = NULL;
+        bus->xfer_active   = false;
+        bus->int_isr       = NULL;
+        bus->int_status    = 0U;
+        bus->int_pending   = false;
+        bus->rx_intr_mask  = 0U;
+        bus->rx_fifo_level = 0U;
+        bus->rx_waiting    = false;
+        (void)memset(&bus->stats, 0, sizeof(bus->stats));
+        (void)memset(bus->regs, 0, sizeof(bus->regs));
+
+        bus->regs[SIM_REG_ID_G_LIB_VERSION_H] = 0x30U;
+        bus->regs[SIM_REG_ID_G_LIB_VERSION_L] = 0x03U;
+        bus->regs[SIM_REG_ID_G_CIPHER]        = 0x55U;
+        bus->regs[SIM_REG_ID_G_FIRMID]        = 0x10U;
+        bus->regs[SIM_REG_ID_G_VENDOR_ID]     = 0x51U;
+
+        sim_bus = bus;
+        ft5406_sim_set_touches(0U, NULL);
+    }
+    sim_bus = &sim_buses[0];
+
+    (void)memset(sim_dma_channels, 0, sizeof(sim_dma_channels));
+    sim_dma_isr         = NULL;
+    sim_dma_pending     = false;
+    sim_dma_error_count = 0U;
+
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_select_bus
+********************************************************************************
+*
+* Selects the bus the following configuration calls apply to: fault injection,
+* touch data, registers, hooks, the INT pin, and the traffic counters.
+*
+* \param bus
+* Bus index, 0 for ft5406_sim_scb and 1 for ft5406_sim_scb_2.
+*
+*******************************************************************************/
+void ft5406_sim_select_bus(uint32_t bus)
+{
+    CY_ASSERT(FT5406_SIM_BUS_COUNT > bus);
+
+    sim_lock();
+    sim_bus = &sim_buses[bus];
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_bus_hz
+********************************************************************************
+*
+* Sets the I2C bus speed used for the following transfers.
+*
+* \param bus_hz
+* Bus speed in Hz.
+*
+*******************************************************************************/
+void ft5406_sim_set_bus_hz(uint32_t bus_hz)
+{
+    CY_ASSERT(0U != bus_hz);
+
+    sim_lock();
+    sim_bus_hz = bus_hz;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_inject_nak
+********************************************************************************
+*
+* Makes the FT5406 NAK its address on the next transfers.
+*
+* \param count
+* Number of transfers to NAK.
+*
+*******************************************************************************/
+void ft5406_sim_inject_nak(uint32_t count)
+{
+    sim_lock();
+    sim_bus->nak_count = count;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_inject_timeout
+********************************************************************************
+*
+* Makes the next transfers stall until they are aborted, as if the FT5406
+* held the clock low.
+*
+* \param count
+* Number of transfers to stall.
+*
+*******************************************************************************/
+void ft5406_sim_inject_timeout(uint32_t count)
+{
+    sim_lock();
+    sim_bus->timeout_count = count;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_touches
+********************************************************************************
+*
+* Sets the touch data registers from 0x01: gesture ID 0, the touch count, and
+* the touch points. Vacant touch points read 0xFF.
+*
+* \param count
+* Number of touch points, up to 5.
+*
+* \param touches
+* Touch points, can be NULL if count is 0.
+*
+*******************************************************************************/
+void ft5406_sim_set_touches(uint32_t count, const ft5406_sim_touch_t* touches)
+{
+    uint8_t* point;
+    uint32_t i;
+
+    CY_ASSERT(SIM_MAX_TOUCHES >= count);
+
+    sim_lock();
+
+    sim_bus->regs[SIM_REG_GEST_ID]   = 0U;
+    sim_bus->regs[SIM_REG_TD_STATUS] = (uint8_t)count;
+
+    for (i = 0U; i < SIM_MAX_TOUCHES; i++)
+    {
+        point = &sim_bus->regs[SIM_REG_TOUCH1 + (i * SIM_TOUCH_POINT_LEN)];
+
+        if (i < count)
+        {
+            point[0] = (uint8_t)((touches[i].event << 6U) | ((touches[i].x >> 8U) & 0x0FU));
+            point[1] = (uint8_t)touches[i].x;
+            point[2] = (uint8_t)((touches[i].id << 4U) | ((touches[i].y >> 8U) & 0x0FU));
+            point[3] = (uint8_t)touches[i].y;
+            point[4] = 0U;
+            point[5] = 0U;
+        }
+        else
+        {
+            (void)memset(point, 0xFF, SIM_TOUCH_POINT_LEN);
+        }
+    }
+
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_reg
+********************************************************************************
+*
+* Sets an FT5406 register without bus traffic.
+*
+*******************************************************************************/
+void ft5406_sim_set_reg(uint8_t reg_addr, uint8_t value)
+{
+    sim_lock();
+    sim_bus->regs[reg_addr] = value;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_get_reg
+********************************************************************************
+*
+* Returns an FT5406 register without bus traffic.
+*
+*******************************************************************************/
+uint8_t ft5406_sim_get_reg(uint8_t reg_addr)
+{
+    uint8_t value;
+
+    sim_lock();
+    value = sim_bus->regs[reg_addr];
+    sim_unlock();
+
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_xfer_hook
+********************************************************************************
+*
+* Sets the hook called at the start of every transfer, NULL to remove it.
+*
+*******************************************************************************/
+void ft5406_sim_set_xfer_hook(ft5406_sim_hook_t hook)
+{
+    sim_lock();
+    sim_bus->xfer_hook = hook;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_int_isr
+********************************************************************************
+*
+* Sets the GPIO interrupt handler of the INT pin, e.g. mtb_ctp_ft5406_int_handler.
+*
+*******************************************************************************/
+void ft5406_sim_set_int_isr(void (* isr)(void))
+{
+    sim_lock();
+    sim_bus->int_isr = isr;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_assert_int
+********************************************************************************
+*
+* Pulses the INT pin as the FT5406 does after a scan and delivers the GPIO
+* interrupt.
+*
+*******************************************************************************/
+void ft5406_sim_assert_int(void)
+{
+    sim_lock();
+    sim_bus->int_status  = 1U;
+    sim_bus->int_pending = true;
+    sim_deliver();
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_set_dma_isr
+********************************************************************************
+*
+* Sets the interrupt handler of the DataWire channels, e.g.
+* mtb_ctp_ft5406_dma_handler.
+*
+*******************************************************************************/
+void ft5406_sim_set_dma_isr(void (* isr)(void))
+{
+    sim_lock();
+    sim_dma_isr = isr;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_inject_dma_error
+********************************************************************************
+*
+* Makes the next DataWire transfers end with a bus error on their first byte.
+*
+* \param count
+* Number of transfers to fail.
+*
+*******************************************************************************/
+void ft5406_sim_inject_dma_error(uint32_t count)
+{
+    sim_lock();
+    sim_dma_error_count = count;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_run
+********************************************************************************
+*
+* Advances the simulated time, e.g. while the application does other work.
+*
+* \param time_us
+* Time in microseconds.
+*
+*******************************************************************************/
+void ft5406_sim_run(uint32_t time_us)
+{
+    sim_advance(time_us);
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_now_us
+********************************************************************************
+*
+* Returns the simulated time, usable as timestamp source of the driver.
+*
+*******************************************************************************/
+uint32_t ft5406_sim_now_us(void)
+{
+    uint32_t now;
+
+    sim_lock();
+    now = (uint32_t)sim_time_us;
+    sim_unlock();
+
+    return now;
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_get_stats
+********************************************************************************
+*
+* Returns the bus traffic counters since the last reset.
+*
+*******************************************************************************/
+void ft5406_sim_get_stats(ft5406_sim_stats_t* stats)
+{
+    sim_lock();
+    *stats = sim_bus->stats;
+    sim_unlock();
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_get_critical_sections
+********************************************************************************
+*
+* Returns the number of critical sections entered since the last reset.
+*
+*******************************************************************************/
+uint32_t ft5406_sim_get_critical_sections(void)
+{
+    uint32_t count;
+
+    sim_lock();
+    count = sim_critical_sections;
+    sim_unlock();
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: ft5406_sim_in_critical_section
+********************************************************************************
+*
+* Checks whether the calling thread has interrupts masked by a critical
+* section.
+*
+*******************************************************************************/
+bool ft5406_sim_in_critical_section(void)
+{
+    return (0U != sim_mask_nesting);
+}
+
+
+/*******************************************************************************
+* PDL stand-in
+*******************************************************************************/
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterWrite(CySCB_Type* base,
+                                              cy_stc_scb_i2c_master_xfer_config_t* xferConfig,
+                                              cy_stc_scb_i2c_context_t* context)
+{
+    return sim_start_xfer(sim_find_bus(base), xferConfig, context, false);
+}
+
+
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterRead(CySCB_Type* base,
+                                             cy_stc_scb_i2c_master_xfer_config_t* xferConfig,
+                                             cy_stc_scb_i2c_context_t* context)
+{
+    return sim_start_xfer(sim_find_bus(base), xferConfig, context, true);
+}
+
+
+uint32_t Cy_SCB_I2C_MasterGetStatus(CySCB_Type const* base,
+                                    cy_stc_scb_i2c_context_t const* context)
+{
+    CY_UNUSED_PARAMETER(base);
+
+    return context->masterStatus;
+}
+
+
+uint32_t Cy_SCB_I2C_MasterGetTransferCount(CySCB_Type const* base,
+                                           cy_stc_scb_i2c_context_t const* context)
+{
+    CY_UNUSED_PARAMETER(base);
+
+    return context->masterBufferIdx;
+}
+
+
+void Cy_SCB_I2C_MasterAbortWrite(CySCB_Type* base, cy_stc_scb_i2c_context_t* context)
+{
+    sim_end_xfer(sim_find_bus(base), context);
+}
+
+
+void Cy_SCB_I2C_MasterAbortRead(CySCB_Type* base, cy_stc_scb_i2c_context_t* context)
+{
+    sim_end_xfer(sim_find_bus(base), context);
+}
+
+
+void Cy_SCB_I2C_Disable(CySCB_Type* base, cy_stc_scb_i2c_context_t* context)
+{
+    sim_end_xfer(sim_find_bus(base), context);
+}
+
+
+void Cy_SCB_I2C_Enable(CySCB_Type* base)
+{
+    CY_UNUSED_PARAMETER(base);
+}
+
+
+void Cy_SCB_I2C_RegisterEventCallback(CySCB_Type const* base,
+                                      cy_cb_scb_i2c_handle_events_t callback,
+                                      cy_stc_scb_i2c_context_t* context)
+{
+    CY_UNUSED_PARAMETER(base);
+
+    context->cbEvents = callback;
+}
+
+
+/* Serves the transfer in progress, called by the simulator at its end time */
+void Cy_SCB_I2C_Interrupt(CySCB_Type* base, cy_stc_scb_i2c_context_t* context)
+{
+    sim_bus_t* bus = sim_find_bus(base);
+    uint32_t event;
+    uint32_t i;
+
+    sim_lock();
+
+    if (!bus->xfer_active)
+    {
+        sim_unlock();
+        return;
+    }
+
+    if (bus->xfer_nak)
+    {
+        bus->stats.bytes += 1U;
+        bus->stats.failed++;
+        context->masterStatus = CY_SCB_I2C_MASTER_ADDR_NAK;
+        event = CY_SCB_I2C_MASTER_ERR_EVENT;
+    }
+    else if (context->masterRdDir)
+    {
+        if (!sim_receive(bus, context))
+        {
+            /* No NAK and Stop yet, the read goes on */
+            sim_unlock();
+            return;
+        }
+        bus->stats.bytes += 1U + bus->rx_bytes;
+        context->masterStatus = 0U;
+        event = CY_SCB_I2C_MASTER_RD_CMPLT_EVENT;
+    }
+    else
+    {
+        /* The first byte sets the register pointer, the others are written */
+        for (i = 0U; i < context->masterBufferSize; i++)
+        {
+            if (0U == i)
+            {
+                bus->reg_ptr = context->masterBuffer[0];
+            }
+            else
+            {
+                bus->regs[bus->reg_ptr] = context->masterBuffer[i];
+                bus->reg_ptr++;
+            }
+        }
+        bus->stats.bytes += 1U + context->masterBufferSize;
+        context->masterBufferIdx = context->masterBufferSize;
+        context->masterStatus    = 0U;
+        event = CY_SCB_I2C_MASTER_WR_CMPLT_EVENT;
+    }
+    bus->xfer_active = false;
+
+    sim_unlock();
+
+    if (NULL != context->cbEvents)
+    {
+        context->cbEvents(event);
+    }
+}
+
+
+void Cy_SCB_SetRxInterruptMask(CySCB_Type* base, uint32_t interruptMask)
+{
+    sim_bus_t* bus = sim_find_bus(base);
+
+    sim_lock();
+    bus->rx_intr_mask = interruptMask;
+    sim_resume_rx(bus);
+    sim_unlock();
+}
+
+
+void Cy_DMA_Descriptor_SetSrcAddress(cy_stc_dma_descriptor_t* descriptor, void const* srcAddress)
+{
+    descriptor->src = srcAddress;
+}
+
+
+void Cy_DMA_Descriptor_SetDstAddress(cy_stc_dma_descriptor_t* descriptor, void const* dstAddress)
+{
+    descriptor->dst = (void*)dstAddress;
+}
+
+
+void Cy_DMA_Descriptor_SetXloopDataCount(cy_stc_dma_descriptor_t* descriptor, uint32_t xCount)
+{
+    descriptor->xCount = xCount;
+}
+
+
+void Cy_DMA_Channel_SetDescriptor(DW_Type* base, uint32_t channel,
+                                  cy_stc_dma_descriptor_t const* descriptor)
+{
+    sim_lock();
+    sim_dma_channel(base, channel)->descriptor = descriptor;
+    sim_unlock();
+}
+
+
+/* The channel loads its descriptor when enabled */
+void Cy_DMA_Channel_Enable(DW_Type* base, uint32_t channel)
+{
+    sim_dma_channel_t* dma_channel = sim_dma_channel(base, channel);
+    uint32_t i;
+
+    sim_lock();
+
+    CY_ASSERT(NULL != dma_channel->descriptor);
+    dma_channel->enabled   = true;
+    dma_channel->src       = dma_channel->descriptor->src;
+    dma_channel->dst       = (uint8_t*)dma_channel->descriptor->dst;
+    dma_channel->remaining = dma_channel->descriptor->xCount;
+    dma_channel->status    = CY_DMA_INTR_CAUSE_NO_INTR;
+    dma_channel->error     = (0U != sim_dma_error_count);
+    if (dma_channel->error)
+    {
+        sim_dma_error_count--;
+    }
+
+    for (i = 0U; i < FT5406_SIM_BUS_COUNT; i++)
+    {
+        if (dma_channel->src == (void const*)&SCB_RX_FIFO_RD(sim_buses[i].scb))
+        {
+            sim_resume_rx(&sim_buses[i]);
+        }
+    }
+
+    sim_unlock();
+}
+
+
+void Cy_DMA_Channel_Disable(DW_Type* base, uint32_t channel)
+{
+    sim_lock();
+    sim_dma_channel(base, channel)->enabled = false;
+    sim_unlock();
+}
+
+
+void Cy_DMA_Channel_SetInterruptMask(DW_Type* base, uint32_t channel, uint32_t interrupt)
+{
+    sim_lock();
+    sim_dma_channel(base, channel)->intr_mask = interrupt;
+    sim_unlock();
+}
+
+
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const* base, uint32_t channel)
+{
+    uint32_t intr;
+
+    sim_lock();
+    intr = sim_dma_channel(base, channel)->intr;
+    sim_unlock();
+
+    return intr;
+}
+
+
+void Cy_DMA_Channel_ClearInterrupt(DW_Type* base, uint32_t channel)
+{
+    sim_lock();
+    sim_dma_channel(base, channel)->intr = 0U;
+    sim_unlock();
+}
+
+
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const* base, uint32_t channel)
+{
+    cy_en_dma_intr_cause_t status;
+
+    sim_lock();
+    status = sim_dma_channel(base, channel)->status;
+    sim_unlock();
+
+    return status;
+}
+
+
+uint32_t Cy_GPIO_GetInterruptStatusMasked(const GPIO_PRT_Type* base, uint32_t pinNum)
+{
+    CY_UNUSED_PARAMETER(pinNum);
+
+    return sim_find_int_bus(base)->int_status;
+}
+
+
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type* base, uint32_t pinNum)
+{
+    CY_UNUSED_PARAMETER(pinNum);
+
+    sim_find_int_bus(base)->int_status = 0U;
+}
+
+
+void Cy_SysLib_Delay(uint32_t milliseconds)
+{
+    sim_advance((uint64_t)milliseconds * 1000U);
+}
+
+
+void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    sim_advance(microseconds);
+}
+
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    sim_lock();
+    sim_mask_nesting++;
+    sim_critical_sections++;
+
+    return 0U;
+}
+
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    CY_UNUSED_PARAMETER(savedIntrStatus);
+    CY_ASSERT(0U != sim_mask_nesting);
+
+    sim_mask_nesting--;
+    sim_deliver();
+    sim_unlock();
+}
+
+
+uint32_t __get_IPSR(void)
+{
+    return sim_in_isr ? SIM_ISR_IPSR : 0U;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,133 @@
+/*******************************************************************************
+* \file ft5406_sim.h
+*
+* \brief
+* Provides the API of the host FT5406 bus simulator. The simulator implements
+* the PDL stand-in of cy_pdl.h: an SCB I2C controller with a simulated clock
+* and bus speed, and an FT5406 register model with NAK and timeout injection,
+* on each of FT5406_SIM_BUS_COUNT buses, and a DataWire block whose channels
+* can read the RX FIFO of the SCBs.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef FT5406_SIM_H
+#define FT5406_SIM_H
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of simulated SCBs, each with an FT5406 and its INT pin */
+#define FT5406_SIM_BUS_COUNT                  (2U)
+
+/* Number of channels of the simulated DataWire block */
+#define FT5406_SIM_DMA_CHANNELS               (4U)
+
+/* Bus speed after ft5406_sim_reset() */
+#define FT5406_SIM_BUS_HZ_DEFAULT             (400000U)
+
+/* Touch event values of the FT5406 touch point registers */
+#define FT5406_SIM_EVENT_DOWN                 (0U)
+#define FT5406_SIM_EVENT_UP                   (1U)
+#define FT5406_SIM_EVENT_CONTACT              (2U)
+
+
+/*******************************************************************************
+* Data Structures
+*******************************************************************************/
+/* Touch point reported by the simulated FT5406 */
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t id;     /* Touch ID, 0 to 15 */
+    uint8_t event;  /* FT5406_SIM_EVENT_* */
+} ft5406_sim_touch_t;
+
+/* Bus traffic counters of one bus */
+typedef struct
+{
+    uint32_t transactions;  /* Transfers started, each write or read phase counts */
+    uint32_t bytes;         /* Bytes on the bus, including address bytes */
+    uint32_t failed;        /* Transfers ended by a NAK or aborted after a timeout */
+    uint32_t dma_bytes;     /* Received bytes moved from the RX FIFO by DMA */
+} ft5406_sim_stats_t;
+
+/* Hook called at the start of every transfer, e.g. to change the touch data */
+typedef void (* ft5406_sim_hook_t)(uint32_t transaction);
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* SCBs and INT pin ports connected to the simulated FT5406s of bus 0 and 1 */
+extern CySCB_Type ft5406_sim_scb;
+extern GPIO_PRT_Type ft5406_sim_int_port;
+extern CySCB_Type ft5406_sim_scb_2;
+extern GPIO_PRT_Type ft5406_sim_int_port_2;
+
+/* DataWire block. A channel reading SCB_RX_FIFO_RD of an SCB is triggered by
+ * the RX FIFO of that SCB. */
+extern DW_Type ft5406_sim_dw;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ft5406_sim_reset(void);
+void ft5406_sim_select_bus(uint32_t bus);
+void ft5406_sim_set_bus_hz(uint32_t bus_hz);
+void ft5406_sim_inject_nak(uint32_t count);
+void ft5406_sim_inject_timeout(uint32_t count);
+void ft5406_sim_set_touches(uint32_t count, const ft5406_sim_touch_t* touches);
+void ft5406_sim_set_reg(uint8_t reg_addr, uint8_t value);
+uint8_t ft5406_sim_get_reg(uint8_t reg_addr);
+void ft5406_sim_set_xfer_hook(ft5406_sim_hook_t hook);
+void ft5406_sim_set_int_isr(void (* isr)(void));
+void ft5406_sim_assert_int(void);
+void ft5406_sim_set_dma_isr(void (* isr)(void));
+void ft5406_sim_inject_dma_error(uint32_t count);
+void ft5406_sim_run(uint32_t time_us);
+uint32_t ft5406_sim_now_us(void);
+void ft5406_sim_get_stats(ft5406_sim_stats_t* stats);
+uint32_t ft5406_sim_get_critical_sections(void);
+bool ft5406_sim_in_critical_section(void);
+
+
+#if defined(__cplusplus)
+}
+#endif /* __cplusplus */
+
+
+#endif /* FT5406_SIM_H */
+
+
+/* [] END OF FILE */
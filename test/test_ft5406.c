@@ -0,0 +1,2795 @@
+/*******************************************************************************
+* \file test_ft5406.c
+*
+* \brief
+* Host tests of the FT5406 driver library on the FT5406 bus simulator.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "mtb_ctp_ft5406.h"
+#include "mtb_ctp_ft5406_bus_lock.h"
+#include "mtb_ctp_ft5406_capture.h"
+#include "mtb_ctp_ft5406_frame_ring.h"
+#include "mtb_ctp_ft5406_gesture.h"
+#include "mtb_ctp_ft5406_scheduler.h"
+#include "mtb_ctp_ft5406_trace.h"
+#include "mtb_ctp_ft5406_tracker.h"
+#include "ft5406_sim.h"
+#include "test_utils.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+unsigned int test_failures;
+
+static cy_stc_scb_i2c_context_t i2c_context;
+static mtb_ctp_ft5406_config_t ft5406_config;
+
+static const ft5406_sim_touch_t two_touches[] =
+{
+    { .x = 100U, .y = 200U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 300U, .y = 400U, .id = 1U, .event = FT5406_SIM_EVENT_DOWN }
+};
+
+
+/*******************************************************************************
+* Function Name: setup
+********************************************************************************
+*
+* Resets the simulator and initializes the driver in polling mode.
+*
+*******************************************************************************/
+static void setup(void)
+{
+    ft5406_sim_reset();
+
+    (void)memset(&i2c_context, 0, sizeof(i2c_context));
+    (void)memset(&ft5406_config, 0, sizeof(ft5406_config));
+    ft5406_config.i2c_base         = &ft5406_sim_scb;
+    ft5406_config.i2c_context      = &i2c_context;
+    ft5406_config.get_timestamp_us = ft5406_sim_now_us;
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    TEST_ASSERT_EQUAL(0x00U, ft5406_sim_get_reg(MTB_CTP_FT5406_DEVICE_MODE));
+}
+
+
+/*******************************************************************************
+* Function Name: test_read_multi_touch
+********************************************************************************
+*
+* A touch read is one repeated Start transaction and reports all touch points.
+*
+*******************************************************************************/
+static void test_read_multi_touch(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    int touch_count = 0;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(100, touch_array[0].touch_x);
+    TEST_ASSERT_EQUAL(200, touch_array[0].touch_y);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_CONTACT, touch_array[0].touch_event);
+    TEST_ASSERT_EQUAL(1, touch_array[1].touch_id);
+    TEST_ASSERT_EQUAL(300, touch_array[1].touch_x);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, touch_array[1].touch_event);
+
+    /* Register address write and data read after repeated Start */
+    TEST_ASSERT_EQUAL(2U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(0U, after.failed - before.failed);
+}
+
+
+/*******************************************************************************
+* Function Name: test_nak_is_retried
+********************************************************************************
+*
+* A NAKed touch read is retried and succeeds.
+*
+*******************************************************************************/
+static void test_nak_is_retried(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t stats;
+    int touch_count = 0;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_inject_nak(2U);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+
+    ft5406_sim_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2U, stats.failed);
+}
+
+
+/*******************************************************************************
+* Function Name: test_timeout_is_retried
+********************************************************************************
+*
+* A stalled touch read is aborted after the timeout and retried.
+*
+*******************************************************************************/
+static void test_timeout_is_retried(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t stats;
+    uint32_t start;
+    int touch_count = 0;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_inject_timeout(1U);
+
+    start = ft5406_sim_now_us();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+
+    ft5406_sim_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1U, stats.failed);
+    /* The default timeout of an attempt is 10 ms */
+    TEST_ASSERT((ft5406_sim_now_us() - start) >= 10000U);
+}
+
+
+/*******************************************************************************
+* Function Name: test_retry_timeout_limit
+********************************************************************************
+*
+* A completion timeout near UINT32_MAX is limited instead of wrapping to 0
+* when it is rounded up to whole poll intervals.
+*
+*******************************************************************************/
+static void test_retry_timeout_limit(void)
+{
+    mtb_ctp_ft5406_retry_t retry = { .timeout_us = UINT32_MAX - 5U };
+
+    setup();
+
+    mtb_ctp_ft5406_set_retry(&retry);
+    TEST_ASSERT_EQUAL(4294967290U, ft5406_config.retry_policy.timeout_us);
+
+    retry.timeout_us = 15U;
+    mtb_ctp_ft5406_set_retry(&retry);
+    TEST_ASSERT_EQUAL(20U, ft5406_config.retry_policy.timeout_us);
+
+    mtb_ctp_ft5406_set_retry(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: test_persistent_nak_fails
+********************************************************************************
+*
+* A touch read fails with the NAK status once all attempts are NAKed.
+*
+*******************************************************************************/
+static void test_persistent_nak_fails(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+
+    setup();
+    ft5406_sim_inject_nak(100U);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK,
+                      mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+
+    ft5406_sim_inject_nak(0U);
+}
+
+
+/*******************************************************************************
+* Function Name: test_event_mode
+********************************************************************************
+*
+* In event mode, the INT assertion reads the frame and the touch outputs serve
+* it without bus access.
+*
+*******************************************************************************/
+static void test_event_mode(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    int touch_count = 0;
+
+    ft5406_sim_reset();
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    ft5406_config.int_pin  = 0U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_assert_int();
+    TEST_ASSERT(mtb_ctp_ft5406_is_busy());
+    ft5406_sim_run(5000U);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(300, touch_array[1].touch_x);
+    TEST_ASSERT_EQUAL(before.transactions, after.transactions);
+
+    ft5406_config.int_port = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_adaptive_reread
+********************************************************************************
+*
+* In adaptive read mode, a frame with more touch points than the previous one
+* is re-read whole, so a touch report between the transactions does not tear
+* the frame.
+*
+*******************************************************************************/
+static const ft5406_sim_touch_t three_touches[] =
+{
+    { .x = 10U, .y = 20U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 30U, .y = 40U, .id = 1U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 50U, .y = 60U, .id = 2U, .event = FT5406_SIM_EVENT_DOWN }
+};
+
+static const ft5406_sim_touch_t three_touches_moved[] =
+{
+    { .x = 11U, .y = 21U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 31U, .y = 41U, .id = 1U, .event = FT5406_SIM_EVENT_CONTACT },
+    { .x = 51U, .y = 61U, .id = 2U, .event = FT5406_SIM_EVENT_CONTACT }
+};
+
+static uint32_t reread_transaction;
+
+static void move_touches_hook(uint32_t transaction)
+{
+    if (transaction == reread_transaction)
+    {
+        ft5406_sim_set_touches(3U, three_touches_moved);
+    }
+}
+
+
+static void test_adaptive_reread(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t stats;
+    int touch_count = 0;
+    int i;
+
+    setup();
+    ft5406_config.read_mode = MTB_CTP_FT5406_READ_ADAPTIVE;
+    ft5406_sim_set_touches(1U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(1, touch_count);
+
+    /* The touch report changes before the re-read of the grown frame */
+    ft5406_sim_set_touches(3U, three_touches);
+    ft5406_sim_get_stats(&stats);
+    reread_transaction = stats.transactions + 3U;
+    ft5406_sim_set_xfer_hook(move_touches_hook);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_set_xfer_hook(NULL);
+
+    TEST_ASSERT_EQUAL(3, touch_count);
+    for (i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL(three_touches_moved[i].x, touch_array[i].touch_x);
+        TEST_ASSERT_EQUAL(three_touches_moved[i].y, touch_array[i].touch_y);
+    }
+
+    ft5406_config.read_mode = MTB_CTP_FT5406_READ_FULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_scheduler_retry
+********************************************************************************
+*
+* A scheduler transition whose register writes fail keeps the scheduler state
+* and is retried on the next update.
+*
+*******************************************************************************/
+static void test_scheduler_retry(void)
+{
+    static const mtb_ctp_ft5406_scheduler_config_t scheduler_config =
+    {
+        .active_period = 6U,
+        .idle_period   = 40U
+    };
+    mtb_ctp_ft5406_scheduler_t scheduler;
+    uint32_t now;
+
+    ft5406_sim_reset();
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+
+    now = ft5406_sim_now_us();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                      mtb_ctp_ft5406_scheduler_init(&scheduler, &ft5406_config,
+                                                    &scheduler_config, now));
+    TEST_ASSERT(scheduler.active);
+    TEST_ASSERT_EQUAL(6U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_PERIOD_ACTIVE));
+
+    /* The idle transition meets a touch read in progress */
+    now += 1000000U;
+    ft5406_sim_assert_int();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_NOT_READY,
+                      mtb_ctp_ft5406_scheduler_update(&scheduler, now, 0));
+    TEST_ASSERT(scheduler.active);
+
+    ft5406_sim_run(5000U);
+    now += 5000U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_scheduler_update(&scheduler, now, 0));
+    TEST_ASSERT(!scheduler.active);
+    TEST_ASSERT_EQUAL(40U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_PERIOD_ACTIVE));
+
+    ft5406_config.int_port = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_register_shadow
+********************************************************************************
+*
+* The typed register accessors go through the register shadow: known values
+* are not written again, identification and settings reads are served from
+* the shadow, and changed settings are written in one burst.
+*
+*******************************************************************************/
+static void test_register_shadow(void)
+{
+    static const mtb_ctp_ft5406_tuning_t tuning =
+    {
+        .threshold        = 40U,
+        .peak_threshold   = 60U,
+        .focus_threshold  = 16U,
+        .filter_threshold = 32U,
+        .active_period    = 12U,
+        .monitor_period   = 40U
+    };
+    mtb_ctp_ft5406_tuning_t read_tuning;
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    uint8_t firmware_id = 0U;
+
+    setup();
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_firmware_id(&firmware_id));
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_firmware_id(&firmware_id));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(ft5406_sim_get_reg(MTB_CTP_FT5406_G_FIRMID), firmware_id);
+    TEST_ASSERT_EQUAL(2U, after.transactions - before.transactions);
+
+    /* The settings are read in one transaction, then served from the shadow */
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_tuning(&read_tuning));
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_set_tuning(&tuning));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(1U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(60U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_THPEAK));
+    TEST_ASSERT_EQUAL(32U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_THDIFF));
+    TEST_ASSERT_EQUAL(40U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_PERIOD_MONITOR));
+
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_set_threshold(40U));
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_tuning(&read_tuning));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(0U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(0, memcmp(&tuning, &read_tuning, sizeof(tuning)));
+
+    /* Automatic Monitor mode is one burst write of G_CTRL and G_TIME_ENTER_MONITOR */
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_set_auto_monitor(5U));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(1U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_CTRL_AUTO_MONITOR, ft5406_sim_get_reg(MTB_CTP_FT5406_G_CTRL));
+    TEST_ASSERT_EQUAL(5U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_TIME_ENTER_MONITOR));
+}
+
+
+/*******************************************************************************
+* Function Name: test_failed_register_write
+********************************************************************************
+*
+* A register change which fails to be written is discarded: the next setter
+* writes its own register only, and the settings read back hold the FT5406
+* value.
+*
+*******************************************************************************/
+static void test_failed_register_write(void)
+{
+    static const mtb_ctp_ft5406_retry_t retry = { .max_attempts = 1U };
+    mtb_ctp_ft5406_tuning_t read_tuning;
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    uint8_t threshold;
+
+    setup();
+    mtb_ctp_ft5406_set_retry(&retry);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_tuning(&read_tuning));
+    threshold = ft5406_sim_get_reg(MTB_CTP_FT5406_G_THGROUP);
+
+    ft5406_sim_inject_nak(1U);
+    TEST_ASSERT(CY_SCB_I2C_SUCCESS != mtb_ctp_ft5406_set_threshold((uint8_t)(threshold + 1U)));
+    TEST_ASSERT_EQUAL(threshold, ft5406_sim_get_reg(MTB_CTP_FT5406_G_THGROUP));
+
+    /* The report period is written alone */
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_set_report_period(12U));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(1U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(12U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_PERIOD_ACTIVE));
+    TEST_ASSERT_EQUAL(threshold, ft5406_sim_get_reg(MTB_CTP_FT5406_G_THGROUP));
+
+    /* The threshold is read from the FT5406 again */
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_tuning(&read_tuning));
+    TEST_ASSERT_EQUAL(threshold, read_tuning.threshold);
+    TEST_ASSERT_EQUAL(12U, read_tuning.active_period);
+
+    /* The failed value is not skipped as already written */
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_set_threshold((uint8_t)(threshold + 1U)));
+    TEST_ASSERT_EQUAL(threshold + 1U, ft5406_sim_get_reg(MTB_CTP_FT5406_G_THGROUP));
+
+    mtb_ctp_ft5406_set_retry(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: test_stats
+********************************************************************************
+*
+* The I2C transaction statistics count the transfers of touch reads completed
+* in the interrupt and of blocking register writes alike.
+*
+*******************************************************************************/
+static void test_stats(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    mtb_ctp_ft5406_stats_t stats;
+    int touch_count = 0;
+    uint32_t i;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_inject_nak(1U);
+    mtb_ctp_ft5406_reset_stats();
+    ft5406_sim_get_stats(&before);
+
+    for (i = 0U; i < 8U; i++)
+    {
+        TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                          mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+        TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                          mtb_ctp_ft5406_set_threshold((uint8_t)(i + 1U)));
+    }
+
+    ft5406_sim_get_stats(&after);
+    mtb_ctp_ft5406_get_stats(&stats);
+    /* A touch read is one repeated Start transaction of two simulated transfers */
+    TEST_ASSERT_EQUAL(after.transactions - before.transactions - 8U, stats.transactions);
+    TEST_ASSERT_EQUAL(1U, stats.addr_nak);
+}
+
+
+/*******************************************************************************
+* Function Name: test_zero_panel_size_transform
+********************************************************************************
+*
+* A transform without the panel size is ignored and panel coordinates are
+* reported.
+*
+*******************************************************************************/
+static void test_zero_panel_size_transform(void)
+{
+    static const mtb_ctp_ft5406_transform_t transform =
+    {
+        .rotation       = MTB_CTP_FT5406_ROTATE_180,
+        .panel_width    = 0U,
+        .panel_height   = 480U,
+        .display_width  = 1024U,
+        .display_height = 600U
+    };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    mtb_ctp_ft5406_set_transform(&transform);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(100, touch_array[0].touch_x);
+    TEST_ASSERT_EQUAL(200, touch_array[0].touch_y);
+
+    mtb_ctp_ft5406_set_transform(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: test_transform_rotation_scaling
+********************************************************************************
+*
+* Each rotation maps the panel corners onto the display, mirroring and
+* scaling combine with it, and a scaled matrix exceeding the Q16.16
+* coefficients is ignored instead of wrapping.
+*
+*******************************************************************************/
+static void transform_touch(const mtb_ctp_ft5406_transform_t* transform,
+                            uint16_t* touch_x, uint16_t* touch_y)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+
+    mtb_ctp_ft5406_set_transform(transform);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(1, touch_count);
+    *touch_x = touch_array[0].touch_x;
+    *touch_y = touch_array[0].touch_y;
+}
+
+
+static void test_transform_rotation_scaling(void)
+{
+    static const struct
+    {
+        mtb_ctp_ft5406_rotation_t rotation;
+        bool mirror_x;
+        bool mirror_y;
+        uint16_t display_width;
+        uint16_t display_height;
+        uint16_t touch_x;
+        uint16_t touch_y;
+    } cases[] =
+    {
+        /* Panel of 800 x 480, touch point at 100, 200 */
+        { MTB_CTP_FT5406_ROTATE_0,   false, false, 0U,    0U,    100U,  200U },
+        { MTB_CTP_FT5406_ROTATE_90,  false, false, 0U,    0U,    279U,  100U },
+        { MTB_CTP_FT5406_ROTATE_180, false, false, 0U,    0U,    699U,  279U },
+        { MTB_CTP_FT5406_ROTATE_270, false, false, 0U,    0U,    200U,  699U },
+        { MTB_CTP_FT5406_ROTATE_0,   true,  false, 1600U, 960U,  1398U, 400U },
+        { MTB_CTP_FT5406_ROTATE_90,  false, true,  960U,  1600U, 558U,  1398U },
+        { MTB_CTP_FT5406_ROTATE_180, true,  true,  400U,  240U,  50U,   100U },
+        { MTB_CTP_FT5406_ROTATE_270, true,  false, 240U,  1600U, 140U,  1398U },
+        /* The scaled offset of 799 counts exceeds the coefficients: panel coordinates */
+        { MTB_CTP_FT5406_ROTATE_180, false, false, 65535U, 65535U, 100U, 200U }
+    };
+    static const ft5406_sim_touch_t touch =
+    {
+        .x = 100U, .y = 200U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT
+    };
+    mtb_ctp_ft5406_transform_t transform = { .panel_width = 800U, .panel_height = 480U };
+    uint16_t touch_x = 0U;
+    uint16_t touch_y = 0U;
+    uint32_t i;
+
+    setup();
+    ft5406_sim_set_touches(1U, &touch);
+
+    for (i = 0U; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        transform.rotation       = cases[i].rotation;
+        transform.mirror_x       = cases[i].mirror_x;
+        transform.mirror_y       = cases[i].mirror_y;
+        transform.display_width  = cases[i].display_width;
+        transform.display_height = cases[i].display_height;
+
+        transform_touch(&transform, &touch_x, &touch_y);
+        TEST_ASSERT_EQUAL(cases[i].touch_x, touch_x);
+        TEST_ASSERT_EQUAL(cases[i].touch_y, touch_y);
+    }
+
+    /* A display 32768 times the panel size or more is ignored */
+    transform.rotation       = MTB_CTP_FT5406_ROTATE_0;
+    transform.mirror_x       = false;
+    transform.mirror_y       = false;
+    transform.panel_width    = 1U;
+    transform.display_width  = 40000U;
+    transform.display_height = 480U;
+    transform_touch(&transform, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(100U, touch_x);
+    TEST_ASSERT_EQUAL(200U, touch_y);
+
+    mtb_ctp_ft5406_set_transform(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: test_transform_calibrate
+********************************************************************************
+*
+* The calibration matrix of three touched targets maps the panel onto the
+* display like the matching rotation, mirroring and scaling, and no matrix is
+* computed from points on one line or when it exceeds the coefficients.
+*
+*******************************************************************************/
+static void test_transform_calibrate(void)
+{
+    /* Rotated by 180 degrees and scaled by 2 */
+    static const mtb_ctp_ft5406_point_t panel_points[3] =
+    {
+        { 100U, 100U }, { 700U, 100U }, { 100U, 400U }
+    };
+    static const mtb_ctp_ft5406_point_t display_points[3] =
+    {
+        { 1398U, 758U }, { 198U, 758U }, { 1398U, 158U }
+    };
+    static const mtb_ctp_ft5406_point_t line_points[3] =
+    {
+        { 100U, 100U }, { 200U, 200U }, { 300U, 300U }
+    };
+    static const mtb_ctp_ft5406_point_t unit_points[3] =
+    {
+        { 0U, 0U }, { 1U, 0U }, { 0U, 1U }
+    };
+    static const mtb_ctp_ft5406_point_t far_points[3] =
+    {
+        { 0U, 0U }, { UINT16_MAX, 0U }, { 0U, UINT16_MAX }
+    };
+    static const ft5406_sim_touch_t touch =
+    {
+        .x = 100U, .y = 200U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT
+    };
+    mtb_ctp_ft5406_transform_t transform = { .panel_width = 800U, .panel_height = 480U };
+    mtb_ctp_ft5406_affine_t calibration;
+    uint16_t touch_x = 0U;
+    uint16_t touch_y = 0U;
+
+    setup();
+    ft5406_sim_set_touches(1U, &touch);
+
+    TEST_ASSERT(mtb_ctp_ft5406_calibrate(panel_points, display_points, &calibration));
+    TEST_ASSERT_EQUAL(-(2 << 16), calibration.a);
+    TEST_ASSERT_EQUAL(0, calibration.b);
+    TEST_ASSERT_EQUAL(0, calibration.d);
+    TEST_ASSERT_EQUAL(-(2 << 16), calibration.e);
+
+    transform.calibration = &calibration;
+    transform_touch(&transform, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(1398U, touch_x);
+    TEST_ASSERT_EQUAL(558U, touch_y);
+
+    /* The same mapping from rotation and scaling */
+    transform.calibration    = NULL;
+    transform.rotation       = MTB_CTP_FT5406_ROTATE_180;
+    transform.display_width  = 1600U;
+    transform.display_height = 960U;
+    transform_touch(&transform, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(1398U, touch_x);
+    TEST_ASSERT_EQUAL(558U, touch_y);
+
+    TEST_ASSERT(!mtb_ctp_ft5406_calibrate(line_points, display_points, &calibration));
+    TEST_ASSERT(!mtb_ctp_ft5406_calibrate(unit_points, far_points, &calibration));
+
+    mtb_ctp_ft5406_set_transform(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: test_filter_jitter
+********************************************************************************
+*
+* With the deadband filter, a resting contact jittering by +-2 counts reports
+* a constant position in both output layouts and no frame changes, while a
+* larger movement is followed.
+*
+*******************************************************************************/
+static void test_filter_jitter(void)
+{
+    static const mtb_ctp_ft5406_filter_t filter = { .deadband = 2U };
+    static const int jitter[] = { 0, 2, -2, 1, -1, 2, 0, -2 };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_touch_soa_t touch_soa;
+    ft5406_sim_touch_t touch = { .x = 100U, .y = 200U, .id = 3U,
+                                 .event = FT5406_SIM_EVENT_DOWN };
+    int touch_count = 0;
+    bool changed = false;
+    uint32_t changes = 0U;
+    uint32_t i;
+
+    setup();
+    ft5406_config.filter = &filter;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                      mtb_ctp_ft5406_get_multi_touch_changed(&touch_count, touch_array, &changed));
+
+    touch.event = FT5406_SIM_EVENT_CONTACT;
+    for (i = 0U; i < 64U; i++)
+    {
+        touch.x = (uint16_t)(100 + jitter[i % 8U]);
+        touch.y = (uint16_t)(200 - jitter[(i + 3U) % 8U]);
+        ft5406_sim_set_touches(1U, &touch);
+
+        TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                          mtb_ctp_ft5406_get_multi_touch_changed(&touch_count, touch_array,
+                                                                 &changed));
+        TEST_ASSERT_EQUAL(100, touch_array[0].touch_x);
+        TEST_ASSERT_EQUAL(200, touch_array[0].touch_y);
+        changes += changed ? 1U : 0U;
+
+        TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch_soa(&touch_soa));
+        TEST_ASSERT_EQUAL(1, touch_soa.touch_count);
+        TEST_ASSERT_EQUAL(100, touch_soa.touch_x[0]);
+        TEST_ASSERT_EQUAL(200, touch_soa.touch_y[0]);
+    }
+    /* Only the event change from down to contact is reported */
+    TEST_ASSERT_EQUAL(1U, changes);
+
+    /* Movement beyond the deadband is reported without smoothing */
+    touch.x = 120U;
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch_soa(&touch_soa));
+    TEST_ASSERT_EQUAL(120, touch_soa.touch_x[0]);
+    TEST_ASSERT_EQUAL(3, touch_soa.touch_id[0]);
+
+    ft5406_config.filter = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_filter_weight_limit
+********************************************************************************
+*
+* Filter weights above 256 are limited to 256, so the filtered position does
+* not overshoot.
+*
+*******************************************************************************/
+static void test_filter_weight_limit(void)
+{
+    static const mtb_ctp_ft5406_filter_t filter = { .alpha_min = 1000U, .alpha_max = 60000U,
+                                                    .speed_threshold = 10U };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_touch_t touch = { .x = 100U, .y = 200U, .id = 0U,
+                                 .event = FT5406_SIM_EVENT_DOWN };
+    int touch_count = 0;
+
+    setup();
+    ft5406_config.filter = &filter;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+
+    touch.x     = 4000U;
+    touch.y     = 201U;
+    touch.event = FT5406_SIM_EVENT_CONTACT;
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(4000, touch_array[0].touch_x);
+    TEST_ASSERT_EQUAL(201, touch_array[0].touch_y);
+
+    ft5406_config.filter = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_replay_filter_state
+********************************************************************************
+*
+* Decoding captured frames runs the filter on the state of the replay and
+* leaves the filter state of the touch reads unchanged.
+*
+*******************************************************************************/
+static void test_replay_filter_state(void)
+{
+    static const mtb_ctp_ft5406_filter_t filter = { .alpha_min = 128U };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_filter_states_t replay_filter;
+    ft5406_sim_touch_t touch = { .x = 100U, .y = 200U, .id = 0U,
+                                 .event = FT5406_SIM_EVENT_DOWN };
+    uint8_t touch_data[MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    int touch_count = 0;
+    uint32_t i;
+
+    setup();
+    ft5406_config.filter = &filter;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+
+    /* Replay of a frame sequence at another position */
+    (void)memset(&replay_filter, 0, sizeof(replay_filter));
+    touch.x = 500U;
+    ft5406_sim_set_touches(1U, &touch);
+    for (i = 0U; i < sizeof(touch_data); i++)
+    {
+        touch_data[i] = ft5406_sim_get_reg((uint8_t)(MTB_CTP_REG_READ_TOUCH_DATA + i));
+    }
+    mtb_ctp_ft5406_decode_touch_data_ex(&ft5406_config, touch_data, &touch_count, touch_array,
+                                        &replay_filter);
+    TEST_ASSERT_EQUAL(500, touch_array[0].touch_x);
+
+    touch_data[2] = (uint8_t)((FT5406_SIM_EVENT_CONTACT << 6) | (600U >> 8));
+    touch_data[3] = (uint8_t)(600U & 0xFFU);
+    mtb_ctp_ft5406_decode_touch_data_ex(&ft5406_config, touch_data, &touch_count, touch_array,
+                                        &replay_filter);
+    TEST_ASSERT_EQUAL(550, touch_array[0].touch_x);
+
+    /* The touch reads continue from their own filtered position */
+    touch.x     = 110U;
+    touch.event = FT5406_SIM_EVENT_CONTACT;
+    ft5406_sim_set_touches(1U, &touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(105, touch_array[0].touch_x);
+
+    ft5406_config.filter = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_capture_replay
+********************************************************************************
+*
+* Replaying a capture of touch reads reproduces the failed reads and, through
+* the decode path, the touch points reported by the reads.
+*
+*******************************************************************************/
+#define CAPTURE_READS                      (4U)
+
+static uint8_t capture_stream[MTB_CTP_FT5406_CAPTURE_HEADER_LEN +
+                              (CAPTURE_READS * MTB_CTP_FT5406_CAPTURE_RECORD_MAX_LEN)];
+static uint32_t capture_size;
+
+static struct
+{
+    cy_en_scb_i2c_status_t status;
+    int touch_count;
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+} capture_reads[CAPTURE_READS];
+static uint32_t capture_read_count;
+
+static void capture_sink(const uint8_t* data, uint32_t size, void* user_data)
+{
+    (void)user_data;
+
+    TEST_ASSERT(sizeof(capture_stream) >= (capture_size + size));
+    (void)memcpy(&capture_stream[capture_size], data, size);
+    capture_size += size;
+}
+
+
+static void capture_read_cb(cy_en_scb_i2c_status_t status, int touch_count,
+                            const mtb_ctp_multi_touch_point_t* touch_array, void* user_data)
+{
+    (void)user_data;
+
+    capture_reads[capture_read_count].status      = status;
+    capture_reads[capture_read_count].touch_count = touch_count;
+    (void)memcpy(capture_reads[capture_read_count].touch_array, touch_array,
+                 sizeof(capture_reads[capture_read_count].touch_array));
+    capture_read_count++;
+}
+
+
+static void test_capture_replay(void)
+{
+    static const ft5406_sim_touch_t one_touch[] =
+    {
+        { .x = 120U, .y = 210U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT }
+    };
+    static mtb_ctp_ft5406_capture_t capture;
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_capture_record_t record;
+    mtb_ctp_ft5406_replay_t replay;
+    uint32_t timestamp = 0U;
+    int touch_count = 0;
+    uint32_t i;
+    int j;
+
+    setup();
+    capture_size       = 0U;
+    capture_read_count = 0U;
+    mtb_ctp_ft5406_capture_init(&capture, capture_sink, NULL);
+    ft5406_config.capture = &capture;
+
+    /* Two touch points, a NAKed read, one touch point, and the lift-off */
+    for (i = 0U; i < CAPTURE_READS; i++)
+    {
+        if (0U == i)
+        {
+            ft5406_sim_set_touches(2U, two_touches);
+        }
+        else if (1U == i)
+        {
+            ft5406_sim_inject_nak(1U);
+        }
+        else if (2U == i)
+        {
+            ft5406_sim_set_touches(1U, one_touch);
+        }
+        else
+        {
+            ft5406_sim_set_touches(0U, NULL);
+        }
+
+        TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_read_async(capture_read_cb, NULL));
+        ft5406_sim_run(5000U);
+    }
+    ft5406_config.capture = NULL;
+
+    TEST_ASSERT_EQUAL(CAPTURE_READS, capture_read_count);
+    TEST_ASSERT(CY_SCB_I2C_SUCCESS != capture_reads[1].status);
+    TEST_ASSERT_EQUAL(CAPTURE_READS, capture.frame_count);
+
+    TEST_ASSERT(mtb_ctp_ft5406_replay_init(&replay, capture_stream, capture_size));
+    for (i = 0U; i < CAPTURE_READS; i++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT_EQUAL(capture_reads[i].status, record.status);
+        TEST_ASSERT(timestamp < record.timestamp);
+        timestamp = record.timestamp;
+
+        if (CY_SCB_I2C_SUCCESS == record.status)
+        {
+            mtb_ctp_ft5406_decode_touch_data_ex(&ft5406_config, record.touch_data,
+                                                &touch_count, touch_array, NULL);
+            TEST_ASSERT_EQUAL(capture_reads[i].touch_count, touch_count);
+            for (j = 0; j < touch_count; j++)
+            {
+                TEST_ASSERT_EQUAL(capture_reads[i].touch_array[j].touch_x, touch_array[j].touch_x);
+                TEST_ASSERT_EQUAL(capture_reads[i].touch_array[j].touch_y, touch_array[j].touch_y);
+                TEST_ASSERT_EQUAL(capture_reads[i].touch_array[j].touch_id, touch_array[j].touch_id);
+                TEST_ASSERT_EQUAL(capture_reads[i].touch_array[j].touch_event,
+                                  touch_array[j].touch_event);
+            }
+        }
+    }
+    TEST_ASSERT(!mtb_ctp_ft5406_replay_next(&replay, &record));
+    TEST_ASSERT_EQUAL(capture_size, replay.offset);
+}
+
+
+/*******************************************************************************
+* Function Name: test_replay_corrupt_stream
+********************************************************************************
+*
+* The replay stops at a truncated record and at a record whose tag does not
+* match a captured touch read, without reading past the stream or skipping it.
+*
+*******************************************************************************/
+static void test_replay_corrupt_stream(void)
+{
+    static const uint8_t bad_tags[] =
+    {
+        0x00U,  /* No touch data header */
+        0x07U,  /* Header and a partial touch point */
+        0x09U,  /* Header, a touch point, and a partial one */
+        0x22U,  /* Header and six touch points */
+        0x48U,  /* Unused tag bit */
+        0x81U   /* Error flag with a length */
+    };
+    static mtb_ctp_ft5406_capture_t capture;
+    mtb_ctp_ft5406_capture_record_t record;
+    mtb_ctp_ft5406_replay_t replay;
+    uint8_t touch_data[MTB_CTP_FT5406_TOUCH_DATA_LEN];
+    uint32_t first_size;
+    uint32_t size;
+    uint32_t i;
+
+    (void)memset(touch_data, 0xFF, sizeof(touch_data));
+    touch_data[1] = 2U;
+
+    capture_size = 0U;
+    mtb_ctp_ft5406_capture_init(&capture, capture_sink, NULL);
+    mtb_ctp_ft5406_capture_frame(&capture, 100U, CY_SCB_I2C_SUCCESS, touch_data);
+    first_size = capture_size;
+    mtb_ctp_ft5406_capture_frame(&capture, 200U, CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK, NULL);
+
+    /* Header */
+    TEST_ASSERT(!mtb_ctp_ft5406_replay_init(&replay, capture_stream,
+                                            MTB_CTP_FT5406_CAPTURE_HEADER_LEN - 1U));
+    capture_stream[MTB_CTP_FT5406_CAPTURE_HEADER_LEN - 1U]++;
+    TEST_ASSERT(!mtb_ctp_ft5406_replay_init(&replay, capture_stream, capture_size));
+    capture_stream[MTB_CTP_FT5406_CAPTURE_HEADER_LEN - 1U]--;
+
+    /* Every truncation of the second record keeps the first one only */
+    for (size = first_size; size < capture_size; size++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_replay_init(&replay, capture_stream, size));
+        TEST_ASSERT(mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT_EQUAL(100U, record.timestamp);
+        TEST_ASSERT(!mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT_EQUAL(first_size, replay.offset);
+    }
+
+    /* Every truncation of the first record keeps none */
+    for (size = MTB_CTP_FT5406_CAPTURE_HEADER_LEN; size < first_size; size++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_replay_init(&replay, capture_stream, size));
+        TEST_ASSERT(!mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT_EQUAL(MTB_CTP_FT5406_CAPTURE_HEADER_LEN, replay.offset);
+    }
+
+    /* The whole stream reads both records */
+    TEST_ASSERT(mtb_ctp_ft5406_replay_init(&replay, capture_stream, capture_size));
+    TEST_ASSERT(mtb_ctp_ft5406_replay_next(&replay, &record));
+    TEST_ASSERT(mtb_ctp_ft5406_replay_next(&replay, &record));
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK, record.status);
+    TEST_ASSERT_EQUAL(200U, record.timestamp);
+
+    /* Corrupt tags of the second record, with the stream long enough for any length */
+    for (i = 0U; i < sizeof(bad_tags); i++)
+    {
+        capture_stream[first_size] = bad_tags[i];
+        TEST_ASSERT(mtb_ctp_ft5406_replay_init(&replay, capture_stream, sizeof(capture_stream)));
+        TEST_ASSERT(mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT(!mtb_ctp_ft5406_replay_next(&replay, &record));
+        TEST_ASSERT_EQUAL(first_size, replay.offset);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_chained_event_callback
+********************************************************************************
+*
+* The I2C event callback registered before the initialization keeps receiving
+* the events of its own transfers and none of the touch read transfers.
+*
+*******************************************************************************/
+static uint32_t other_events;
+static uint32_t other_event_count;
+
+static void other_event_callback(uint32_t event)
+{
+    other_events |= event;
+    other_event_count++;
+}
+
+
+static void test_chained_event_callback(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    cy_stc_scb_i2c_master_xfer_config_t xfer_config;
+    uint8_t reg_addr = MTB_CTP_FT5406_DEVICE_MODE;
+    int touch_count = 0;
+
+    ft5406_sim_reset();
+    (void)memset(&i2c_context, 0, sizeof(i2c_context));
+    Cy_SCB_I2C_RegisterEventCallback(&ft5406_sim_scb, other_event_callback, &i2c_context);
+    other_events      = 0U;
+    other_event_count = 0U;
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_touches(2U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(0U, other_event_count);
+
+    /* Transfer of the other driver */
+    xfer_config.slaveAddress = MTB_CTP_FT5406_I2C_ADDRESS;
+    xfer_config.buffer       = &reg_addr;
+    xfer_config.bufferSize   = sizeof(reg_addr);
+    xfer_config.xferPending  = false;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                      Cy_SCB_I2C_MasterWrite(&ft5406_sim_scb, &xfer_config, &i2c_context));
+    ft5406_sim_run(1000U);
+    TEST_ASSERT_EQUAL(1U, other_event_count);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_WR_CMPLT_EVENT, other_events);
+}
+
+
+/*******************************************************************************
+* Function Name: test_deinit_releases_bus
+********************************************************************************
+*
+* A failed initialization and a deinitialization free the I2C bus for another
+* configuration structure and restore the I2C event callback registered before.
+*
+*******************************************************************************/
+static void test_deinit_releases_bus(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_config_t other_config;
+    int touch_count = 0;
+
+    ft5406_sim_reset();
+    (void)memset(&i2c_context, 0, sizeof(i2c_context));
+    Cy_SCB_I2C_RegisterEventCallback(&ft5406_sim_scb, other_event_callback, &i2c_context);
+    other_event_count = 0U;
+
+    /* The DEVICE_MODE write is NAKed */
+    ft5406_sim_inject_nak(100U);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_inject_nak(0U);
+    TEST_ASSERT(other_event_callback == i2c_context.cbEvents);
+
+    (void)memset(&other_config, 0, sizeof(other_config));
+    other_config.i2c_base    = &ft5406_sim_scb;
+    other_config.i2c_context = &i2c_context;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init_ex(&other_config));
+    TEST_ASSERT(other_event_callback != i2c_context.cbEvents);
+    ft5406_sim_set_touches(2U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                      mtb_ctp_ft5406_get_multi_touch_ex(&other_config, &touch_count,
+                                                        touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(0U, other_event_count);
+
+    mtb_ctp_ft5406_deinit_ex(&other_config);
+    TEST_ASSERT(other_event_callback == i2c_context.cbEvents);
+
+    /* The default instance takes the bus again */
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    mtb_ctp_ft5406_deinit();
+    TEST_ASSERT(other_event_callback == i2c_context.cbEvents);
+}
+
+
+/*******************************************************************************
+* Function Name: test_two_instances_event_mode
+********************************************************************************
+*
+* Two instances on separate I2C buses read their own frames on their own INT
+* assertions, and a second instance on a bus in use is rejected.
+*
+*******************************************************************************/
+static cy_stc_scb_i2c_context_t i2c_context_2;
+static mtb_ctp_ft5406_config_t ft5406_config_2;
+
+static void int_handler_2(void)
+{
+    mtb_ctp_ft5406_int_handler_ex(&ft5406_config_2);
+}
+
+
+static void test_two_instances_event_mode(void)
+{
+    static const ft5406_sim_touch_t one_touch[] =
+    {
+        { .x = 700U, .y = 50U, .id = 3U, .event = FT5406_SIM_EVENT_CONTACT }
+    };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_config_t duplicate_config;
+    cy_stc_scb_i2c_context_t duplicate_context;
+    ft5406_sim_stats_t before[FT5406_SIM_BUS_COUNT];
+    ft5406_sim_stats_t after[FT5406_SIM_BUS_COUNT];
+    int touch_count = 0;
+    uint32_t bus;
+
+    setup();
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    ft5406_config.int_pin  = 0U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+    ft5406_sim_set_touches(2U, two_touches);
+
+    (void)memset(&i2c_context_2, 0, sizeof(i2c_context_2));
+    (void)memset(&ft5406_config_2, 0, sizeof(ft5406_config_2));
+    ft5406_config_2.i2c_base         = &ft5406_sim_scb_2;
+    ft5406_config_2.i2c_context      = &i2c_context_2;
+    ft5406_config_2.int_port         = &ft5406_sim_int_port_2;
+    ft5406_config_2.get_timestamp_us = ft5406_sim_now_us;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init_ex(&ft5406_config_2));
+    ft5406_sim_select_bus(1U);
+    ft5406_sim_set_int_isr(int_handler_2);
+    ft5406_sim_set_touches(1U, one_touch);
+    ft5406_sim_select_bus(0U);
+
+    /* Another instance on the bus of the first one */
+    (void)memset(&duplicate_context, 0, sizeof(duplicate_context));
+    (void)memset(&duplicate_config, 0, sizeof(duplicate_config));
+    duplicate_config.i2c_base    = &ft5406_sim_scb;
+    duplicate_config.i2c_context = &duplicate_context;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_BAD_PARAM, mtb_ctp_ft5406_init_ex(&duplicate_config));
+
+    for (bus = 0U; bus < FT5406_SIM_BUS_COUNT; bus++)
+    {
+        ft5406_sim_select_bus(bus);
+        ft5406_sim_assert_int();
+    }
+    TEST_ASSERT(mtb_ctp_ft5406_is_busy());
+    TEST_ASSERT(mtb_ctp_ft5406_is_busy_ex(&ft5406_config_2));
+    ft5406_sim_run(5000U);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy_ex(&ft5406_config_2));
+
+    /* The touch outputs serve the frame of each instance without bus access */
+    for (bus = 0U; bus < FT5406_SIM_BUS_COUNT; bus++)
+    {
+        ft5406_sim_select_bus(bus);
+        ft5406_sim_get_stats(&before[bus]);
+    }
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(300, touch_array[1].touch_x);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS,
+                      mtb_ctp_ft5406_get_multi_touch_ex(&ft5406_config_2, &touch_count, touch_array));
+    TEST_ASSERT_EQUAL(1, touch_count);
+    TEST_ASSERT_EQUAL(3, touch_array[0].touch_id);
+    TEST_ASSERT_EQUAL(700, touch_array[0].touch_x);
+
+    for (bus = 0U; bus < FT5406_SIM_BUS_COUNT; bus++)
+    {
+        ft5406_sim_select_bus(bus);
+        ft5406_sim_get_stats(&after[bus]);
+        TEST_ASSERT_EQUAL(before[bus].transactions, after[bus].transactions);
+    }
+    ft5406_sim_select_bus(0U);
+
+    ft5406_config.int_port = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_max_instances
+********************************************************************************
+*
+* With all MTB_CTP_FT5406_MAX_INSTANCES slots in use, the initialization of an
+* instance on another bus fails without bus access, and the registered
+* instances can still be initialized again.
+*
+*******************************************************************************/
+static void test_max_instances(void)
+{
+    static CySCB_Type other_scb;
+    mtb_ctp_ft5406_config_t other_config;
+    cy_stc_scb_i2c_context_t other_context;
+
+    /* The host tests build with the default of two instances, registered on
+     * bus 0 and 1 by test_two_instances_event_mode() */
+    TEST_ASSERT_EQUAL(2U, MTB_CTP_FT5406_MAX_INSTANCES);
+
+    setup();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init_ex(&ft5406_config_2));
+
+    (void)memset(&other_context, 0, sizeof(other_context));
+    (void)memset(&other_config, 0, sizeof(other_config));
+    other_config.i2c_base    = &other_scb;
+    other_config.i2c_context = &other_context;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_BAD_PARAM, mtb_ctp_ft5406_init_ex(&other_config));
+    TEST_ASSERT(NULL == other_context.cbEvents);
+
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+}
+
+
+/*******************************************************************************
+* Function Name: test_tracker_id_reuse
+********************************************************************************
+*
+* A touch ID lifted by an up report or by disappearing from the report is
+* reused by a new contact, each down event is followed by exactly one up
+* event, and a touch ID reported down again without being lifted is lifted
+* and put down in the same frame.
+*
+*******************************************************************************/
+static void tracker_point(mtb_ctp_multi_touch_point_t* point, mtb_ctp_touch_event_t touch_event,
+                          uint8_t touch_id, uint16_t touch_x, uint16_t touch_y)
+{
+    point->touch_event = touch_event;
+    point->touch_id    = touch_id;
+    point->touch_x     = touch_x;
+    point->touch_y     = touch_y;
+}
+
+
+static void test_tracker_id_reuse(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_track_event_t events[MTB_CTP_FT5406_TRACKER_MAX_EVENTS];
+    mtb_ctp_ft5406_tracker_t tracker;
+    uint32_t event_count;
+
+    mtb_ctp_ft5406_tracker_init(&tracker);
+
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_DOWN, 0U, 100U, 100U);
+    tracker_point(&touch_array[1], MTB_CTP_TOUCH_DOWN, 1U, 200U, 200U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 1000U, 2, touch_array, events);
+    TEST_ASSERT_EQUAL(2U, event_count);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, events[0].touch_event);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, events[1].touch_event);
+
+    /* ID 0 is reported up, ID 1 disappears from the report */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_UP, 0U, 100U, 100U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 2000U, 1, touch_array, events);
+    TEST_ASSERT_EQUAL(2U, event_count);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_UP, events[0].touch_event);
+    TEST_ASSERT_EQUAL(0U, events[0].touch_id);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_UP, events[1].touch_event);
+    TEST_ASSERT_EQUAL(1U, events[1].touch_id);
+
+    /* A lifted contact is not lifted again */
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 3000U, 0, touch_array, events);
+    TEST_ASSERT_EQUAL(0U, event_count);
+
+    /* Both IDs are reused by new contacts, starting without velocity */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 1U, 400U, 50U);
+    tracker_point(&touch_array[1], MTB_CTP_TOUCH_DOWN, 0U, 300U, 60U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 4000U, 2, touch_array, events);
+    TEST_ASSERT_EQUAL(2U, event_count);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, events[0].touch_event);
+    TEST_ASSERT_EQUAL(1U, events[0].touch_id);
+    TEST_ASSERT_EQUAL(400U, events[0].touch_x);
+    TEST_ASSERT_EQUAL(0, events[0].velocity_x);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, events[1].touch_event);
+    TEST_ASSERT_EQUAL(0U, events[1].touch_id);
+
+    /* ID 0 is lifted and touched again between two reports, ID 1 moves */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 1U, 410U, 50U);
+    tracker_point(&touch_array[1], MTB_CTP_TOUCH_DOWN, 0U, 600U, 70U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 5000U, 2, touch_array, events);
+    TEST_ASSERT_EQUAL(3U, event_count);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_UP, events[0].touch_event);
+    TEST_ASSERT_EQUAL(0U, events[0].touch_id);
+    TEST_ASSERT_EQUAL(300U, events[0].touch_x);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_CONTACT, events[1].touch_event);
+    TEST_ASSERT_EQUAL(1U, events[1].touch_id);
+    TEST_ASSERT_EQUAL(10, events[1].delta_x);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, events[2].touch_event);
+    TEST_ASSERT_EQUAL(0U, events[2].touch_id);
+    TEST_ASSERT_EQUAL(600U, events[2].touch_x);
+    TEST_ASSERT_EQUAL(0, events[2].delta_x);
+}
+
+
+/*******************************************************************************
+* Function Name: test_tracker_velocity
+********************************************************************************
+*
+* The velocity is the movement per millisecond in Q24.8 with the sign of the
+* movement, and a jump across the transformed coordinate range saturates the
+* movement and the velocity instead of overflowing.
+*
+*******************************************************************************/
+static void test_tracker_velocity(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_track_event_t events[MTB_CTP_FT5406_TRACKER_MAX_EVENTS];
+    mtb_ctp_ft5406_tracker_t tracker;
+    uint32_t event_count;
+
+    mtb_ctp_ft5406_tracker_init(&tracker);
+
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_DOWN, 2U, 1000U, 1000U);
+    (void)mtb_ctp_ft5406_tracker_update(&tracker, 10000U, 1, touch_array, events);
+
+    /* +30 and -15 counts in 2 ms */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 2U, 1030U, 985U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 12000U, 1, touch_array, events);
+    TEST_ASSERT_EQUAL(1U, event_count);
+    TEST_ASSERT_EQUAL(30, events[0].delta_x);
+    TEST_ASSERT_EQUAL(-15, events[0].delta_y);
+    TEST_ASSERT_EQUAL(15 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT, events[0].velocity_x);
+    TEST_ASSERT_EQUAL(-(15 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT) / 2, events[0].velocity_y);
+
+    /* No time between the frames: no velocity */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 2U, 1040U, 985U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 12000U, 1, touch_array, events);
+    TEST_ASSERT_EQUAL(10, events[0].delta_x);
+    TEST_ASSERT_EQUAL(0, events[0].velocity_x);
+
+    /* Full range jumps of transformed coordinates within 1 us */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 2U, 0U, UINT16_MAX);
+    (void)mtb_ctp_ft5406_tracker_update(&tracker, 12001U, 1, touch_array, events);
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 2U, UINT16_MAX, 0U);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 12002U, 1, touch_array, events);
+    TEST_ASSERT_EQUAL(1U, event_count);
+    TEST_ASSERT_EQUAL(INT16_MAX, events[0].delta_x);
+    TEST_ASSERT_EQUAL(-INT16_MAX, events[0].delta_y);
+    TEST_ASSERT_EQUAL(INT32_MAX, events[0].velocity_x);
+    TEST_ASSERT_EQUAL(-INT32_MAX, events[0].velocity_y);
+
+    /* Full range move over 1 s keeps its exact velocity */
+    tracker_point(&touch_array[0], MTB_CTP_TOUCH_CONTACT, 2U, 0U, UINT16_MAX);
+    event_count = mtb_ctp_ft5406_tracker_update(&tracker, 1012002U, 1, touch_array, events);
+    TEST_ASSERT_EQUAL(-(int32_t)(((int64_t)UINT16_MAX << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT) / 1000),
+                      events[0].velocity_x);
+    TEST_ASSERT_EQUAL((int32_t)(((int64_t)UINT16_MAX << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT) / 1000),
+                      events[0].velocity_y);
+}
+
+
+/*******************************************************************************
+* Function Name: test_gesture_tap
+********************************************************************************
+*
+* A short touch is a tap, a second tap close in time and place queues both a
+* tap and a double tap, a touch held without movement is a long press, and a
+* touch held too long for a tap but too short for a long press is no gesture.
+*
+*******************************************************************************/
+static void gesture_contact(mtb_ctp_ft5406_gesture_t* gesture, uint32_t timestamp,
+                            mtb_ctp_touch_event_t touch_event, uint8_t touch_id,
+                            uint16_t touch_x, uint16_t touch_y)
+{
+    mtb_ctp_ft5406_track_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.touch_event = touch_event;
+    event.touch_id    = touch_id;
+    event.touch_x     = touch_x;
+    event.touch_y     = touch_y;
+
+    mtb_ctp_ft5406_gesture_update(gesture, timestamp, &event, 1U);
+}
+
+
+static void test_gesture_tap(void)
+{
+    mtb_ctp_ft5406_gesture_t gesture;
+    mtb_ctp_ft5406_gesture_event_t event;
+
+    mtb_ctp_ft5406_gesture_init(&gesture, NULL);
+
+    gesture_contact(&gesture, 0U, MTB_CTP_TOUCH_DOWN, 0U, 100U, 100U);
+    gesture_contact(&gesture, 50000U, MTB_CTP_TOUCH_CONTACT, 0U, 104U, 98U);
+    gesture_contact(&gesture, 100000U, MTB_CTP_TOUCH_UP, 0U, 104U, 98U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_TAP, event.type);
+    TEST_ASSERT_EQUAL(100000U, event.timestamp);
+    TEST_ASSERT_EQUAL(104U, event.x);
+    TEST_ASSERT_EQUAL(98U, event.y);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* The second tap is reported as tap and as double tap */
+    gesture_contact(&gesture, 300000U, MTB_CTP_TOUCH_DOWN, 1U, 110U, 105U);
+    gesture_contact(&gesture, 380000U, MTB_CTP_TOUCH_UP, 1U, 110U, 105U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_TAP, event.type);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_DOUBLE_TAP, event.type);
+    TEST_ASSERT_EQUAL(380000U, event.timestamp);
+    TEST_ASSERT_EQUAL(110U, event.x);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* A third tap starts a new double tap */
+    gesture_contact(&gesture, 500000U, MTB_CTP_TOUCH_DOWN, 0U, 110U, 105U);
+    gesture_contact(&gesture, 550000U, MTB_CTP_TOUCH_UP, 0U, 110U, 105U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_TAP, event.type);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Too far from the previous tap for a double tap */
+    gesture_contact(&gesture, 700000U, MTB_CTP_TOUCH_DOWN, 0U, 200U, 105U);
+    gesture_contact(&gesture, 750000U, MTB_CTP_TOUCH_UP, 0U, 200U, 105U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_TAP, event.type);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Held for 400 ms: neither tap nor long press */
+    gesture_contact(&gesture, 2000000U, MTB_CTP_TOUCH_DOWN, 0U, 100U, 100U);
+    mtb_ctp_ft5406_gesture_update(&gesture, 2200000U, NULL, 0U);
+    gesture_contact(&gesture, 2400000U, MTB_CTP_TOUCH_UP, 0U, 100U, 100U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Long press, recognized by the frame after 600 ms without events */
+    gesture_contact(&gesture, 3000000U, MTB_CTP_TOUCH_DOWN, 0U, 300U, 200U);
+    mtb_ctp_ft5406_gesture_update(&gesture, 3599999U, NULL, 0U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    mtb_ctp_ft5406_gesture_update(&gesture, 3600000U, NULL, 0U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_LONG_PRESS, event.type);
+    TEST_ASSERT_EQUAL(3600000U, event.timestamp);
+    TEST_ASSERT_EQUAL(300U, event.x);
+    TEST_ASSERT_EQUAL(200U, event.y);
+
+    /* Reported once, and the lift is no tap */
+    mtb_ctp_ft5406_gesture_update(&gesture, 3700000U, NULL, 0U);
+    gesture_contact(&gesture, 3800000U, MTB_CTP_TOUCH_UP, 0U, 300U, 200U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(0U, mtb_ctp_ft5406_gesture_get_overflows(&gesture));
+}
+
+
+/*******************************************************************************
+* Function Name: test_gesture_swipe
+********************************************************************************
+*
+* A fast single finger movement is a swipe along its dominant axis with the
+* speed of the contact, and a slow movement is no gesture.
+*
+*******************************************************************************/
+static void test_gesture_swipe(void)
+{
+    mtb_ctp_ft5406_track_event_t up_event;
+    mtb_ctp_ft5406_gesture_t gesture;
+    mtb_ctp_ft5406_gesture_event_t event;
+
+    mtb_ctp_ft5406_gesture_init(&gesture, NULL);
+    (void)memset(&up_event, 0, sizeof(up_event));
+    up_event.touch_event = MTB_CTP_TOUCH_UP;
+
+    gesture_contact(&gesture, 0U, MTB_CTP_TOUCH_DOWN, 0U, 100U, 300U);
+    gesture_contact(&gesture, 50000U, MTB_CTP_TOUCH_CONTACT, 0U, 200U, 300U);
+    up_event.touch_x    = 300U;
+    up_event.touch_y    = 310U;
+    up_event.velocity_x = 4 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT;
+    mtb_ctp_ft5406_gesture_update(&gesture, 100000U, &up_event, 1U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_SWIPE_RIGHT, event.type);
+    TEST_ASSERT_EQUAL(4 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT, event.value);
+    TEST_ASSERT_EQUAL(300U, event.x);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Upwards, the value is the speed */
+    gesture_contact(&gesture, 1000000U, MTB_CTP_TOUCH_DOWN, 0U, 300U, 300U);
+    up_event.touch_x    = 310U;
+    up_event.touch_y    = 100U;
+    up_event.velocity_x = 0;
+    up_event.velocity_y = -(2 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT);
+    mtb_ctp_ft5406_gesture_update(&gesture, 1100000U, &up_event, 1U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_SWIPE_UP, event.type);
+    TEST_ASSERT_EQUAL(2 << MTB_CTP_FT5406_TRACKER_VELOCITY_SHIFT, event.value);
+
+    /* Left and down */
+    gesture_contact(&gesture, 2000000U, MTB_CTP_TOUCH_DOWN, 0U, 300U, 300U);
+    gesture_contact(&gesture, 2100000U, MTB_CTP_TOUCH_UP, 0U, 200U, 290U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_SWIPE_LEFT, event.type);
+    gesture_contact(&gesture, 3000000U, MTB_CTP_TOUCH_DOWN, 0U, 300U, 100U);
+    gesture_contact(&gesture, 3100000U, MTB_CTP_TOUCH_UP, 0U, 300U, 200U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_SWIPE_DOWN, event.type);
+
+    /* A drag over 600 ms is no swipe, nor a tap */
+    gesture_contact(&gesture, 4000000U, MTB_CTP_TOUCH_DOWN, 0U, 100U, 300U);
+    gesture_contact(&gesture, 4300000U, MTB_CTP_TOUCH_CONTACT, 0U, 200U, 300U);
+    gesture_contact(&gesture, 4600000U, MTB_CTP_TOUCH_UP, 0U, 300U, 300U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+}
+
+
+/*******************************************************************************
+* Function Name: test_gesture_pinch_rotate
+********************************************************************************
+*
+* Two fingers report a pinch when their distance changes by the pinch step,
+* with the distance relative to the gesture start, and a rotation in the
+* direction of the turn when their angle changes by the rotation step. The
+* fingers of a two finger gesture report no single finger gesture.
+*
+*******************************************************************************/
+static void test_gesture_pinch_rotate(void)
+{
+    mtb_ctp_ft5406_track_event_t events[2];
+    mtb_ctp_ft5406_gesture_t gesture;
+    mtb_ctp_ft5406_gesture_event_t event;
+
+    mtb_ctp_ft5406_gesture_init(&gesture, NULL);
+    (void)memset(events, 0, sizeof(events));
+
+    /* Both fingers down in one frame, 200 counts apart */
+    events[0].touch_event = MTB_CTP_TOUCH_DOWN;
+    events[0].touch_id    = 0U;
+    events[0].touch_x     = 100U;
+    events[0].touch_y     = 200U;
+    events[1].touch_event = MTB_CTP_TOUCH_DOWN;
+    events[1].touch_id    = 1U;
+    events[1].touch_x     = 300U;
+    events[1].touch_y     = 200U;
+    mtb_ctp_ft5406_gesture_update(&gesture, 0U, events, 2U);
+
+    /* A 5 % change is below the pinch step */
+    gesture_contact(&gesture, 10000U, MTB_CTP_TOUCH_CONTACT, 1U, 310U, 200U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* 240 counts apart: 1.2 in Q24.8 */
+    gesture_contact(&gesture, 20000U, MTB_CTP_TOUCH_CONTACT, 1U, 340U, 200U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_PINCH, event.type);
+    TEST_ASSERT_EQUAL((240 << 8) / 200, event.value);
+    TEST_ASSERT_EQUAL(220U, event.x);
+    TEST_ASSERT_EQUAL(200U, event.y);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Turned by about 27 degrees clockwise, Y grows downwards */
+    gesture_contact(&gesture, 30000U, MTB_CTP_TOUCH_CONTACT, 1U, 300U, 300U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_ROTATE, event.type);
+    TEST_ASSERT_EQUAL(1, event.value);
+    TEST_ASSERT_EQUAL(200U, event.x);
+    TEST_ASSERT_EQUAL(250U, event.y);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Turned back past the start counterclockwise */
+    gesture_contact(&gesture, 40000U, MTB_CTP_TOUCH_CONTACT, 1U, 300U, 100U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_ROTATE, event.type);
+    TEST_ASSERT_EQUAL(-1, event.value);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Lifting the fingers quickly is no tap */
+    events[0].touch_event = MTB_CTP_TOUCH_UP;
+    events[1].touch_event = MTB_CTP_TOUCH_UP;
+    events[1].touch_y     = 100U;
+    mtb_ctp_ft5406_gesture_update(&gesture, 50000U, events, 2U);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+}
+
+
+/*******************************************************************************
+* Function Name: test_gesture_pinch_full_range
+********************************************************************************
+*
+* The finger distance is measured without overflow across the full coordinate
+* range.
+*
+*******************************************************************************/
+static void test_gesture_pinch_full_range(void)
+{
+    mtb_ctp_ft5406_track_event_t events[2];
+    mtb_ctp_ft5406_gesture_t gesture;
+    mtb_ctp_ft5406_gesture_event_t event;
+
+    mtb_ctp_ft5406_gesture_init(&gesture, NULL);
+    (void)memset(events, 0, sizeof(events));
+
+    /* 56568 counts apart, the squared distance exceeds INT32_MAX */
+    events[0].touch_event = MTB_CTP_TOUCH_DOWN;
+    events[0].touch_id    = 0U;
+    events[1].touch_event = MTB_CTP_TOUCH_DOWN;
+    events[1].touch_id    = 1U;
+    events[1].touch_x     = 40000U;
+    events[1].touch_y     = 40000U;
+    mtb_ctp_ft5406_gesture_update(&gesture, 0U, events, 2U);
+
+    /* 84852 counts apart: 1.5 in Q24.8, in the same direction */
+    gesture_contact(&gesture, 10000U, MTB_CTP_TOUCH_CONTACT, 1U, 60000U, 60000U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_PINCH, event.type);
+    TEST_ASSERT_EQUAL((84852 << 8) / 56568, event.value);
+    TEST_ASSERT_EQUAL(30000U, event.x);
+    TEST_ASSERT_EQUAL(30000U, event.y);
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+}
+
+
+/*******************************************************************************
+* Function Name: test_gesture_queue_overflow
+********************************************************************************
+*
+* Gestures recognized while the queue holds MTB_CTP_FT5406_GESTURE_QUEUE_SIZE
+* events are dropped and counted, and the queued events are kept in order.
+*
+*******************************************************************************/
+static void test_gesture_queue_overflow(void)
+{
+    mtb_ctp_ft5406_gesture_t gesture;
+    mtb_ctp_ft5406_gesture_event_t event;
+    uint32_t timestamp;
+    uint32_t i;
+
+    mtb_ctp_ft5406_gesture_init(&gesture, NULL);
+
+    /* Taps too far apart in time for double taps */
+    for (i = 0U; i < (MTB_CTP_FT5406_GESTURE_QUEUE_SIZE + 2U); i++)
+    {
+        timestamp = i * 1000000U;
+        gesture_contact(&gesture, timestamp, MTB_CTP_TOUCH_DOWN, 0U, 100U, 100U);
+        gesture_contact(&gesture, timestamp + 50000U, MTB_CTP_TOUCH_UP, 0U, 100U, 100U);
+    }
+    TEST_ASSERT_EQUAL(2U, mtb_ctp_ft5406_gesture_get_overflows(&gesture));
+
+    for (i = 0U; i < MTB_CTP_FT5406_GESTURE_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+        TEST_ASSERT_EQUAL(MTB_CTP_FT5406_GESTURE_TAP, event.type);
+        TEST_ASSERT_EQUAL((i * 1000000U) + 50000U, event.timestamp);
+    }
+    TEST_ASSERT(!mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+
+    /* Queued again once popped */
+    gesture_contact(&gesture, 20000000U, MTB_CTP_TOUCH_DOWN, 0U, 100U, 100U);
+    gesture_contact(&gesture, 20050000U, MTB_CTP_TOUCH_UP, 0U, 100U, 100U);
+    TEST_ASSERT(mtb_ctp_ft5406_gesture_pop(&gesture, &event));
+    TEST_ASSERT_EQUAL(20050000U, event.timestamp);
+    TEST_ASSERT_EQUAL(2U, mtb_ctp_ft5406_gesture_get_overflows(&gesture));
+}
+
+
+/*******************************************************************************
+* Function Name: test_dma_touch_read
+********************************************************************************
+*
+* With a DataWire channel configured, all but the last two bytes of blocking,
+* event mode and adaptive re-reads are received by DMA, and the PDL ends the
+* read once the channel interrupt hands the RX FIFO back. Without the channel
+* interrupt the read never ends. Without a channel, the SCB interrupt receives
+* the data.
+*
+*******************************************************************************/
+static cy_stc_dma_descriptor_t dma_descriptor;
+
+static const mtb_ctp_ft5406_dma_t dma_channel =
+{
+    .base       = &ft5406_sim_dw,
+    .channel    = 2U,
+    .descriptor = &dma_descriptor
+};
+
+static void setup_dma(GPIO_PRT_Type* int_port)
+{
+    setup();
+    ft5406_config.dma       = &dma_channel;
+    ft5406_config.int_port  = int_port;
+    ft5406_config.int_pin   = 0U;
+    ft5406_config.read_mode = MTB_CTP_FT5406_READ_FULL;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+    ft5406_sim_set_dma_isr(mtb_ctp_ft5406_dma_handler);
+}
+
+
+static void teardown_dma(void)
+{
+    ft5406_config.dma      = NULL;
+    ft5406_config.int_port = NULL;
+}
+
+
+static void test_dma_touch_read(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_stats_t stats;
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    int touch_count = 0;
+
+    /* Interrupt path */
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(0U, after.dma_bytes);
+
+    /* Blocking read, NAKed after the last byte */
+    setup_dma(NULL);
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(300, touch_array[1].touch_x);
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_TOUCH_DATA_LEN - 2U, after.dma_bytes - before.dma_bytes);
+    TEST_ASSERT_EQUAL(2U, after.transactions - before.transactions);
+    TEST_ASSERT_EQUAL(2U + 1U + MTB_CTP_FT5406_TOUCH_DATA_LEN, after.bytes - before.bytes);
+
+    /* Event mode read, served without bus access */
+    setup_dma(&ft5406_sim_int_port);
+    ft5406_sim_set_touches(3U, three_touches);
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(3, touch_count);
+    TEST_ASSERT_EQUAL(50, touch_array[2].touch_x);
+    TEST_ASSERT_EQUAL(before.transactions, after.transactions);
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_TOUCH_DATA_LEN - 2U, after.dma_bytes);
+
+    /* Adaptive read of one touch point, re-read whole for three */
+    ft5406_config.read_mode = MTB_CTP_FT5406_READ_ADAPTIVE;
+    ft5406_sim_set_touches(1U, three_touches);
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    ft5406_sim_set_touches(3U, three_touches_moved);
+    ft5406_sim_get_stats(&before);
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(3, touch_count);
+    TEST_ASSERT_EQUAL(51, touch_array[2].touch_x);
+    TEST_ASSERT_EQUAL(4U, after.transactions - before.transactions);
+    /* Gesture ID and TD_STATUS with one and three touch points, less the
+     * last two bytes of each read */
+    TEST_ASSERT_EQUAL(4U * sizeof(mtb_ctp_ft5406_touch_point_t),
+                      after.dma_bytes - before.dma_bytes);
+    teardown_dma();
+
+    /* The PDL does not end a read while its RX interrupt is masked */
+    setup_dma(NULL);
+    ft5406_sim_set_dma_isr(NULL);
+    ft5406_sim_set_touches(2U, two_touches);
+    mtb_ctp_ft5406_reset_stats();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_MANUAL_TIMEOUT,
+                      mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    mtb_ctp_ft5406_get_stats(&stats);
+    TEST_ASSERT_EQUAL(stats.retries + 1U, stats.timeouts);
+    teardown_dma();
+}
+
+
+/*******************************************************************************
+* Function Name: test_dma_error
+********************************************************************************
+*
+* A DataWire channel error fails the touch read: a blocking read is retried,
+* and an event mode read keeps the latest frame until the next INT assertion.
+*
+*******************************************************************************/
+static void test_dma_error(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_stats_t stats;
+    mtb_ctp_ft5406_view_t view;
+    uint16_t touch_x = 0U;
+    uint16_t touch_y = 0U;
+    int touch_count = 0;
+
+    setup_dma(NULL);
+    ft5406_sim_set_touches(2U, two_touches);
+    ft5406_sim_inject_dma_error(1U);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    mtb_ctp_ft5406_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(300, touch_array[1].touch_x);
+    TEST_ASSERT_EQUAL(1U, stats.retries);
+    TEST_ASSERT_EQUAL(0U, stats.timeouts);
+
+    setup_dma(&ft5406_sim_int_port);
+    ft5406_sim_set_touches(3U, three_touches);
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+
+    ft5406_sim_set_touches(3U, three_touches_moved);
+    ft5406_sim_inject_dma_error(1U);
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_MASTER_MANUAL_BUS_ERR,
+                      mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT(mtb_ctp_ft5406_acquire_view(&view));
+    mtb_ctp_ft5406_view_get_position(&view, 2U, &touch_x, &touch_y);
+    mtb_ctp_ft5406_release_view(&view);
+    TEST_ASSERT_EQUAL(50U, touch_x);
+
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(51, touch_array[2].touch_x);
+
+    teardown_dma();
+}
+
+
+/*******************************************************************************
+* Function Name: test_frame_view
+********************************************************************************
+*
+* A view serves the latest complete frame from the touch buffer, and touch
+* reads completed while it is held do not change it.
+*
+*******************************************************************************/
+static void test_frame_view(void)
+{
+    static const ft5406_sim_touch_t one_touch[] =
+    {
+        { .x = 500U, .y = 100U, .id = 2U, .event = FT5406_SIM_EVENT_CONTACT }
+    };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_view_t view;
+    int touch_count = 0;
+    uint16_t touch_x = 0U;
+    uint16_t touch_y = 0U;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT(mtb_ctp_ft5406_acquire_view(&view));
+    TEST_ASSERT_EQUAL(2U, view.touch_count);
+    TEST_ASSERT_EQUAL(MTB_CTP_TOUCH_DOWN, mtb_ctp_ft5406_view_get_event(&view, 1U));
+    TEST_ASSERT_EQUAL(1U, mtb_ctp_ft5406_view_get_id(&view, 1U));
+
+    ft5406_sim_set_touches(1U, one_touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(1, touch_count);
+    mtb_ctp_ft5406_view_get_position(&view, 1U, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(300U, touch_x);
+    TEST_ASSERT_EQUAL(400U, touch_y);
+    mtb_ctp_ft5406_release_view(&view);
+
+    TEST_ASSERT(mtb_ctp_ft5406_acquire_view(&view));
+    TEST_ASSERT_EQUAL(1U, view.touch_count);
+    mtb_ctp_ft5406_view_get_position(&view, 0U, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(500U, touch_x);
+    TEST_ASSERT_EQUAL(100U, touch_y);
+    mtb_ctp_ft5406_release_view(&view);
+}
+
+
+/*******************************************************************************
+* Function Name: test_view_keeps_latest_frame
+********************************************************************************
+*
+* Touch reads started while a view is held land in a free touch buffer: the
+* latest complete frame never moves back to the frame of the view, also when
+* the read fails.
+*
+*******************************************************************************/
+static void test_view_keeps_latest_frame(void)
+{
+    static const ft5406_sim_touch_t one_touch[] =
+    {
+        { .x = 500U, .y = 100U, .id = 2U, .event = FT5406_SIM_EVENT_CONTACT }
+    };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    mtb_ctp_ft5406_view_t view;
+    int touch_count = 0;
+    uint16_t touch_x = 0U;
+    uint16_t touch_y = 0U;
+
+    setup();
+    ft5406_sim_set_touches(2U, two_touches);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT(mtb_ctp_ft5406_acquire_view(&view));
+    TEST_ASSERT_EQUAL(2U, view.touch_count);
+
+    ft5406_sim_set_touches(1U, one_touch);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2U, view.touch_count);
+
+    /* A failed read leaves the latest frame as it is */
+    ft5406_sim_inject_nak(100U);
+    TEST_ASSERT(CY_SCB_I2C_SUCCESS != mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_inject_nak(0U);
+    mtb_ctp_ft5406_release_view(&view);
+
+    TEST_ASSERT(mtb_ctp_ft5406_acquire_view(&view));
+    TEST_ASSERT_EQUAL(1U, view.touch_count);
+    mtb_ctp_ft5406_view_get_position(&view, 0U, &touch_x, &touch_y);
+    TEST_ASSERT_EQUAL(500U, touch_x);
+    TEST_ASSERT_EQUAL(100U, touch_y);
+    mtb_ctp_ft5406_release_view(&view);
+}
+
+
+/*******************************************************************************
+* Function Name: test_trace_stages
+********************************************************************************
+*
+* The latency trace records each stage of a touch read on INT once, and the
+* pickup by the first touch output call which serves the frame.
+*
+*******************************************************************************/
+static void test_trace_stages(void)
+{
+    static mtb_ctp_ft5406_trace_t trace;
+    mtb_ctp_ft5406_trace_summary_t summary[MTB_CTP_FT5406_TRACE_STAGE_COUNT];
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+    uint32_t stage;
+
+    ft5406_sim_reset();
+    mtb_ctp_ft5406_trace_init(&trace);
+    ft5406_config.trace    = &trace;
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    ft5406_config.int_pin  = 0U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+    ft5406_sim_set_touches(2U, two_touches);
+
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    for (stage = 0U; stage < (uint32_t)MTB_CTP_FT5406_TRACE_STAGE_COUNT; stage++)
+    {
+        TEST_ASSERT_EQUAL(1U, summary[stage].count);
+    }
+    /* The frame is picked up 5 ms after the INT assertion */
+    TEST_ASSERT(5000U <= summary[MTB_CTP_FT5406_TRACE_TOTAL].max_us);
+
+    ft5406_config.trace    = NULL;
+    ft5406_config.int_port = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_trace_pickup
+********************************************************************************
+*
+* The latency trace records the pickup of frames consumed through the read
+* callback, mtb_ctp_ft5406_pop_frame(), and the touch outputs, once per
+* frame. Polls of a frame already picked up skip the trace critical section.
+*
+*******************************************************************************/
+static volatile bool trace_read_done;
+
+static void trace_read_cb(cy_en_scb_i2c_status_t status, int touch_count,
+                          const mtb_ctp_multi_touch_point_t* touch_array, void* user_data)
+{
+    (void)status;
+    (void)touch_count;
+    (void)touch_array;
+    (void)user_data;
+
+    trace_read_done = true;
+}
+
+
+static void test_trace_pickup(void)
+{
+    static mtb_ctp_ft5406_trace_t trace;
+    static mtb_ctp_ft5406_frame_ring_t ring;
+    mtb_ctp_ft5406_trace_summary_t summary[MTB_CTP_FT5406_TRACE_STAGE_COUNT];
+    mtb_ctp_ft5406_frame_t frame;
+    mtb_ctp_touch_event_t touch_event;
+    uint32_t critical_sections;
+    uint32_t first_poll;
+    int touch_x = 0;
+    int touch_y = 0;
+
+    ft5406_sim_reset();
+    mtb_ctp_ft5406_trace_init(&trace);
+    mtb_ctp_ft5406_frame_ring_init(&ring, MTB_CTP_FT5406_RING_DROP_OLDEST);
+    ft5406_config.trace      = &trace;
+    ft5406_config.frame_ring = &ring;
+    ft5406_config.int_port   = &ft5406_sim_int_port;
+    ft5406_config.int_pin    = 0U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+    ft5406_sim_set_touches(2U, two_touches);
+
+    /* Picked up by the read callback */
+    trace_read_done = false;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_read_async(trace_read_cb, NULL));
+    while (!trace_read_done)
+    {
+        ft5406_sim_run(10U);
+    }
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    TEST_ASSERT_EQUAL(1U, summary[MTB_CTP_FT5406_TRACE_DECODE].count);
+    TEST_ASSERT_EQUAL(1U, summary[MTB_CTP_FT5406_TRACE_PICKUP].count);
+
+    /* Read on INT without a consumer until the frame ring is popped */
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    TEST_ASSERT_EQUAL(2U, summary[MTB_CTP_FT5406_TRACE_DECODE].count);
+    TEST_ASSERT_EQUAL(1U, summary[MTB_CTP_FT5406_TRACE_PICKUP].count);
+
+    /* The first frame keeps its pickup by the callback */
+    TEST_ASSERT(mtb_ctp_ft5406_pop_frame(&frame));
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    TEST_ASSERT_EQUAL(1U, summary[MTB_CTP_FT5406_TRACE_PICKUP].count);
+
+    TEST_ASSERT(mtb_ctp_ft5406_pop_frame(&frame));
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    TEST_ASSERT_EQUAL(2U, summary[MTB_CTP_FT5406_TRACE_PICKUP].count);
+    TEST_ASSERT_EQUAL(2U, summary[MTB_CTP_FT5406_TRACE_TOTAL].count);
+    TEST_ASSERT(5000U <= summary[MTB_CTP_FT5406_TRACE_TOTAL].max_us);
+
+    /* Polls after the pickup of a frame take no critical section for the trace */
+    ft5406_sim_assert_int();
+    ft5406_sim_run(5000U);
+    critical_sections = ft5406_sim_get_critical_sections();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_single_touch(&touch_event, &touch_x, &touch_y));
+    first_poll = ft5406_sim_get_critical_sections() - critical_sections;
+    critical_sections = ft5406_sim_get_critical_sections();
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_single_touch(&touch_event, &touch_x, &touch_y));
+    TEST_ASSERT_EQUAL(first_poll - 1U, ft5406_sim_get_critical_sections() - critical_sections);
+    mtb_ctp_ft5406_trace_get_summary(&trace, summary);
+    TEST_ASSERT_EQUAL(3U, summary[MTB_CTP_FT5406_TRACE_PICKUP].count);
+
+    ft5406_config.trace      = NULL;
+    ft5406_config.frame_ring = NULL;
+    ft5406_config.int_port   = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_frame_ring_overflow
+********************************************************************************
+*
+* A full ring drops the new frames or overwrites the oldest unread frames
+* according to its policy and counts them as overflows, without locks or
+* critical sections.
+*
+*******************************************************************************/
+static void ring_push_frames(mtb_ctp_ft5406_frame_ring_t* ring, uint32_t first, uint32_t count,
+                             uint32_t* stored)
+{
+    mtb_ctp_ft5406_frame_t frame;
+    uint32_t i;
+
+    (void)memset(&frame, 0, sizeof(frame));
+    *stored = 0U;
+
+    for (i = first; i < (first + count); i++)
+    {
+        frame.timestamp = i;
+        if (mtb_ctp_ft5406_frame_ring_push(ring, &frame))
+        {
+            (*stored)++;
+        }
+    }
+}
+
+
+static void test_frame_ring_overflow(void)
+{
+    static mtb_ctp_ft5406_frame_ring_t ring;
+    mtb_ctp_ft5406_frame_t frame;
+    uint32_t stored = 0U;
+    uint32_t i;
+
+    ft5406_sim_reset();
+
+    mtb_ctp_ft5406_frame_ring_init(&ring, MTB_CTP_FT5406_RING_DROP_NEWEST);
+    ring_push_frames(&ring, 0U, MTB_CTP_FT5406_FRAME_RING_SIZE + 3U, &stored);
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_FRAME_RING_SIZE, stored);
+    TEST_ASSERT_EQUAL(3U, ring.dropped_newest);
+    TEST_ASSERT_EQUAL(0U, ring.dropped_oldest);
+    TEST_ASSERT_EQUAL(3U, mtb_ctp_ft5406_frame_ring_get_overflows(&ring));
+
+    for (i = 0U; i < MTB_CTP_FT5406_FRAME_RING_SIZE; i++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+        TEST_ASSERT_EQUAL(i, frame.timestamp);
+    }
+    TEST_ASSERT(!mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+
+    /* Room again after the pops */
+    ring_push_frames(&ring, 100U, 1U, &stored);
+    TEST_ASSERT_EQUAL(1U, stored);
+    TEST_ASSERT(mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+    TEST_ASSERT_EQUAL(100U, frame.timestamp);
+
+    mtb_ctp_ft5406_frame_ring_init(&ring, MTB_CTP_FT5406_RING_DROP_OLDEST);
+    ring_push_frames(&ring, 0U, MTB_CTP_FT5406_FRAME_RING_SIZE + 3U, &stored);
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_FRAME_RING_SIZE + 3U, stored);
+
+    /* The overwritten frames are counted by the consumer */
+    TEST_ASSERT_EQUAL(0U, mtb_ctp_ft5406_frame_ring_get_overflows(&ring));
+    for (i = 3U; i < (MTB_CTP_FT5406_FRAME_RING_SIZE + 3U); i++)
+    {
+        TEST_ASSERT(mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+        TEST_ASSERT_EQUAL(i, frame.timestamp);
+    }
+    TEST_ASSERT(!mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+    TEST_ASSERT_EQUAL(0U, ring.dropped_newest);
+    TEST_ASSERT_EQUAL(3U, ring.dropped_oldest);
+    TEST_ASSERT_EQUAL(3U, mtb_ctp_ft5406_frame_ring_get_overflows(&ring));
+
+    TEST_ASSERT_EQUAL(0U, ft5406_sim_get_critical_sections());
+}
+
+
+/*******************************************************************************
+* Function Name: test_frame_ring_torn_slot
+********************************************************************************
+*
+* With MTB_CTP_FT5406_RING_DROP_OLDEST, a slot the producer is writing or has
+* overwritten while the consumer copies it is skipped and counted as an
+* overflow, and the pop retries with the next frame. A producer thread racing
+* a consumer never hands out a mixed frame.
+*
+*******************************************************************************/
+#define RING_RACE_FRAMES                   (200000U)
+
+static mtb_ctp_ft5406_frame_ring_t race_ring;
+
+static void* ring_producer_thread(void* arg)
+{
+    mtb_ctp_ft5406_frame_t frame;
+    uint32_t i;
+    uint32_t j;
+
+    (void)arg;
+
+    for (i = 1U; i <= RING_RACE_FRAMES; i++)
+    {
+        frame.timestamp   = i;
+        frame.touch_count = (uint8_t)i;
+        for (j = 0U; j < MTB_CTP_FT5406_MAX_TOUCHES; j++)
+        {
+            frame.touch_points[j].touch_x = (uint16_t)i;
+            frame.touch_points[j].touch_y = (uint16_t)i;
+        }
+        frame.trace_frame = i;
+
+        (void)mtb_ctp_ft5406_frame_ring_push(&race_ring, &frame);
+    }
+
+    return NULL;
+}
+
+
+static void test_frame_ring_torn_slot(void)
+{
+    static mtb_ctp_ft5406_frame_ring_t ring;
+    mtb_ctp_ft5406_frame_t frame;
+    pthread_t producer;
+    uint32_t head;
+    uint32_t popped = 0U;
+    uint32_t last = 0U;
+    uint32_t stored = 0U;
+    bool consistent = true;
+    bool done = false;
+    uint32_t j;
+
+    /* The slot of the oldest frame is being written by the producer */
+    mtb_ctp_ft5406_frame_ring_init(&ring, MTB_CTP_FT5406_RING_DROP_OLDEST);
+    ring_push_frames(&ring, 0U, 3U, &stored);
+    ring.slots[0].sequence = 0U;
+    TEST_ASSERT(mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+    TEST_ASSERT_EQUAL(1U, frame.timestamp);
+    TEST_ASSERT_EQUAL(1U, ring.dropped_oldest);
+
+    /* The slot of the oldest frame was overwritten by the next lap */
+    ring.slots[2].sequence = 3U + MTB_CTP_FT5406_FRAME_RING_SIZE;
+    TEST_ASSERT(!mtb_ctp_ft5406_frame_ring_pop(&ring, &frame));
+    TEST_ASSERT_EQUAL(2U, ring.dropped_oldest);
+
+    /* Producer and consumer threads */
+    mtb_ctp_ft5406_frame_ring_init(&race_ring, MTB_CTP_FT5406_RING_DROP_OLDEST);
+    TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, ring_producer_thread, NULL));
+
+    while (!done)
+    {
+        /* The ring is drained if it is empty after the last push */
+        head = race_ring.head;
+        if (!mtb_ctp_ft5406_frame_ring_pop(&race_ring, &frame))
+        {
+            done = (RING_RACE_FRAMES == head);
+            continue;
+        }
+
+        popped++;
+        consistent = consistent && (last < frame.timestamp) &&
+                     ((uint8_t)frame.timestamp == frame.touch_count) &&
+                     (frame.timestamp == frame.trace_frame);
+        for (j = 0U; j < MTB_CTP_FT5406_MAX_TOUCHES; j++)
+        {
+            consistent = consistent &&
+                         ((uint16_t)frame.timestamp == frame.touch_points[j].touch_x) &&
+                         ((uint16_t)frame.timestamp == frame.touch_points[j].touch_y);
+        }
+        last = frame.timestamp;
+    }
+    (void)pthread_join(producer, NULL);
+
+    TEST_ASSERT(consistent);
+    TEST_ASSERT_EQUAL(RING_RACE_FRAMES, last);
+    TEST_ASSERT_EQUAL(RING_RACE_FRAMES, popped + mtb_ctp_ft5406_frame_ring_get_overflows(&race_ring));
+}
+
+
+/*******************************************************************************
+* Function Name: test_shared_bus_touch_first
+********************************************************************************
+*
+* A blocking touch read waiting for the shared bus lock gets the bus before
+* the transfer of another device which waited for it first.
+*
+*******************************************************************************/
+#define SHARED_BUS_WAIT_US                 (1000000000U)
+
+static mtb_ctp_ft5406_shared_bus_t shared_bus;
+static volatile uint32_t shared_bus_grants;
+static char shared_bus_log[MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 2U];
+
+static void wait_shared_bus_waiters(uint8_t priority_waiting, uint8_t other_waiting)
+{
+    uint32_t interrupt_state;
+    bool waiting = false;
+
+    while (!waiting)
+    {
+        (void)sched_yield();
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        waiting = (priority_waiting == shared_bus.priority_waiting) &&
+                  (other_waiting == shared_bus.other_waiting);
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+}
+
+
+/* Transfer of another device, logged as 'B' for bulk traffic */
+static void* bulk_device_thread(void* arg)
+{
+    ft5406_sim_stats_t* stats = (ft5406_sim_stats_t*)arg;
+
+    if (mtb_ctp_ft5406_shared_bus_lock(&shared_bus, false, SHARED_BUS_WAIT_US))
+    {
+        shared_bus_log[shared_bus_grants++] = 'B';
+        if (NULL != stats)
+        {
+            ft5406_sim_get_stats(stats);
+        }
+        mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+    }
+
+    return NULL;
+}
+
+
+static void* touch_read_thread(void* arg)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+
+    *(cy_en_scb_i2c_status_t*)arg = mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array);
+
+    return NULL;
+}
+
+
+static void test_shared_bus_touch_first(void)
+{
+    static const mtb_ctp_ft5406_retry_t retry = { .timeout_us = SHARED_BUS_WAIT_US };
+    cy_en_scb_i2c_status_t touch_status = CY_SCB_I2C_MASTER_NOT_READY;
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t bulk;
+    pthread_t bulk_device;
+    pthread_t touch_reader;
+
+    setup();
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_init(&shared_bus));
+    ft5406_config.bus_lock = &shared_bus.hooks;
+    ft5406_config.retry    = &retry;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_touches(2U, two_touches);
+    shared_bus_grants = 0U;
+
+    /* Another device holds the bus while both requests queue up */
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_lock(&shared_bus, false, 0U));
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(0, pthread_create(&bulk_device, NULL, bulk_device_thread, &bulk));
+    wait_shared_bus_waiters(0U, 1U);
+    TEST_ASSERT_EQUAL(0, pthread_create(&touch_reader, NULL, touch_read_thread, &touch_status));
+    wait_shared_bus_waiters(1U, 1U);
+    mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+
+    (void)pthread_join(touch_reader, NULL);
+    (void)pthread_join(bulk_device, NULL);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, touch_status);
+    TEST_ASSERT_EQUAL(1U, shared_bus_grants);
+    /* The touch read was complete when the other device got the bus */
+    TEST_ASSERT_EQUAL(2U, bulk.transactions - before.transactions);
+
+    ft5406_config.bus_lock = NULL;
+    ft5406_config.retry    = NULL;
+    mtb_ctp_ft5406_shared_bus_free(&shared_bus);
+}
+
+
+/*******************************************************************************
+* Function Name: test_shared_bus_priority_burst
+********************************************************************************
+*
+* Priority requests go first only MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST times
+* in a row while another request waits, then that request gets the bus.
+*
+*******************************************************************************/
+/* Priority transfer, logged as 'P' */
+static void* priority_device_thread(void* arg)
+{
+    (void)arg;
+
+    if (mtb_ctp_ft5406_shared_bus_lock(&shared_bus, true, SHARED_BUS_WAIT_US))
+    {
+        shared_bus_log[shared_bus_grants++] = 'P';
+        mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+    }
+
+    return NULL;
+}
+
+
+static void test_shared_bus_priority_burst(void)
+{
+    pthread_t threads[MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 2U];
+    uint32_t i;
+
+    ft5406_sim_reset();
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_init(&shared_bus));
+    shared_bus_grants = 0U;
+    (void)memset(shared_bus_log, 0, sizeof(shared_bus_log));
+
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_lock(&shared_bus, false, 0U));
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[0], NULL, bulk_device_thread, NULL));
+    wait_shared_bus_waiters(0U, 1U);
+    for (i = 1U; i < (MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 2U); i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, priority_device_thread, NULL));
+    }
+    wait_shared_bus_waiters((uint8_t)(MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 1U), 1U);
+    mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+
+    for (i = 0U; i < (MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 2U); i++)
+    {
+        (void)pthread_join(threads[i], NULL);
+    }
+    TEST_ASSERT_EQUAL(MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 2U, shared_bus_grants);
+    for (i = 0U; i < MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST; i++)
+    {
+        TEST_ASSERT_EQUAL('P', shared_bus_log[i]);
+    }
+    TEST_ASSERT_EQUAL('B', shared_bus_log[MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST]);
+    TEST_ASSERT_EQUAL('P', shared_bus_log[MTB_CTP_FT5406_BUS_LOCK_PRIORITY_BURST + 1U]);
+
+    mtb_ctp_ft5406_shared_bus_free(&shared_bus);
+}
+
+
+/*******************************************************************************
+* Function Name: test_bus_released_restarts_read
+********************************************************************************
+*
+* A touch read requested by the INT pin while another device holds the shared
+* bus is started when that device unlocks the bus, not by the next touch
+* output call.
+*
+*******************************************************************************/
+static void setup_shared_bus(void)
+{
+    ft5406_sim_reset();
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    ft5406_config.int_pin  = 0U;
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_init(&shared_bus));
+    mtb_ctp_ft5406_shared_bus_attach(&shared_bus, &ft5406_config);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+}
+
+
+static void teardown_shared_bus(void)
+{
+    ft5406_config.int_port = NULL;
+    ft5406_config.bus_lock = NULL;
+    mtb_ctp_ft5406_shared_bus_free(&shared_bus);
+}
+
+
+static void test_bus_released_restarts_read(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    ft5406_sim_stats_t before;
+    ft5406_sim_stats_t after;
+    int touch_count = 0;
+
+    setup_shared_bus();
+    ft5406_sim_set_touches(2U, two_touches);
+
+    TEST_ASSERT(mtb_ctp_ft5406_shared_bus_lock(&shared_bus, false, 0U));
+    ft5406_sim_assert_int();
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+    mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+    TEST_ASSERT(mtb_ctp_ft5406_is_busy());
+    ft5406_sim_run(5000U);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+
+    ft5406_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    ft5406_sim_get_stats(&after);
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT_EQUAL(before.transactions, after.transactions);
+
+    teardown_shared_bus();
+}
+
+
+/*******************************************************************************
+* Function Name: test_bus_lock_contention
+********************************************************************************
+*
+* With another device taking the shared bus from a second thread, every INT
+* assertion is served by a touch read without a touch output call.
+*
+*******************************************************************************/
+#define CONTENTION_FRAMES                  (200U)
+#define CONTENTION_WAIT_STEPS              (10000U)
+
+static volatile bool contention_done;
+
+static void* other_device_thread(void* arg)
+{
+    (void)arg;
+
+    while (!contention_done)
+    {
+        if (mtb_ctp_ft5406_shared_bus_lock(&shared_bus, false, 1000U))
+        {
+            /* Transfer of the other device */
+            (void)sched_yield();
+            mtb_ctp_ft5406_shared_bus_unlock(&shared_bus);
+        }
+        (void)sched_yield();
+    }
+
+    return NULL;
+}
+
+
+static uint16_t latest_touch_x(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    uint16_t touch_x = (uint16_t)ft5406_config.touch_array[0].touch_x;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return touch_x;
+}
+
+
+static void test_bus_lock_contention(void)
+{
+    ft5406_sim_touch_t touch = { .x = 0U, .y = 100U, .id = 0U, .event = FT5406_SIM_EVENT_CONTACT };
+    pthread_t other_device;
+    uint32_t served = 0U;
+    uint32_t frame;
+    uint32_t step;
+
+    setup_shared_bus();
+    contention_done = false;
+    TEST_ASSERT_EQUAL(0, pthread_create(&other_device, NULL, other_device_thread, NULL));
+
+    for (frame = 1U; frame <= CONTENTION_FRAMES; frame++)
+    {
+        touch.x = (uint16_t)frame;
+        ft5406_sim_set_touches(1U, &touch);
+        ft5406_sim_assert_int();
+
+        for (step = 0U; (step < CONTENTION_WAIT_STEPS) && (frame != latest_touch_x()); step++)
+        {
+            ft5406_sim_run(100U);
+            (void)sched_yield();
+        }
+        if (frame == latest_touch_x())
+        {
+            served++;
+        }
+    }
+
+    contention_done = true;
+    (void)pthread_join(other_device, NULL);
+    TEST_ASSERT_EQUAL(CONTENTION_FRAMES, served);
+
+    teardown_shared_bus();
+}
+
+
+/*******************************************************************************
+* Function Name: test_timeout_unlocks_bus
+********************************************************************************
+*
+* A touch read aborted after a timeout releases the shared bus lock with
+* interrupts enabled, as the release may wake a waiting RTOS thread.
+*
+*******************************************************************************/
+static uint32_t unlocks;
+static uint32_t unlocks_masked;
+
+static bool counting_lock(void* context, bool priority, uint32_t timeout_us)
+{
+    (void)context;
+    (void)priority;
+    (void)timeout_us;
+
+    return true;
+}
+
+
+static void counting_unlock(void* context)
+{
+    (void)context;
+
+    unlocks++;
+    if (ft5406_sim_in_critical_section())
+    {
+        unlocks_masked++;
+    }
+}
+
+
+static void test_timeout_unlocks_bus(void)
+{
+    static const mtb_ctp_ft5406_bus_lock_t counting_bus_lock =
+    {
+        .lock = counting_lock, .unlock = counting_unlock, .context = NULL
+    };
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    int touch_count = 0;
+
+    setup();
+    ft5406_config.bus_lock = &counting_bus_lock;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_touches(2U, two_touches);
+    unlocks        = 0U;
+    unlocks_masked = 0U;
+
+    /* The first attempt is aborted, the second one completes */
+    ft5406_sim_inject_timeout(1U);
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+    TEST_ASSERT(2U <= unlocks);
+    TEST_ASSERT_EQUAL(0U, unlocks_masked);
+
+    ft5406_config.bus_lock = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_async_read_races_int
+********************************************************************************
+*
+* Touch reads started by a thread while INT assertions start reads from the
+* interrupt context never take over the transfer in progress: every completed
+* read reports the whole frame and no read is left in progress.
+*
+*******************************************************************************/
+#define RACE_READS                         (2000U)
+
+static volatile bool race_done;
+static volatile uint32_t race_completed;
+static volatile uint32_t race_torn;
+
+static void race_read_cb(cy_en_scb_i2c_status_t status, int touch_count,
+                         const mtb_ctp_multi_touch_point_t* touch_array, void* user_data)
+{
+    (void)user_data;
+
+    if ((CY_SCB_I2C_SUCCESS != status) || (2 != touch_count) ||
+        (300 != touch_array[1].touch_x))
+    {
+        race_torn++;
+    }
+    race_completed++;
+}
+
+
+static void* race_reader_thread(void* arg)
+{
+    uint32_t reads = 0U;
+
+    (void)arg;
+
+    while (reads < RACE_READS)
+    {
+        if (CY_SCB_I2C_SUCCESS == mtb_ctp_ft5406_read_async(race_read_cb, NULL))
+        {
+            reads++;
+        }
+        ft5406_sim_run(10U);
+    }
+    race_done = true;
+
+    return NULL;
+}
+
+
+static void test_async_read_races_int(void)
+{
+    mtb_ctp_multi_touch_point_t touch_array[MTB_CTP_FT5406_MAX_TOUCHES];
+    pthread_t reader;
+    int touch_count = 0;
+
+    ft5406_sim_reset();
+    ft5406_config.int_port = &ft5406_sim_int_port;
+    ft5406_config.int_pin  = 0U;
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_init(&ft5406_config));
+    ft5406_sim_set_int_isr(mtb_ctp_ft5406_int_handler);
+    ft5406_sim_set_touches(2U, two_touches);
+
+    race_done      = false;
+    race_completed = 0U;
+    race_torn      = 0U;
+    TEST_ASSERT_EQUAL(0, pthread_create(&reader, NULL, race_reader_thread, NULL));
+
+    /* The INT pulses leave the bus idle in between, for the thread to start reads */
+    while (!race_done)
+    {
+        ft5406_sim_assert_int();
+        ft5406_sim_run(2000U);
+        (void)sched_yield();
+    }
+    (void)pthread_join(reader, NULL);
+    ft5406_sim_run(5000U);
+
+    TEST_ASSERT_EQUAL(RACE_READS, race_completed);
+    TEST_ASSERT_EQUAL(0U, race_torn);
+    TEST_ASSERT(!mtb_ctp_ft5406_is_busy());
+    TEST_ASSERT_EQUAL(CY_SCB_I2C_SUCCESS, mtb_ctp_ft5406_get_multi_touch(&touch_count, touch_array));
+    TEST_ASSERT_EQUAL(2, touch_count);
+
+    ft5406_config.int_port = NULL;
+}
+
+
+int main(void)
+{
+    RUN_TEST(test_read_multi_touch);
+    RUN_TEST(test_nak_is_retried);
+    RUN_TEST(test_timeout_is_retried);
+    RUN_TEST(test_retry_timeout_limit);
+    RUN_TEST(test_persistent_nak_fails);
+    RUN_TEST(test_event_mode);
+    RUN_TEST(test_bus_released_restarts_read);
+    RUN_TEST(test_bus_lock_contention);
+    RUN_TEST(test_timeout_unlocks_bus);
+    RUN_TEST(test_async_read_races_int);
+    RUN_TEST(test_shared_bus_touch_first);
+    RUN_TEST(test_shared_bus_priority_burst);
+    RUN_TEST(test_scheduler_retry);
+    RUN_TEST(test_register_shadow);
+    RUN_TEST(test_failed_register_write);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_zero_panel_size_transform);
+    RUN_TEST(test_transform_rotation_scaling);
+    RUN_TEST(test_transform_calibrate);
+    RUN_TEST(test_filter_jitter);
+    RUN_TEST(test_filter_weight_limit);
+    RUN_TEST(test_replay_filter_state);
+    RUN_TEST(test_capture_replay);
+    RUN_TEST(test_replay_corrupt_stream);
+    RUN_TEST(test_chained_event_callback);
+    RUN_TEST(test_deinit_releases_bus);
+    RUN_TEST(test_two_instances_event_mode);
+    RUN_TEST(test_max_instances);
+    RUN_TEST(test_tracker_id_reuse);
+    RUN_TEST(test_tracker_velocity);
+    RUN_TEST(test_gesture_tap);
+    RUN_TEST(test_gesture_swipe);
+    RUN_TEST(test_gesture_pinch_rotate);
+    RUN_TEST(test_gesture_pinch_full_range);
+    RUN_TEST(test_gesture_queue_overflow);
+    RUN_TEST(test_adaptive_reread);
+    RUN_TEST(test_dma_touch_read);
+    RUN_TEST(test_dma_error);
+    RUN_TEST(test_frame_view);
+    RUN_TEST(test_view_keeps_latest_frame);
+    RUN_TEST(test_trace_stages);
+    RUN_TEST(test_trace_pickup);
+    RUN_TEST(test_frame_ring_overflow);
+    RUN_TEST(test_frame_ring_torn_slot);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/*******************************************************************************
+* \file test_utils.h
+*
+* \brief
+* Provides the assertion and test runner macros of the host tests.
+*
+********************************************************************************
+* \copyright
+* Copyright 2025 Cypress Semiconductor Corporation (an Infineon company)
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdio.h>
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Records a failure and continues with the test */
+#define TEST_ASSERT(COND) \
+    do \
+    { \
+        if (!(COND)) \
+        { \
+            (void)printf("%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #COND); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL(EXPECTED, ACTUAL) \
+    do \
+    { \
+        long long test_expected = (long long)(EXPECTED); \
+        long long test_actual   = (long long)(ACTUAL); \
+        if (test_expected != test_actual) \
+        { \
+            (void)printf("%s:%d: %s: expected %lld, got %lld\n", __FILE__, __LINE__, \
+                         #ACTUAL, test_expected, test_actual); \
+            test_failures++; \
+        } \
+    } while (0)
+
+/* Runs a test function and reports it */
+#define RUN_TEST(FUNC) \
+    do \
+    { \
+        unsigned int test_failures_before = test_failures; \
+        FUNC(); \
+        (void)printf("%s %s\n", (test_failures_before == test_failures) ? "PASS" : "FAIL", \
+                     #FUNC); \
+    } while (0)
+
+/* Exit status of the test program */
+#define TEST_RESULT()       ((0U == test_failures) ? 0 : 1)
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Number of failed assertions, defined by each test program */
+extern unsigned int test_failures;
+
+
+#endif /* TEST_UTILS_H */
+
+
+/* [] END OF FILE */